@@ -25,6 +25,7 @@
 #include "AppDelegate.h"
 #include "HelloWorldScene.h"
 #include "TestScene.h"
+#include "configs/loaders/LayoutTemplateRegistry.h"
 
 // #define USE_AUDIO_ENGINE 1
 // #define USE_SIMPLE_AUDIO_ENGINE 1
@@ -64,7 +65,7 @@ void AppDelegate::initGLContextAttrs()
 {
     // set OpenGL context attributes: red,green,blue,alpha,depth,stencil,multisamplesCount
     GLContextAttrs glContextAttrs = {8, 8, 8, 8, 24, 8, 0};
-
+    
     GLView::setGLContextAttrs(glContextAttrs);
 }
 
@@ -87,24 +88,27 @@ bool AppDelegate::applicationDidFinishLaunching() {
 #endif
         director->setOpenGLView(glview);
     }
-
+    
     // turn on display FPS
     director->setDisplayStats(true);
-
+    
     // set FPS. the default value is 1.0/60 if you don't call this
     director->setAnimationInterval(1.0f / 60);
-
+    
     // Set the design resolution
     glview->setDesignResolutionSize(1080, 2080, ResolutionPolicy::FIXED_WIDTH);
-
+    
     register_all_packages();
-
+    
+    // 布局模板经 FileUtils 读取，在主线程加载，后台解析关卡时只查找
+    LayoutTemplateRegistry::getInstance()->loadDefaultTemplates();
+    
     // create a scene. it's an autorelease object
     auto scene = TestScene::createScene();
-
+    
     // run
     director->runWithScene(scene);
-
+    
     return true;
 }
 
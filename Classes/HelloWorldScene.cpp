@@ -73,8 +73,8 @@ bool HelloWorld::init()
         return false;
     }
 
-    // 开始游戏
-    _gameController->startGame("1");
+    // 开始游戏（后台加载，不阻塞场景切换）
+    _gameController->startGameAsync("1");
 
     return true;
 }
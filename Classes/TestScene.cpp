@@ -23,19 +23,35 @@
  ****************************************************************************/
 
 #include "TestScene.h"
-#include "configs/loaders/LevelConfigLoader.h"
+#include "services/GameModelAsyncLoader.h"
 #include "services/GameModelFromLevelGenerator.h"
-#include "utils/CardUtils.h"
+#include "configs/loaders/LevelConfigLoader.h"
+#include "managers/LevelConfigCache.h"
 #include "cocos2d.h"
+#include <map>
 
 USING_NS_CC;
 
+namespace {
+
+const float HINT_IDLE_DELAY = 5.0f;     ///< 玩家停顿多久后显示提示（秒）
+const float HINT_POLL_INTERVAL = 0.1f;  ///< 取回后台提示的间隔（秒）
+
+} // namespace
+
 TestScene::~TestScene()
 {
-    if (_stateManager) {
-        delete _stateManager;
-        _stateManager = nullptr;
+    if (_session) {
+        delete _session;
+        _session = nullptr;
     }
+    
+    delete _levelWatcher;
+    _levelWatcher = nullptr;
+    
+    // 析构时等待后台提示线程退出
+    delete _hintService;
+    _hintService = nullptr;
 }
 
 Scene* TestScene::createScene()
@@ -49,46 +65,50 @@ bool TestScene::init()
         return false;
     }
     
-    // 初始化状态管理器
-    _stateManager = new GameStateManager();
-    
-    // 初始化游戏模型
-    if (!initGameModel()) {
-        return false;
-    }
+    // 初始化对局会话
+    _session = new GameSession();
+    _gameModel = nullptr;
+    _levelId = "1";
+    _levelWatcher = nullptr;
+    _hintService = new HintService();
+    _hintShown = false;
+    _idleSeconds = 0.0f;
     
-    // 初始化游戏视图
+    // 初始化游戏视图（模型加载完成前显示加载状态）
     if (!initGameView()) {
         return false;
     }
     
-    // 保存初始状态
-    _stateManager->saveState(_gameModel, "init", -1, -1);
-    
+    // 在后台加载游戏模型
+    loadGameModelAsync();
+    startHintPolling();
+
+#if COCOS2D_DEBUG > 0
+    startLevelHotReload();
+#endif
+
     return true;
 }
 
-bool TestScene::initGameModel()
+void TestScene::loadGameModelAsync()
 {
-    // 加载关卡配置
-    LevelConfigLoader loader;
-    LevelConfig* levelConfig = loader.loadLevelConfig("1");
-    if (!levelConfig) {
-        cocos2d::log("Failed to load level config");
-        return false;
-    }
-    
-    // 生成游戏模型
-    GameModelFromLevelGenerator generator;
-    _gameModel = generator.generateGameModel(levelConfig);
-    if (!_gameModel) {
-        cocos2d::log("Failed to generate game model");
-        delete levelConfig;
-        return false;
-    }
+    _gameView->setLoading(true);
     
-    delete levelConfig;
-    return true;
+    // 加载期间保持场景存活，回调中释放
+    retain();
+    GameModelAsyncLoader::loadGameModel(_levelId, [this](GameModel* gameModel) {
+        // 开始会话并保存初始状态，无法记录撤销历史的对局不显示
+        if (gameModel && _session->start(gameModel)) {
+            _gameModel = gameModel;
+            _gameView->updateGame(_gameModel);
+            updateHint(nullptr);
+        } else {
+            cocos2d::log("Failed to load game model");
+            delete gameModel;
+        }
+        _gameView->setLoading(false);
+        release();
+    });
 }
 
 bool TestScene::initGameView()
@@ -121,6 +141,11 @@ void TestScene::onCardClicked(int cardId)
 {
     cocos2d::log("Card clicked: %d", cardId);
     
+    // 任何点击都取消正在显示的提示并重新计时
+    _gameView->clearHint();
+    _hintShown = false;
+    _idleSeconds = 0.0f;
+    
     // 调试：检查卡牌在哪个牌堆中
     CardModel* mainCard = _gameModel->findMainPileCard(cardId);
     CardModel* bottomCard = _gameModel->findBottomPileCard(cardId);
@@ -137,34 +162,18 @@ void TestScene::onCardClicked(int cardId)
     if (mainPileCard) {
         // 主牌和底牌匹配：主牌替换底牌
         CardModel* bottomCard = _gameModel->getBottomPileTopCard();
-        if (bottomCard && CardUtils::canMatchWithBottomPile(mainPileCard, bottomCard)) {
+        if (_session->canClick(cardId)) {
             cocos2d::log("Main pile card %d can match with bottom pile card %d", cardId, bottomCard->getCardId());
             
             // 播放匹配动画
-            // 在动画开始前保存底部卡牌ID
-            int bottomCardId = bottomCard->getCardId();
+            GameMove move = { GMT_MAIN_TO_BOTTOM, cardId, mainPileCard->getFace() };
             
-            _gameView->playMatchAnimation(cardId, bottomCard->getPosition(), 0.5f, [this, cardId, mainPileCard, bottomCard, bottomCardId]() {
-                // 动画完成后更新模型
-                // 先保存底部卡牌的位置
-                cocos2d::Vec2 bottomCardPos = bottomCard->getPosition();
-                
-                // 移除主牌堆的卡牌
-                _gameModel->removeMainPileCard(cardId);
-                
-                // 替换底牌堆的顶部卡牌
-                auto& bottomPileCards = _gameModel->getBottomPileCards();
-                int topIndex = _gameModel->getBottomPileTopIndex();
-                if (topIndex >= 0 && topIndex < bottomPileCards.size()) {
-                    // 删除原来的顶部卡牌
-                    delete bottomPileCards[topIndex];
-                    // 设置新的顶部卡牌
-                    bottomPileCards[topIndex] = mainPileCard;
-                    mainPileCard->setPosition(bottomCardPos);
+            _gameView->playMatchAnimation(cardId, bottomCard->getPosition(), 0.5f, [this, cardId, move]() {
+                // 动画完成后更新模型并保存状态；动画期间对局已变化时不再执行
+                if (!_session->handleCardClick(cardId)) {
+                    return;
                 }
-                
-                // 在操作完成后保存状态
-                _stateManager->saveState(_gameModel, "main_to_bottom", cardId, bottomCardId);
+                updateHint(&move);
                 
                 _gameView->updateDisplay();
             });
@@ -191,64 +200,17 @@ void TestScene::onCardClicked(int cardId)
         if (bottomCard) {
             cocos2d::log("Reserve pile card %d swap with bottom pile card %d", cardId, bottomCard->getCardId());
             
-            // 在动画开始前保存底部卡牌ID
-            int bottomCardId = bottomCard->getCardId();
+            GameMove move = { GMT_RESERVE_TO_BOTTOM, cardId, reservePileCard->getFace() };
             
             // 播放交换动画
-            _gameView->playMatchAnimation(cardId, bottomCard->getPosition(), 0.5f, [this, cardId, reservePileCard, bottomCard, bottomCardId]() {
+            _gameView->playMatchAnimation(cardId, bottomCard->getPosition(), 0.5f, [this, cardId, move]() {
                 cocos2d::log("Reserve to bottom animation completed for card %d", cardId);
                 
-                // 动画完成后更新模型
-                cocos2d::Vec2 bottomCardPos = bottomCard->getPosition();
-                cocos2d::Vec2 reserveCardPos = reservePileCard->getPosition();
-                
-                cocos2d::log("Before swap - Reserve cards: %zu, Bottom cards: %zu", 
-                             _gameModel->getReservePileCards().size(), 
-                             _gameModel->getBottomPileCards().size());
-                
-                // 找到被点击的备用牌在备用牌堆中的位置
-                auto& reservePileCards = _gameModel->getReservePileCards();
-                int reserveCardIndex = -1;
-                for (size_t i = 0; i < reservePileCards.size(); ++i) {
-                    if (reservePileCards[i] && reservePileCards[i]->getCardId() == cardId) {
-                        reserveCardIndex = (int)i;
-                        break;
-                    }
+                // 动画完成后更新模型并保存状态
+                if (!_session->handleCardClick(cardId)) {
+                    return;
                 }
-                
-                if (reserveCardIndex >= 0) {
-                    // 将原来的底部卡牌替换到被点击的备用牌位置
-                    bottomCard->setPosition(reserveCardPos);
-                    bottomCard->setClickable(true); // 设置为可点击
-                    reservePileCards[reserveCardIndex] = bottomCard;
-                    cocos2d::log("Replaced reserve card at index %d with bottom card %d", reserveCardIndex, bottomCard->getCardId());
-                } else {
-                    // 如果找不到位置，添加到末尾（备用方案）
-                    bottomCard->setPosition(reserveCardPos);
-                    bottomCard->setClickable(true); // 设置为可点击
-                    _gameModel->addReservePileCard(bottomCard);
-                    cocos2d::log("Added bottom card %d to reserve pile (fallback)", bottomCard->getCardId());
-                }
-                
-                // 替换底牌堆的顶部卡牌
-                auto& bottomPileCards = _gameModel->getBottomPileCards();
-                int topIndex = _gameModel->getBottomPileTopIndex();
-                if (topIndex >= 0 && topIndex < bottomPileCards.size()) {
-                    // 设置新的顶部卡牌
-                    bottomPileCards[topIndex] = reservePileCard;
-                    reservePileCard->setPosition(bottomCardPos);
-                    reservePileCard->setClickable(false); // 设置为不可点击
-                    cocos2d::log("Set reserve card %d as new bottom card", reservePileCard->getCardId());
-                } else {
-                    cocos2d::log("Invalid bottom pile top index: %d, size: %zu", topIndex, bottomPileCards.size());
-                }
-                
-                cocos2d::log("After swap - Reserve cards: %zu, Bottom cards: %zu", 
-                             _gameModel->getReservePileCards().size(), 
-                             _gameModel->getBottomPileCards().size());
-                
-                // 在操作完成后保存状态
-                _stateManager->saveState(_gameModel, "reserve_to_bottom", cardId, bottomCardId);
+                updateHint(&move);
                 
                 _gameView->updateDisplay();
             });
@@ -272,6 +234,7 @@ void TestScene::onDrawCard()
         // 添加到底牌堆
         _gameModel->addBottomPileCard(card);
         _gameView->updateDisplay();
+        updateHint(nullptr);
         cocos2d::log("Drew card %d from reserve pile", card->getCardId());
     } else {
         cocos2d::log("No cards available in reserve pile");
@@ -281,14 +244,131 @@ void TestScene::onDrawCard()
 void TestScene::onUndo()
 {
     cocos2d::log("Undo requested");
-    if (_stateManager && _stateManager->undo(_gameModel)) {
-        _gameView->updateDisplay();
+    if (_session && _session->handleUndo()) {
+        // 增量同步视图，只让位置变化的卡牌从原位置移动到撤销后的位置
+        _gameView->syncCardViews();
+        for (const auto& delta : _session->getStateManager().getLastRestoreDeltas()) {
+            CardView* cardView = _gameView->getCardView(delta.cardId);
+            if (cardView) {
+                cardView->setPosition(delta.fromPosition);
+                _gameView->playUndoAnimation(delta.cardId, delta.toPosition);
+            }
+        }
+        updateHint(nullptr);
         cocos2d::log("Undo successful");
     } else {
         cocos2d::log("No undo actions available or undo failed");
     }
 }
 
+void TestScene::startLevelHotReload()
+{
+    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(
+        LevelConfigLoader::getLevelFileName(_levelId));
+    _levelWatcher = new LevelFileWatcher();
+    if (!_levelWatcher->watchFile(fullPath)) {
+        cocos2d::log("Level hot reload unavailable for %s", fullPath.c_str());
+        return;
+    }
+    
+    schedule([this](float) {
+        _levelWatcher->poll([this](const std::string& changedPath) {
+            reloadLevel(changedPath);
+        });
+    }, 0.25f, "levelHotReload");
+}
+
+void TestScene::reloadLevel(const std::string& fullPath)
+{
+    // 模型仍在加载时等下一次文件变化
+    if (!_gameModel) {
+        return;
+    }
+    
+    // 只重新解析发生变化的文件；保存到一半的文件解析失败时保留当前对局
+    LevelConfigCache::LevelConfigHandle levelConfig =
+        LevelConfigCache::getInstance()->reloadLevelConfig(_levelId, fullPath);
+    GameModel* gameModel = levelConfig ? GameModelFromLevelGenerator::generateGameModel(levelConfig.get()) : nullptr;
+    if (!gameModel || !GameStateManager::canSaveState(gameModel)) {
+        cocos2d::log("Hot reload: failed to parse %s, keeping current game", fullPath.c_str());
+        delete gameModel;
+        return;
+    }
+    
+    // 新模型的卡牌按相同的牌堆顺序生成，按初始状态中的位置把旧卡牌ID映射到新卡牌ID
+    std::vector<int> initialCardIds;
+    std::vector<GameStateManager::ActionRecord> actions;
+    _session->getStateManager().exportHistory(initialCardIds, actions);
+    std::vector<int> newCardIds;
+    for (const auto* cardList : { &gameModel->getMainPileCards(), &gameModel->getBottomPileCards(),
+                                  &gameModel->getReservePileCards() }) {
+        for (const auto* card : *cardList) {
+            newCardIds.push_back(card->getCardId());
+        }
+    }
+    std::map<int, int> cardIdMap;
+    for (size_t i = 0; i < initialCardIds.size() && i < newCardIds.size(); ++i) {
+        cardIdMap[initialCardIds[i]] = newCardIds[i];
+    }
+    
+    delete _gameModel;
+    _gameModel = gameModel;
+    _session->start(_gameModel);
+    
+    // 逐步重放，遇到在新布局下不再合法的操作即停止
+    size_t replayed = 0;
+    for (const auto& action : actions) {
+        auto source = cardIdMap.find(action.sourceCardId);
+        if (source == cardIdMap.end()) {
+            break;
+        }
+        int cardId = source->second;
+        // 抽牌依赖视图中的备用牌堆状态，不重放；其余操作要求卡牌仍在原来的牌堆中且合法
+        bool samePile = action.actionType == GAT_MAIN_TO_BOTTOM ? _gameModel->findMainPileCard(cardId) != nullptr
+                      : action.actionType == GAT_RESERVE_TO_BOTTOM && _gameModel->findReservePileCard(cardId) != nullptr;
+        if (!samePile || !_session->handleCardClick(cardId)) {
+            break;
+        }
+        ++replayed;
+    }
+    
+    _gameView->updateGame(_gameModel);
+    updateHint(nullptr);
+    cocos2d::log("Hot reload: %s reloaded, replayed %zu of %zu moves", fullPath.c_str(), replayed, actions.size());
+}
+
+void TestScene::updateHint(const GameMove* move)
+{
+    if (!_gameModel) {
+        return;
+    }
+    if (!move || !_hintService->applyMove(*move)) {
+        _hintService->reset(_gameModel);
+    }
+    _hintService->requestHint();
+    
+    _gameView->clearHint();
+    _hint = Hint();
+    _hintShown = false;
+    _idleSeconds = 0.0f;
+}
+
+void TestScene::startHintPolling()
+{
+    schedule([this](float dt) {
+        _idleSeconds += dt;
+        Hint hint;
+        if (_hintService->pollHint(hint)) {
+            _hint = hint;
+        }
+        if (!_hintShown && _hint.valid && _idleSeconds >= HINT_IDLE_DELAY) {
+            _gameView->showHint(_hint.move.cardId);
+            _hintShown = true;
+            cocos2d::log("Hint: card %d, %d clicks to win", _hint.move.cardId, _hint.score);
+        }
+    }, HINT_POLL_INTERVAL, "hintPoll");
+}
+
 int TestScene::findBottomPileCardIndex(int cardId)
 {
     const auto& bottomPileCards = _gameModel->getBottomPileCards();
@@ -300,7 +380,7 @@ int TestScene::findBottomPileCardIndex(int cardId)
     return -1;
 }
 
-void TestScene::recordUndoAction(int sourceCardId, int targetCardId, const std::string& actionType)
+void TestScene::recordUndoAction(int sourceCardId, int targetCardId, GameActionType actionType)
 {
     // 简单的撤销记录
     UndoAction action;
@@ -311,7 +391,7 @@ void TestScene::recordUndoAction(int sourceCardId, int targetCardId, const std::
     action.targetPosition = getCardPosition(targetCardId);
     
     _undoActions.push_back(action);
-    cocos2d::log("Recorded undo action: %s", actionType.c_str());
+    cocos2d::log("Recorded undo action: %s", GameStateManager::getActionTypeName(actionType));
 }
 
 cocos2d::Vec2 TestScene::getCardPosition(int cardId)
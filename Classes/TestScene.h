@@ -29,6 +29,9 @@
 #include "models/GameModel.h"
 #include "views/GameView.h"
 #include "managers/GameStateManager.h"
+#include "controllers/GameSession.h"
+#include "managers/LevelFileWatcher.h"
+#include "services/HintService.h"
 #include <vector>
 #include <string>
 
@@ -39,7 +42,7 @@ struct UndoAction
 {
     int sourceCardId;                    ///< 源卡牌ID
     int targetCardId;                    ///< 目标卡牌ID
-    std::string actionType;              ///< 操作类型
+    GameActionType actionType;           ///< 操作类型
     cocos2d::Vec2 sourcePosition;        ///< 源位置
     cocos2d::Vec2 targetPosition;        ///< 目标位置
 };
@@ -76,10 +79,9 @@ public:
 
 private:
     /**
-     * 初始化游戏模型
-     * @return 是否初始化成功
+     * 在后台线程加载并生成游戏模型，完成后在主线程接入视图
      */
-    bool initGameModel();
+    void loadGameModelAsync();
     
     /**
      * 初始化游戏视图
@@ -103,6 +105,28 @@ private:
      */
     void onUndo();
     
+    /**
+     * 开始监视当前关卡文件，文件保存后自动重载（仅调试构建）
+     */
+    void startLevelHotReload();
+    
+    /**
+     * 重新解析关卡文件并原地替换游戏模型，在新模型上尽量重放已走的步数
+     * @param fullPath 关卡文件完整路径
+     */
+    void reloadLevel(const std::string& fullPath);
+    
+    /**
+     * 对局变化后更新提示快照并在后台重新计算提示，同时取消正在显示的提示
+     * @param move 刚执行的点击操作；为nullptr或增量更新失败时从模型完整重建
+     */
+    void updateHint(const GameMove* move);
+    
+    /**
+     * 定时取回后台提示，玩家停顿超过 HINT_IDLE_DELAY 后高亮建议的卡牌
+     */
+    void startHintPolling();
+    
     /**
      * 查找底牌堆卡牌索引
      * @param cardId 卡牌ID
@@ -116,7 +140,7 @@ private:
      * @param targetCardId 目标卡牌ID
      * @param actionType 操作类型
      */
-    void recordUndoAction(int sourceCardId, int targetCardId, const std::string& actionType);
+    void recordUndoAction(int sourceCardId, int targetCardId, GameActionType actionType);
     
     /**
      * 获取卡牌位置
@@ -136,8 +160,14 @@ private:
 private:
     GameModel* _gameModel;              ///< 游戏模型
     GameView* _gameView;                ///< 游戏视图
-    GameStateManager* _stateManager;    ///< 状态管理器
+    GameSession* _session;              ///< 对局会话（规则与状态历史）
     std::vector<UndoAction> _undoActions;  ///< 撤销操作列表（保留用于兼容）
+    std::string _levelId;               ///< 当前关卡ID
+    LevelFileWatcher* _levelWatcher;    ///< 关卡文件监视器（仅调试构建）
+    HintService* _hintService;          ///< 提示服务
+    Hint _hint;                         ///< 最近取回的提示
+    bool _hintShown;                    ///< 提示是否已在视图中高亮
+    float _idleSeconds;                 ///< 距离上次对局变化或点击的时间
 };
 
 #endif // __TEST_SCENE_H__
@@ -0,0 +1,106 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __DAILY_DEAL_FORMAT_H__
+#define __DAILY_DEAL_FORMAT_H__
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * 每日挑战牌局文件二进制格式
+ * 布局：[DailyDealHeader][记录 x N]，每条记录为 DailyDealRecord 后接 cardCount 个卡牌字节，
+ *       整条记录补零到 recordSize 字节（4字节对齐）。
+ * 卡牌按 GameModel 中的顺序存放：主牌堆、底牌、备用牌；第 i 张主牌位于
+ * LevelGenerator::buildLayout 给出的第 i 个位置。卡牌字节低4位为面值，高4位为花色。
+ * 每条记录的 (seed, dealIndex) 可由 LevelGenerator 与 GameModelFromLevelGenerator 复现同一局。
+ * 记录按牌局编号升序排列，与生成时的线程数无关。
+ * 所有字段为小端序、自然对齐，可直接映射到内存后原地读取。
+ */
+
+/**
+ * 牌局文件头，记录生成参数与难度区间
+ */
+struct DailyDealHeader
+{
+    char magic[4];          ///< 固定为 DAILY_DEAL_MAGIC
+    uint32_t version;       ///< 格式版本，见 DAILY_DEAL_VERSION
+    uint32_t byteOrderMark; ///< 固定为 DAILY_DEAL_BYTE_ORDER_MARK，用于检测字节序
+    uint32_t recordSize;    ///< 每条记录的字节数
+    uint64_t seed;          ///< 发牌种子
+    uint8_t layout;         ///< 主牌堆布局（LevelLayoutType）
+    uint8_t mainCount;      ///< 主牌堆张数
+    uint8_t reserveCount;   ///< 备用牌堆张数
+    uint8_t deckCount;      ///< 牌副数
+    uint8_t minSwaps;       ///< 难度区间下限（最优解中的备用牌交换次数）
+    uint8_t maxSwaps;       ///< 难度区间上限
+    uint16_t reserved;      ///< 保留，固定为0
+};
+
+/**
+ * 牌局记录头
+ */
+struct DailyDealRecord
+{
+    uint32_t dealIndex;     ///< 牌局编号
+    uint8_t minClicks;      ///< 最少点击次数
+    uint8_t swapCount;      ///< 最优解中的备用牌交换次数
+    uint16_t reserved;      ///< 保留，固定为0
+};
+
+/**
+ * 续跑检查点，每批牌局写入输出文件后整体替换
+ */
+struct DailyDealCheckpoint
+{
+    char magic[4];          ///< 固定为 DAILY_DEAL_CHECKPOINT_MAGIC
+    uint32_t version;       ///< 格式版本，与 DAILY_DEAL_VERSION 相同
+    DailyDealHeader header; ///< 输出文件头，参数一致才允许续跑
+    uint64_t nextDealIndex; ///< 下一个待处理的牌局编号
+    uint64_t acceptedCount; ///< 已写入的记录数
+    uint64_t outputBytes;   ///< 输出文件中已确认的字节数，之后的内容在续跑时丢弃
+};
+
+static const char DAILY_DEAL_MAGIC[4] = { 'D', 'D', 'E', 'L' };
+static const char DAILY_DEAL_CHECKPOINT_MAGIC[4] = { 'D', 'D', 'C', 'K' };
+static const uint32_t DAILY_DEAL_VERSION = 1;
+static const uint32_t DAILY_DEAL_BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * 计算记录字节数：记录头加卡牌字节，补齐到4字节
+ * @param cardCount 每局卡牌总数
+ * @return 记录字节数
+ */
+inline uint32_t getDailyDealRecordSize(int cardCount)
+{
+    return (uint32_t)((sizeof(DailyDealRecord) + cardCount + 3) & ~3u);
+}
+
+static_assert(sizeof(DailyDealHeader) == 32, "DailyDealHeader layout changed");
+static_assert(sizeof(DailyDealRecord) == 8, "DailyDealRecord layout changed");
+static_assert(sizeof(DailyDealCheckpoint) == 64, "DailyDealCheckpoint layout changed");
+static_assert(std::is_trivially_copyable<DailyDealHeader>::value, "DailyDealHeader must be trivially copyable");
+
+#endif // __DAILY_DEAL_FORMAT_H__
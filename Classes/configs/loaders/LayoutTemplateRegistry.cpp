@@ -0,0 +1,379 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LayoutTemplateRegistry.h"
+#include "../../utils/CardUtils.h"
+#include "external/json/reader.h"
+#include "external/json/memorystream.h"
+#include "external/json/error/en.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+/**
+ * 单个模板的解析结果
+ */
+struct ParsedTemplate
+{
+    std::string name;                       ///< 模板ID
+    std::vector<cocos2d::Vec2> positions;   ///< 卡位位置
+};
+
+/**
+ * 布局模板文件SAX处理器
+ * 结构见 LayoutTemplateRegistry；未知的键及其值整体跳过
+ */
+class LayoutTemplateSaxHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, LayoutTemplateSaxHandler>
+{
+public:
+    explicit LayoutTemplateSaxHandler(std::vector<ParsedTemplate>* templates)
+        : _templates(templates)
+        , _state(PS_ROOT)
+        , _skipDepth(0)
+        , _field(TF_NONE)
+        , _fieldFlags(0)
+        , _x(0.0f)
+        , _y(0.0f)
+        , _error(nullptr)
+    {
+    }
+    
+    const char* getError() const { return _error; }
+    bool isComplete() const { return _state == PS_DONE; }
+    
+    bool Default()
+    {
+        if (_state == PS_ROOT && _skipDepth == 0) {
+            return fail("layout file root must be an object");
+        }
+        _field = TF_NONE;
+        return true;
+    }
+    
+    bool String(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        if (_skipDepth > 0 || _field != TF_ID) {
+            return Default();
+        }
+        if (length == 0 || length > LayoutTemplateRegistry::MAX_NAME_LENGTH) {
+            return fail("layout Id must be 1-23 characters");
+        }
+        _templates->back().name.assign(str, length);
+        _field = TF_NONE;
+        return true;
+    }
+    
+    bool Int(int value) { return Double(value); }
+    bool Uint(unsigned value) { return Double(value); }
+    bool Int64(int64_t value) { return Double((double)value); }
+    bool Uint64(uint64_t value) { return Double((double)value); }
+    
+    bool Double(double value)
+    {
+        if (_skipDepth > 0 || (_field != TF_X && _field != TF_Y)) {
+            return Default();
+        }
+        if (!std::isfinite(value) || std::fabs(value) > MAX_COORDINATE) {
+            return fail("slot coordinate out of range");
+        }
+        if (_field == TF_X) {
+            _x = (float)value;
+        } else {
+            _y = (float)value;
+        }
+        _fieldFlags |= _field == TF_X ? 1 : 2;
+        _field = TF_NONE;
+        return true;
+    }
+    
+    bool StartObject()
+    {
+        if (_skipDepth == 0) {
+            if (_state == PS_ROOT) {
+                _state = PS_FILE;
+                return true;
+            }
+            if (_state == PS_LAYOUT_ARRAY) {
+                _state = PS_LAYOUT;
+                _templates->push_back(ParsedTemplate());
+                return true;
+            }
+            if (_state == PS_SLOT_ARRAY) {
+                _state = PS_SLOT;
+                _fieldFlags = 0;
+                return true;
+            }
+        }
+        return skipNested();
+    }
+    
+    bool Key(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        if (_skipDepth > 0) {
+            return true;
+        }
+        _field = TF_NONE;
+        if (_state == PS_FILE && keyEquals(str, length, "Layouts")) {
+            _field = TF_LAYOUTS;
+        } else if (_state == PS_LAYOUT) {
+            _field = keyEquals(str, length, "Id") ? TF_ID : keyEquals(str, length, "Slots") ? TF_SLOTS : TF_NONE;
+        } else if (_state == PS_SLOT) {
+            _field = keyEquals(str, length, "x") ? TF_X : keyEquals(str, length, "y") ? TF_Y : TF_NONE;
+        }
+        return true;
+    }
+    
+    bool EndObject(rapidjson::SizeType memberCount)
+    {
+        if (_skipDepth > 0) {
+            --_skipDepth;
+            return true;
+        }
+        switch (_state) {
+            case PS_FILE:
+                _state = PS_DONE;
+                return true;
+            case PS_LAYOUT:
+                if (_templates->back().name.empty()) {
+                    return fail("layout is missing Id");
+                }
+                _state = PS_LAYOUT_ARRAY;
+                return true;
+            case PS_SLOT:
+                if (_fieldFlags != 3) {
+                    return fail("slot is missing x or y");
+                }
+                if (_templates->back().positions.size() >= (size_t)LayoutTemplate::MAX_SLOTS) {
+                    return fail("layout has more than 64 slots");
+                }
+                _templates->back().positions.push_back(cocos2d::Vec2(_x, _y));
+                _state = PS_SLOT_ARRAY;
+                return true;
+            default:
+                return true;
+        }
+    }
+    
+    bool StartArray()
+    {
+        if (_skipDepth == 0) {
+            if (_state == PS_FILE && _field == TF_LAYOUTS) {
+                _state = PS_LAYOUT_ARRAY;
+                _field = TF_NONE;
+                return true;
+            }
+            if (_state == PS_LAYOUT && _field == TF_SLOTS) {
+                _state = PS_SLOT_ARRAY;
+                _field = TF_NONE;
+                return true;
+            }
+        }
+        return skipNested();
+    }
+    
+    bool EndArray(rapidjson::SizeType elementCount)
+    {
+        if (_skipDepth > 0) {
+            --_skipDepth;
+            return true;
+        }
+        _state = _state == PS_SLOT_ARRAY ? PS_LAYOUT : PS_FILE;
+        return true;
+    }
+
+private:
+    enum ParseState
+    {
+        PS_ROOT,            ///< 等待顶层对象
+        PS_FILE,            ///< 顶层对象内
+        PS_LAYOUT_ARRAY,    ///< 模板数组内
+        PS_LAYOUT,          ///< 模板对象内
+        PS_SLOT_ARRAY,      ///< 卡位数组内
+        PS_SLOT,            ///< 卡位对象内
+        PS_DONE             ///< 顶层对象已结束
+    };
+    
+    enum TemplateField
+    {
+        TF_NONE,
+        TF_LAYOUTS,
+        TF_ID,
+        TF_SLOTS,
+        TF_X,
+        TF_Y
+    };
+    
+    static const int MAX_SKIP_DEPTH = 32;  ///< 未知值的最大嵌套层数，限制解析器递归深度
+    
+    /**
+     * 进入未知的对象或数组，整体跳过
+     */
+    bool skipNested()
+    {
+        if (++_skipDepth > MAX_SKIP_DEPTH) {
+            return fail("unknown value nested too deeply");
+        }
+        _field = TF_NONE;
+        return true;
+    }
+    
+    static bool keyEquals(const char* str, rapidjson::SizeType length, const char* name)
+    {
+        return std::strlen(name) == length && std::memcmp(str, name, length) == 0;
+    }
+    
+    bool fail(const char* message)
+    {
+        _error = message;
+        return false;
+    }
+    
+    static const int MAX_COORDINATE = 100000;  ///< 坐标绝对值上限
+    
+    std::vector<ParsedTemplate>* _templates;    ///< 输出的模板
+    ParseState _state;                          ///< 当前解析位置
+    int _skipDepth;                             ///< 跳过中的嵌套层数
+    TemplateField _field;                       ///< 下一个值对应的字段
+    int _fieldFlags;                            ///< 当前卡位已读到的坐标
+    float _x;                                   ///< 当前卡位X
+    float _y;                                   ///< 当前卡位Y
+    const char* _error;                         ///< 校验失败原因
+};
+
+} // namespace
+
+const char* const LayoutTemplateRegistry::DEFAULT_FILE_NAME = "layouts.json";
+
+LayoutTemplateRegistry* LayoutTemplateRegistry::getInstance()
+{
+    static LayoutTemplateRegistry instance;
+    return &instance;
+}
+
+LayoutTemplateRegistry::LayoutTemplateRegistry()
+{
+}
+
+std::shared_ptr<const LayoutTemplate> LayoutTemplateRegistry::findTemplate(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _templates.find(name);
+    return it != _templates.end() ? it->second : std::shared_ptr<const LayoutTemplate>();
+}
+
+bool LayoutTemplateRegistry::registerTemplate(const std::shared_ptr<const LayoutTemplate>& layoutTemplate)
+{
+    if (!layoutTemplate || layoutTemplate->getName().empty() || layoutTemplate->getName().size() > MAX_NAME_LENGTH) {
+        return false;
+    }
+    loadDefaultTemplates();
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    _templates[layoutTemplate->getName()] = layoutTemplate;
+    return true;
+}
+
+bool LayoutTemplateRegistry::loadTemplatesFromFile(const std::string& filePath)
+{
+    loadDefaultTemplates();
+    return loadFile(filePath);
+}
+
+bool LayoutTemplateRegistry::loadTemplatesFromMemory(const char* data, size_t length)
+{
+    loadDefaultTemplates();
+    return parseAndRegister(data, length);
+}
+
+std::vector<std::shared_ptr<const LayoutTemplate>> LayoutTemplateRegistry::getTemplates()
+{
+    std::vector<std::shared_ptr<const LayoutTemplate>> templates;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& entry : _templates) {
+            templates.push_back(entry.second);
+        }
+    }
+    std::sort(templates.begin(), templates.end(),
+              [](const std::shared_ptr<const LayoutTemplate>& a, const std::shared_ptr<const LayoutTemplate>& b) {
+                  return a->getName() < b->getName();
+              });
+    return templates;
+}
+
+void LayoutTemplateRegistry::loadDefaultTemplates()
+{
+    std::call_once(_defaultsOnce, [this]() {
+        // 默认文件是可选的，不存在时不报错
+        if (cocos2d::FileUtils::getInstance()->isFileExist(DEFAULT_FILE_NAME)) {
+            loadFile(DEFAULT_FILE_NAME);
+        }
+    });
+}
+
+bool LayoutTemplateRegistry::loadFile(const std::string& filePath)
+{
+    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
+    std::string content = cocos2d::FileUtils::getInstance()->getStringFromFile(fullPath);
+    if (content.empty()) {
+        cocos2d::log("LayoutTemplateRegistry: Failed to read file %s", filePath.c_str());
+        return false;
+    }
+    return parseAndRegister(content.data(), content.size());
+}
+
+bool LayoutTemplateRegistry::parseAndRegister(const char* data, size_t length)
+{
+    if (!data || length == 0) {
+        cocos2d::log("LayoutTemplateRegistry: Empty JSON data");
+        return false;
+    }
+    
+    std::vector<ParsedTemplate> parsed;
+    LayoutTemplateSaxHandler handler(&parsed);
+    rapidjson::Reader reader;
+    rapidjson::MemoryStream stream(data, length);
+    rapidjson::ParseResult result = reader.Parse<rapidjson::kParseDefaultFlags>(stream, handler);
+    
+    if (!result || !handler.isComplete()) {
+        const char* reason = handler.getError() ? handler.getError() :
+                             !result ? rapidjson::GetParseError_En(result.Code()) : "layout file root must be an object";
+        cocos2d::log("LayoutTemplateRegistry: Failed to parse JSON data at offset %zu: %s", result.Offset(), reason);
+        return false;
+    }
+    
+    // 重叠关系在锁外计算，注册时只交换引用
+    std::vector<std::shared_ptr<const LayoutTemplate>> templates;
+    for (const auto& entry : parsed) {
+        templates.push_back(std::make_shared<LayoutTemplate>(entry.name, entry.positions, CardUtils::getCardSize()));
+    }
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& layoutTemplate : templates) {
+        _templates[layoutTemplate->getName()] = layoutTemplate;
+    }
+    return true;
+}
@@ -0,0 +1,124 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __LAYOUT_TEMPLATE_REGISTRY_H__
+#define __LAYOUT_TEMPLATE_REGISTRY_H__
+
+#include "../models/LayoutTemplate.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 布局模板注册表
+ * 职责：按模板ID保存布局模板，供关卡加载时解析 "Layout" 引用
+ * 使用场景：应用启动时在主线程加载 layouts.json（不存在则为空），工具也可显式加载其他文件
+ * 文件结构：{ "Layouts": [ { "Id": str, "Slots": [ { "x": num, "y": num } ] } ] }
+ * 所有接口线程安全，模板一经注册即不可修改，同名重新注册只替换引用；
+ * 查找与列举不读取文件，可在后台解析线程中调用，读取文件的接口须在主线程调用（经 FileUtils 解析相对路径）
+ */
+class LayoutTemplateRegistry
+{
+public:
+    static const char* const DEFAULT_FILE_NAME;     ///< 默认模板文件名
+    static const size_t MAX_NAME_LENGTH = 23;       ///< 模板ID最大长度（与关卡包格式一致）
+    
+    /**
+     * 获取单例
+     * @return 注册表实例
+     */
+    static LayoutTemplateRegistry* getInstance();
+    
+    /**
+     * 加载默认模板文件 layouts.json，不存在时跳过；只在第一次调用时读取
+     * 注册或加载其他模板前会先调用本接口，保证显式注册的模板不会被默认文件覆盖
+     */
+    void loadDefaultTemplates();
+    
+    /**
+     * 查找模板
+     * @param name 模板ID
+     * @return 模板，不存在返回空
+     */
+    std::shared_ptr<const LayoutTemplate> findTemplate(const std::string& name);
+    
+    /**
+     * 注册模板，已存在同名模板时替换
+     * @param layoutTemplate 模板
+     * @return 模板ID为空或过长时返回false
+     */
+    bool registerTemplate(const std::shared_ptr<const LayoutTemplate>& layoutTemplate);
+    
+    /**
+     * 从文件加载并注册模板
+     * @param filePath 文件路径（经 FileUtils 解析）
+     * @return 是否成功
+     */
+    bool loadTemplatesFromFile(const std::string& filePath);
+    
+    /**
+     * 从内存中的JSON加载并注册模板
+     * 任一模板无效时整个文件都不注册
+     * @param data JSON数据
+     * @param length 数据长度
+     * @return 是否成功
+     */
+    bool loadTemplatesFromMemory(const char* data, size_t length);
+    
+    /**
+     * 获取全部已注册模板
+     * @return 模板列表，按模板ID排序
+     */
+    std::vector<std::shared_ptr<const LayoutTemplate>> getTemplates();
+
+private:
+    /**
+     * 构造函数
+     */
+    LayoutTemplateRegistry();
+    
+    /**
+     * 读取文件并注册其中的模板
+     * @param filePath 文件路径
+     * @return 是否成功
+     */
+    bool loadFile(const std::string& filePath);
+    
+    /**
+     * 解析JSON并注册其中的模板
+     * @param data JSON数据
+     * @param length 数据长度
+     * @return 是否成功
+     */
+    bool parseAndRegister(const char* data, size_t length);
+
+private:
+    std::mutex _mutex;                                                              ///< 保护模板表
+    std::once_flag _defaultsOnce;                                                   ///< 默认文件只加载一次
+    std::unordered_map<std::string, std::shared_ptr<const LayoutTemplate>> _templates; ///< 模板表
+};
+
+#endif // __LAYOUT_TEMPLATE_REGISTRY_H__
@@ -23,115 +23,649 @@
  ****************************************************************************/
 
 #include "LevelConfigLoader.h"
-#include "external/json/document.h"
-#include "external/json/filereadstream.h"
+#include "LevelPackLoader.h"
+#include "LayoutTemplateRegistry.h"
+#include "../../models/CardModel.h"
+#include "external/json/reader.h"
+#include "external/json/memorystream.h"
+#include "external/json/error/en.h"
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 
-LevelConfig* LevelConfigLoader::loadLevelConfig(const std::string& levelId)
+namespace {
+
+/**
+ * 牌堆解析表项：JSON中的牌堆名与对应的添加函数
+ */
+struct PileEntry
 {
-    std::string filePath = "level" + levelId + ".json";
-    return loadLevelConfigFromFile(filePath);
-}
+    const char* name;                                           ///< JSON键名
+    void (LevelConfig::*addCard)(const LevelConfig::CardConfig&); ///< 添加卡牌函数
+};
+
+const PileEntry PILE_TABLE[] = {
+    { "MainPile",    &LevelConfig::addMainPileCard },
+    { "BottomPile",  &LevelConfig::addBottomPileCard },
+    { "ReservePile", &LevelConfig::addReservePileCard },
+};
+
+const int PILE_COUNT = sizeof(PILE_TABLE) / sizeof(PILE_TABLE[0]);
 
-LevelConfig* LevelConfigLoader::loadLevelConfigFromFile(const std::string& filePath)
+/**
+ * 模式中的值类型
+ */
+enum SchemaType
 {
-    // 获取文件完整路径
-    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
+    ST_INTEGER,     ///< 整数
+    ST_NUMBER,      ///< 数值（整数或小数）
+    ST_STRING,      ///< 字符串
+    ST_OBJECT,      ///< 对象
+    ST_ARRAY        ///< 数组（元素为对象）
+};
+
+/**
+ * 模式中的对象类型
+ */
+enum SchemaObject
+{
+    SO_LEVEL,       ///< 关卡（顶层对象）
+    SO_CARD,        ///< 卡牌
+    SO_POSITION,    ///< 位置
+    SO_NONE         ///< 非对象
+};
+
+/**
+ * 字段编号，同一对象内的编号即 seen 掩码中的位序号
+ */
+enum SchemaField
+{
+    SF_MAIN_PILE = 0,       ///< 与 PILE_TABLE 顺序一致
+    SF_BOTTOM_PILE = 1,
+    SF_RESERVE_PILE = 2,
+    SF_LAYOUT = 3,
     
-    // 读取文件内容
-    std::string content = cocos2d::FileUtils::getInstance()->getStringFromFile(fullPath);
-    if (content.empty()) {
-        cocos2d::log("LevelConfigLoader: Failed to read file %s", filePath.c_str());
-        return nullptr;
-    }
+    SF_CARD_FACE = 0,
+    SF_CARD_SUIT = 1,
+    SF_POSITION = 2,
+    SF_SLOT = 3,
     
-    return parseJsonToLevelConfig(content);
-}
+    SF_X = 0,
+    SF_Y = 1
+};
 
-LevelConfig* LevelConfigLoader::parseJsonToLevelConfig(const std::string& jsonData)
+/**
+ * 字段模式
+ */
+struct FieldSchema
 {
-    using namespace rapidjson;
+    const char* key;        ///< JSON键名
+    int field;              ///< 字段编号
+    SchemaType type;        ///< 值类型
+    SchemaObject child;     ///< 对象值或数组元素的对象类型
+    double minValue;        ///< 数值下限；字符串为最短长度
+    double maxValue;        ///< 数值上限；字符串为最长长度
+    bool required;          ///< 是否必填（Position 的必填条件见 LevelConfigSaxHandler）
+};
+
+const double MAX_COORDINATE = 100000.0;    ///< 坐标绝对值上限
+
+const FieldSchema LEVEL_SCHEMA[] = {
+    { "MainPile",    SF_MAIN_PILE,    ST_ARRAY,  SO_CARD, 0, 0, false },
+    { "BottomPile",  SF_BOTTOM_PILE,  ST_ARRAY,  SO_CARD, 0, 0, false },
+    { "ReservePile", SF_RESERVE_PILE, ST_ARRAY,  SO_CARD, 0, 0, false },
+    { "Layout",      SF_LAYOUT,       ST_STRING, SO_NONE, 1, LayoutTemplateRegistry::MAX_NAME_LENGTH, false },
+};
+
+const FieldSchema CARD_SCHEMA[] = {
+    { "CardFace", SF_CARD_FACE, ST_INTEGER, SO_NONE,     CFT_ACE,   CFT_KING,   true },
+    { "CardSuit", SF_CARD_SUIT, ST_INTEGER, SO_NONE,     CST_CLUBS, CST_SPADES, true },
+    { "Position", SF_POSITION,  ST_OBJECT,  SO_POSITION, 0,         0,          false },
+    { "Slot",     SF_SLOT,      ST_INTEGER, SO_NONE,     0,         LayoutTemplate::MAX_SLOTS - 1, false },
+};
+
+const FieldSchema POSITION_SCHEMA[] = {
+    { "x", SF_X, ST_NUMBER, SO_NONE, -MAX_COORDINATE, MAX_COORDINATE, true },
+    { "y", SF_Y, ST_NUMBER, SO_NONE, -MAX_COORDINATE, MAX_COORDINATE, true },
+};
+
+/**
+ * 对象模式
+ */
+struct ObjectSchema
+{
+    const FieldSchema* fields;  ///< 字段表
+    int fieldCount;             ///< 字段数量
+};
+
+const ObjectSchema OBJECT_SCHEMAS[] = {
+    { LEVEL_SCHEMA,    sizeof(LEVEL_SCHEMA) / sizeof(LEVEL_SCHEMA[0]) },
+    { CARD_SCHEMA,     sizeof(CARD_SCHEMA) / sizeof(CARD_SCHEMA[0]) },
+    { POSITION_SCHEMA, sizeof(POSITION_SCHEMA) / sizeof(POSITION_SCHEMA[0]) },
+};
+
+/**
+ * 关卡配置SAX处理器
+ * 职责：按解析事件直接填充 LevelConfig，并在同一遍中按上面的模式表校验键、类型、取值范围与必填字段
+ * 结构：{ "Layout": str, "<牌堆名>": [ { "CardFace": int, "CardSuit": int, "Position": { "x": num, "y": num }, "Slot": int } ] }
+ * "Layout" 可选，引用 LayoutTemplateRegistry 中的模板；此时主牌堆卡牌可省略 Position，
+ * 位置取自 "Slot" 指定的卡位，未给出 Slot 时取主牌堆中的序号；给出 Slot 时忽略 Position
+ * 未知的键及其值整体跳过，便于旧版本客户端读取新增字段的关卡；其余任何不符合模式的内容都会报错，
+ * 错误位置为出错时在数据中的偏移（缺少字段时为所在对象的起始位置）
+ */
+class LevelConfigSaxHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, LevelConfigSaxHandler>
+{
+public:
+    LevelConfigSaxHandler(LevelConfig* config, const rapidjson::MemoryStream* stream)
+        : _config(config)
+        , _stream(stream)
+        , _state(PS_ROOT)
+        , _skipDepth(0)
+        , _expected(nullptr)
+        , _levelSeen(0)
+        , _cardSeen(0)
+        , _positionSeen(0)
+        , _pileIndex(-1)
+        , _cardCount(0)
+        , _cardOffset(0)
+        , _face(0)
+        , _suit(0)
+        , _x(0.0f)
+        , _y(0.0f)
+        , _slot(-1)
+        , _errorOffset(0)
+    {
+        _error[0] = '\0';
+    }
     
-    Document document;
-    document.Parse(jsonData.c_str());
+    const char* getError() const { return _error[0] ? _error : nullptr; }
+    size_t getErrorOffset() const { return _errorOffset; }
     
-    if (document.HasParseError() || !document.IsObject()) {
-        cocos2d::log("LevelConfigLoader: Failed to parse JSON data");
-        return nullptr;
+    bool Default()
+    {
+        // 布尔与null，模式中没有这两种类型
+        return onScalar(_skipDepth > 0 ? nullptr : _expected);
     }
     
-    LevelConfig* config = new LevelConfig();
+    bool String(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        if (_skipDepth > 0 || !_expected) {
+            return onScalar(nullptr);
+        }
+        if (_expected->type != ST_STRING) {
+            return onScalar(_expected);
+        }
+        if (length < _expected->minValue || length > _expected->maxValue) {
+            return fail("%s must be %g-%g characters", _expected->key, _expected->minValue, _expected->maxValue);
+        }
+        _layoutName.assign(str, length);
+        _expected = nullptr;
+        return true;
+    }
+    
+    bool Int(int value) { return onNumber(value, true); }
+    bool Uint(unsigned value) { return onNumber(value, true); }
+    bool Int64(int64_t value) { return onNumber((double)value, true); }
+    bool Uint64(uint64_t value) { return onNumber((double)value, true); }
+    bool Double(double value) { return onNumber(value, false); }
     
-    // 解析主牌堆配置
-    if (document.HasMember("MainPile") && document["MainPile"].IsArray()) {
-        const Value& mainPileArray = document["MainPile"];
-        for (auto it = mainPileArray.Begin(); it != mainPileArray.End(); ++it) {
-            if (it->IsObject() && 
-                it->HasMember("CardFace") && it->HasMember("CardSuit") && it->HasMember("Position")) {
-                
-                int cardFace = (*it)["CardFace"].GetInt();
-                int cardSuit = (*it)["CardSuit"].GetInt();
-                
-                const Value& pos = (*it)["Position"];
-                if (pos.IsObject() && pos.HasMember("x") && pos.HasMember("y")) {
-                    float x = pos["x"].GetFloat();
-                    float y = pos["y"].GetFloat();
-                    
-                    LevelConfig::CardConfig cardConfig(cardFace, cardSuit, cocos2d::Vec2(x, y));
-                    config->addMainPileCard(cardConfig);
+    bool StartObject()
+    {
+        if (_skipDepth > 0 || (_state != PS_ROOT && _state != PS_PILE && !_expected)) {
+            return skipNested();
+        }
+        switch (_state) {
+            case PS_ROOT:
+                _state = PS_LEVEL;
+                return true;
+            case PS_PILE:
+                _state = PS_CARD;
+                _cardSeen = 0;
+                _cardOffset = _stream->Tell() - 1;
+                return true;
+            case PS_CARD:
+                if (_expected->type == ST_OBJECT) {
+                    _expected = nullptr;
+                    _state = PS_POSITION;
+                    _positionSeen = 0;
+                    return true;
                 }
-            }
+                break;
+            default:
+                break;
         }
+        return typeMismatch(_expected);
     }
     
-    // 解析底牌堆配置
-    if (document.HasMember("BottomPile") && document["BottomPile"].IsArray()) {
-        const Value& bottomPileArray = document["BottomPile"];
-        for (auto it = bottomPileArray.Begin(); it != bottomPileArray.End(); ++it) {
-            if (it->IsObject() && 
-                it->HasMember("CardFace") && it->HasMember("CardSuit") && it->HasMember("Position")) {
-                
-                int cardFace = (*it)["CardFace"].GetInt();
-                int cardSuit = (*it)["CardSuit"].GetInt();
-                
-                const Value& pos = (*it)["Position"];
-                if (pos.IsObject() && pos.HasMember("x") && pos.HasMember("y")) {
-                    float x = pos["x"].GetFloat();
-                    float y = pos["y"].GetFloat();
-                    
-                    LevelConfig::CardConfig cardConfig(cardFace, cardSuit, cocos2d::Vec2(x, y));
-                    config->addBottomPileCard(cardConfig);
+    bool Key(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        if (_skipDepth > 0) {
+            return true;
+        }
+        SchemaObject object = _state == PS_LEVEL ? SO_LEVEL : _state == PS_CARD ? SO_CARD : SO_POSITION;
+        int* seen = _state == PS_LEVEL ? &_levelSeen : _state == PS_CARD ? &_cardSeen : &_positionSeen;
+        
+        _expected = nullptr;
+        const ObjectSchema& schema = OBJECT_SCHEMAS[object];
+        for (int i = 0; i < schema.fieldCount; ++i) {
+            const FieldSchema& field = schema.fields[i];
+            if (std::strlen(field.key) == length && std::memcmp(str, field.key, length) == 0) {
+                if (*seen & (1 << field.field)) {
+                    return fail("duplicate key %s", field.key);
                 }
+                *seen |= 1 << field.field;
+                _expected = &field;
+                break;
+            }
+        }
+        return true;
+    }
+    
+    bool EndObject(rapidjson::SizeType memberCount)
+    {
+        if (_skipDepth > 0) {
+            --_skipDepth;
+            return true;
+        }
+        switch (_state) {
+            case PS_POSITION:
+                _state = PS_CARD;
+                return checkRequired(SO_POSITION, _positionSeen, _cardOffset);
+            case PS_CARD:
+                _state = PS_PILE;
+                return onCardEnd();
+            case PS_LEVEL:
+                _state = PS_DONE;
+                return resolveMainPile();
+            default:
+                return true;
+        }
+    }
+    
+    bool StartArray()
+    {
+        if (_skipDepth > 0 || (_state != PS_ROOT && _state != PS_PILE && !_expected)) {
+            return skipNested();
+        }
+        if (_state == PS_LEVEL && _expected->type == ST_ARRAY) {
+            _pileIndex = _expected->field;
+            _expected = nullptr;
+            _state = PS_PILE;
+            return true;
+        }
+        return typeMismatch(_expected);
+    }
+    
+    bool EndArray(rapidjson::SizeType elementCount)
+    {
+        if (_skipDepth > 0) {
+            --_skipDepth;
+            return true;
+        }
+        _state = PS_LEVEL;
+        _pileIndex = -1;
+        return true;
+    }
+    
+    /**
+     * 是否读到了完整的顶层对象
+     */
+    bool isComplete() const { return _state == PS_DONE; }
+
+private:
+    enum ParseState
+    {
+        PS_ROOT,        ///< 等待顶层对象
+        PS_LEVEL,       ///< 顶层对象内
+        PS_PILE,        ///< 牌堆数组内
+        PS_CARD,        ///< 卡牌对象内
+        PS_POSITION,    ///< 位置对象内
+        PS_DONE         ///< 顶层对象已结束
+    };
+    
+    static const int MAX_SKIP_DEPTH = 32;  ///< 未知值的最大嵌套层数，限制解析器递归深度
+    
+    /**
+     * 记录错误并中止解析
+     * @param format 错误信息格式，参数为键名与可选的取值范围
+     */
+    bool fail(const char* format, const char* key = "", double minValue = 0, double maxValue = 0)
+    {
+        return failAt(_stream->Tell(), format, key, minValue, maxValue);
+    }
+    
+    bool failAt(size_t offset, const char* format, const char* key = "", double minValue = 0, double maxValue = 0)
+    {
+        std::snprintf(_error, sizeof(_error), format, key, minValue, maxValue);
+        _errorOffset = offset;
+        return false;
+    }
+    
+    bool typeMismatch(const FieldSchema* field)
+    {
+        if (_state == PS_ROOT) {
+            return fail("level root must be an object");
+        }
+        if (_state == PS_PILE) {
+            return fail("%s elements must be card objects", PILE_TABLE[_pileIndex].name);
+        }
+        static const char* const TYPE_NAMES[] = { "an integer", "a number", "a string", "an object", "an array" };
+        std::string format = std::string("%s must be ") + TYPE_NAMES[field->type];
+        return fail(format.c_str(), field->key);
+    }
+    
+    /**
+     * 进入不在模式中的对象或数组，整体跳过
+     */
+    bool skipNested()
+    {
+        if (++_skipDepth > MAX_SKIP_DEPTH) {
+            return fail("unknown value nested too deeply");
+        }
+        _expected = nullptr;
+        return true;
+    }
+    
+    /**
+     * 标量值：不在模式中的直接跳过，期望其他类型时报错
+     * @param expected 期望的字段，nullptr 表示未知键
+     */
+    bool onScalar(const FieldSchema* expected)
+    {
+        if (_skipDepth > 0) {
+            return true;
+        }
+        if (expected || _state == PS_ROOT || _state == PS_PILE) {
+            return typeMismatch(expected);
+        }
+        _expected = nullptr;
+        return true;
+    }
+    
+    bool onNumber(double value, bool isInteger)
+    {
+        if (_skipDepth > 0 || !_expected) {
+            return onScalar(nullptr);
+        }
+        const FieldSchema* field = _expected;
+        if (field->type != ST_NUMBER && !(field->type == ST_INTEGER && isInteger)) {
+            return typeMismatch(field);
+        }
+        if (!(value >= field->minValue && value <= field->maxValue)) {
+            return fail("%s out of range [%g, %g]", field->key, field->minValue, field->maxValue);
+        }
+        _expected = nullptr;
+        
+        if (_state == PS_POSITION) {
+            (field->field == SF_X ? _x : _y) = (float)value;
+            return true;
+        }
+        switch (field->field) {
+            case SF_CARD_FACE:
+                _face = (int)value;
+                break;
+            case SF_CARD_SUIT:
+                _suit = (int)value;
+                break;
+            case SF_SLOT:
+                _slot = (int)value;
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+    
+    /**
+     * 检查必填字段
+     * @param object 对象类型
+     * @param seen 已读到的字段掩码
+     * @param offset 对象起始偏移，用于报告错误位置
+     */
+    bool checkRequired(SchemaObject object, int seen, size_t offset)
+    {
+        const ObjectSchema& schema = OBJECT_SCHEMAS[object];
+        for (int i = 0; i < schema.fieldCount; ++i) {
+            if (schema.fields[i].required && !(seen & (1 << schema.fields[i].field))) {
+                return failAt(offset, "missing required key %s", schema.fields[i].key);
             }
         }
+        return true;
     }
     
-    // 解析备用牌堆配置
-    if (document.HasMember("ReservePile") && document["ReservePile"].IsArray()) {
-        const Value& reservePileArray = document["ReservePile"];
-        for (auto it = reservePileArray.Begin(); it != reservePileArray.End(); ++it) {
-            if (it->IsObject() && 
-                it->HasMember("CardFace") && it->HasMember("CardSuit") && it->HasMember("Position")) {
-                
-                int cardFace = (*it)["CardFace"].GetInt();
-                int cardSuit = (*it)["CardSuit"].GetInt();
-                
-                const Value& pos = (*it)["Position"];
-                if (pos.IsObject() && pos.HasMember("x") && pos.HasMember("y")) {
-                    float x = pos["x"].GetFloat();
-                    float y = pos["y"].GetFloat();
-                    
-                    LevelConfig::CardConfig cardConfig(cardFace, cardSuit, cocos2d::Vec2(x, y));
-                    config->addReservePileCard(cardConfig);
+    /**
+     * 卡牌对象结束：主牌堆卡牌先暂存，待读完整个关卡（含 Layout）后再确定位置
+     */
+    bool onCardEnd()
+    {
+        if (!checkRequired(SO_CARD, _cardSeen, _cardOffset)) {
+            return false;
+        }
+        if (++_cardCount > LevelConfig::MAX_CARD_COUNT) {
+            return failAt(_cardOffset, "level has more than %s%g cards", "", LevelConfig::MAX_CARD_COUNT);
+        }
+        bool hasPosition = (_cardSeen & (1 << SF_POSITION)) != 0;
+        bool hasSlot = (_cardSeen & (1 << SF_SLOT)) != 0;
+        if (_pileIndex != SF_MAIN_PILE) {
+            if (hasSlot) {
+                return failAt(_cardOffset, "Slot is only supported in MainPile");
+            }
+            if (!hasPosition) {
+                return failAt(_cardOffset, "missing required key %s", "Position");
+            }
+            (_config->*PILE_TABLE[_pileIndex].addCard)(LevelConfig::CardConfig(_face, _suit, cocos2d::Vec2(_x, _y)));
+            return true;
+        }
+        
+        // 未给出位置时默认按序号占用卡位，是否有模板在读完整个关卡后检查
+        int slot = hasSlot ? _slot : hasPosition ? -1 : (int)_mainCards.size();
+        _mainCards.push_back(LevelConfig::CardConfig(_face, _suit, cocos2d::Vec2(_x, _y), slot));
+        _mainCardOffsets.push_back(_cardOffset);
+        return true;
+    }
+    
+    /**
+     * 关卡对象结束：解析布局模板，为主牌堆卡牌填入卡位位置
+     */
+    bool resolveMainPile()
+    {
+        std::shared_ptr<const LayoutTemplate> layout;
+        if (!_layoutName.empty()) {
+            layout = LayoutTemplateRegistry::getInstance()->findTemplate(_layoutName);
+            if (!layout) {
+                return fail("unknown Layout %s", _layoutName.c_str());
+            }
+        }
+        _config->setLayout(layout);
+        
+        uint64_t usedSlots = 0;
+        for (size_t i = 0; i < _mainCards.size(); ++i) {
+            LevelConfig::CardConfig& card = _mainCards[i];
+            if (card.slot >= 0) {
+                if (!layout) {
+                    return failAt(_mainCardOffsets[i], "MainPile card needs Position or a Layout");
+                }
+                if (card.slot >= layout->getSlotCount()) {
+                    return failAt(_mainCardOffsets[i], "Slot out of range for Layout %s", layout->getName().c_str());
+                }
+                if (usedSlots & (uint64_t(1) << card.slot)) {
+                    return failAt(_mainCardOffsets[i], "Slot already used by another card");
                 }
+                usedSlots |= uint64_t(1) << card.slot;
+                card.position = layout->getSlotPosition(card.slot);
             }
+            _config->addMainPileCard(card);
+        }
+        
+        if (_cardCount == 0) {
+            return failAt(0, "level contains no cards");
+        }
+        return true;
+    }
+    
+    LevelConfig* _config;                       ///< 填充目标
+    const rapidjson::MemoryStream* _stream;     ///< 输入流，用于记录错误位置
+    ParseState _state;                          ///< 当前解析位置
+    int _skipDepth;                             ///< 跳过中的嵌套层数
+    const FieldSchema* _expected;               ///< 下一个值对应的字段，nullptr表示跳过
+    int _levelSeen;                             ///< 关卡对象已读到的字段
+    int _cardSeen;                              ///< 当前卡牌已读到的字段
+    int _positionSeen;                          ///< 当前位置已读到的字段
+    int _pileIndex;                             ///< 当前牌堆在 PILE_TABLE 中的序号
+    int _cardCount;                             ///< 已读到的卡牌总数
+    size_t _cardOffset;                         ///< 当前卡牌对象的起始偏移
+    int _face;                                  ///< 当前卡牌面值
+    int _suit;                                  ///< 当前卡牌花色
+    float _x;                                   ///< 当前卡牌位置X
+    float _y;                                   ///< 当前卡牌位置Y
+    int _slot;                                  ///< 当前卡牌卡位
+    std::string _layoutName;                    ///< 引用的布局模板ID
+    std::vector<LevelConfig::CardConfig> _mainCards;    ///< 暂存的主牌堆卡牌
+    std::vector<size_t> _mainCardOffsets;       ///< 暂存的主牌堆卡牌起始偏移
+    char _error[128];                           ///< 校验失败原因
+    size_t _errorOffset;                        ///< 校验失败位置
+};
+
+/**
+ * 将数据偏移换算为行列号（均从1开始，列按字节计）
+ */
+void locateOffset(const char* data, size_t length, size_t offset, int& line, int& column)
+{
+    line = 1;
+    column = 1;
+    for (size_t i = 0; i < offset && i < length; ++i) {
+        if (data[i] == '\n') {
+            ++line;
+            column = 1;
+        } else {
+            ++column;
+        }
+    }
+}
+
+/**
+ * 全局关卡包
+ * @return 关卡包加载器
+ */
+LevelPackLoader& getLevelPack()
+{
+    static LevelPackLoader levelPack;
+    return levelPack;
+}
+
+/**
+ * 将关卡ID解析为整数
+ * @param levelId 关卡ID
+ * @param value 输出整数
+ * @return 是否为纯数字ID
+ */
+bool parseLevelNumber(const std::string& levelId, int& value)
+{
+    if (levelId.empty() || levelId.size() > 9) {
+        return false;
+    }
+    value = 0;
+    for (char c : levelId) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+bool LevelConfigLoader::openLevelPack(const std::string& packPath)
+{
+    return getLevelPack().open(packPath);
+}
+
+LevelConfig* LevelConfigLoader::loadLevelConfigFromPack(const std::string& levelId)
+{
+    int levelNumber = 0;
+    if (!getLevelPack().isOpen() || !parseLevelNumber(levelId, levelNumber)) {
+        return nullptr;
+    }
+    return getLevelPack().loadLevelConfig(levelNumber);
+}
+
+std::string LevelConfigLoader::getLevelFileName(const std::string& levelId)
+{
+    return "level" + levelId + ".json";
+}
+
+LevelConfig* LevelConfigLoader::loadLevelConfig(const std::string& levelId)
+{
+    LevelConfig* config = loadLevelConfigFromPack(levelId);
+    if (config) {
+        return config;
+    }
+    return loadLevelConfigFromFile(getLevelFileName(levelId));
+}
+
+LevelConfig* LevelConfigLoader::loadLevelConfigFromFile(const std::string& filePath, LoadError* error)
+{
+    // 获取文件完整路径
+    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
+    
+    // 读取文件内容
+    std::string content = cocos2d::FileUtils::getInstance()->getStringFromFile(fullPath);
+    if (content.empty()) {
+        cocos2d::log("LevelConfigLoader: Failed to read file %s", filePath.c_str());
+        if (error) {
+            *error = LoadError();
+            error->message = "failed to read file";
         }
+        return nullptr;
+    }
+    
+    return parseJsonToLevelConfig(content.data(), content.size(), filePath, error);
+}
+
+LevelConfig* LevelConfigLoader::loadLevelConfigFromMemory(const char* data, size_t length, LoadError* error)
+{
+    return parseJsonToLevelConfig(data, length, "<memory>", error);
+}
+
+LevelConfig* LevelConfigLoader::parseJsonToLevelConfig(const char* data, size_t length, const std::string& sourceName,
+                                                        LoadError* error)
+{
+    LoadError localError;
+    LoadError& loadError = error ? *error : localError;
+    loadError = LoadError();
+    
+    if (!data || length == 0) {
+        loadError.message = "empty JSON data";
+        loadError.line = 1;
+        loadError.column = 1;
+        cocos2d::log("LevelConfigLoader: %s: Empty JSON data", sourceName.c_str());
+        return nullptr;
+    }
+    
+    LevelConfig* config = new LevelConfig();
+    rapidjson::Reader reader;
+    rapidjson::MemoryStream stream(data, length);
+    LevelConfigSaxHandler handler(config, &stream);
+    rapidjson::ParseResult result = reader.Parse<rapidjson::kParseDefaultFlags>(stream, handler);
+    
+    if (handler.getError()) {
+        loadError.message = handler.getError();
+        loadError.offset = handler.getErrorOffset();
+    } else if (!result) {
+        loadError.message = rapidjson::GetParseError_En(result.Code());
+        loadError.offset = result.Offset();
+    } else if (!handler.isComplete() || !config->isValid()) {
+        // 模式校验已覆盖 isValid 的各项条件，这里只作兜底
+        loadError.message = "invalid level configuration";
     }
     
-    // 验证配置有效性
-    if (!config->isValid()) {
+    if (!loadError.message.empty()) {
+        locateOffset(data, length, loadError.offset, loadError.line, loadError.column);
+        cocos2d::log("LevelConfigLoader: %s:%d:%d: %s", sourceName.c_str(), loadError.line, loadError.column,
+                     loadError.message.c_str());
         delete config;
-        cocos2d::log("LevelConfigLoader: Invalid level configuration");
         return nullptr;
     }
     
@@ -37,6 +37,19 @@
 class LevelConfigLoader
 {
 public:
+    /**
+     * 加载失败的原因与位置
+     */
+    struct LoadError
+    {
+        std::string message;    ///< 错误原因
+        size_t offset;          ///< 出错位置在数据中的字节偏移
+        int line;               ///< 行号（从1开始），0表示与位置无关（如文件无法读取）
+        int column;             ///< 列号（从1开始，按字节计）
+        
+        LoadError() : offset(0), line(0), column(0) {}
+    };
+    
     /**
      * 从JSON文件加载关卡配置
      * @param levelId 关卡ID
@@ -44,20 +57,59 @@ public:
      */
     static LevelConfig* loadLevelConfig(const std::string& levelId);
     
+    /**
+     * 打开编译好的关卡包
+     * 打开后 loadLevelConfig 优先从关卡包读取，包内没有的关卡仍从JSON文件加载
+     * @param packPath 关卡包路径
+     * @return 是否成功
+     */
+    static bool openLevelPack(const std::string& packPath);
+    
+    /**
+     * 从已打开的关卡包加载关卡配置
+     * 关卡包打开后只读，可在任意线程调用
+     * @param levelId 关卡ID
+     * @return 关卡配置对象，未打开关卡包或包内没有该关卡返回nullptr
+     */
+    static LevelConfig* loadLevelConfigFromPack(const std::string& levelId);
+    
+    /**
+     * 获取关卡JSON文件名
+     * @param levelId 关卡ID
+     * @return 文件名（未经 FileUtils 解析）
+     */
+    static std::string getLevelFileName(const std::string& levelId);
+    
     /**
      * 从JSON文件加载关卡配置
      * @param filePath JSON文件路径
+     * @param error 失败时输出原因与行列号，可为nullptr
      * @return 关卡配置对象，如果加载失败返回nullptr
      */
-    static LevelConfig* loadLevelConfigFromFile(const std::string& filePath);
+    static LevelConfig* loadLevelConfigFromFile(const std::string& filePath, LoadError* error = nullptr);
+    
+    /**
+     * 从内存中的JSON数据加载关卡配置
+     * 以SAX方式流式解析，直接填充 LevelConfig，不构建DOM；同一遍中按关卡模式校验，
+     * 缺少必填字段、类型不符、取值越界、重复键都会失败，不会跳过有问题的卡牌
+     * @param data JSON数据（不要求以'\0'结尾）
+     * @param length 数据长度
+     * @param error 失败时输出原因与行列号，可为nullptr
+     * @return 关卡配置对象，如果解析或校验失败返回nullptr
+     */
+    static LevelConfig* loadLevelConfigFromMemory(const char* data, size_t length, LoadError* error = nullptr);
 
 private:
     /**
-     * 解析JSON数据为关卡配置
-     * @param jsonData JSON数据字符串
+     * 解析JSON数据为关卡配置，失败时以"来源:行:列: 原因"格式输出日志
+     * @param data JSON数据
+     * @param length 数据长度
+     * @param sourceName 日志中显示的数据来源
+     * @param error 失败时输出原因与行列号，可为nullptr
      * @return 关卡配置对象，如果解析失败返回nullptr
      */
-    static LevelConfig* parseJsonToLevelConfig(const std::string& jsonData);
+    static LevelConfig* parseJsonToLevelConfig(const char* data, size_t length, const std::string& sourceName,
+                                               LoadError* error);
 };
 
 #endif // __LEVEL_CONFIG_LOADER_H__
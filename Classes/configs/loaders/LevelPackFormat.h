@@ -0,0 +1,127 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __LEVEL_PACK_FORMAT_H__
+#define __LEVEL_PACK_FORMAT_H__
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * 关卡包二进制格式
+ * 布局：[LevelPackHeader][LevelPackLayoutEntry x layoutCount][LevelPackSlotRecord x slotCount]
+ *       [LevelPackIndexEntry x levelCount][LevelPackCardRecord x cardCount][LevelPackSlotCardRecord x slotCardCount]
+ * 索引按关卡ID连续排列（firstLevelId 起），第N关的索引项位于 N - firstLevelId，查找为O(1)；
+ * 每关的卡牌按主牌堆、底牌堆、备用牌堆顺序连续存放。
+ * 布局模板（卡位位置表）在包内只存一份：主牌堆全部位于模板卡位上的关卡，主牌堆卡牌以4字节的
+ * 卡位记录存放在卡位卡牌区，其余牌堆仍存放在卡牌记录区；
+ * 主牌堆位置完全相同的多个关卡即使没有引用模板，打包时也会共用一份自动生成的模板。
+ * 所有字段为小端序、自然对齐，可直接映射到内存后原地读取。
+ */
+
+/**
+ * 关卡包文件头
+ */
+struct LevelPackHeader
+{
+    char magic[4];          ///< 固定为 LEVEL_PACK_MAGIC
+    uint32_t version;       ///< 格式版本，见 LEVEL_PACK_VERSION
+    uint32_t byteOrderMark; ///< 固定为 LEVEL_PACK_BYTE_ORDER_MARK，用于检测字节序
+    uint32_t firstLevelId;  ///< 第一个索引项对应的关卡ID
+    uint32_t levelCount;    ///< 索引项数量
+    uint32_t cardCount;     ///< 卡牌记录总数
+    uint32_t layoutCount;   ///< 布局模板数量
+    uint32_t slotCount;     ///< 卡位记录总数
+    uint32_t slotCardCount; ///< 卡位卡牌记录总数
+    uint32_t reserved;      ///< 保留，固定为0
+};
+
+/**
+ * 布局模板项
+ */
+struct LevelPackLayoutEntry
+{
+    char name[24];          ///< 模板ID，以'\0'结尾
+    uint32_t firstSlot;     ///< 第一个卡位在卡位记录区中的序号
+    uint32_t slotCount;     ///< 卡位数量（不超过64）
+};
+
+/**
+ * 卡位记录
+ */
+struct LevelPackSlotRecord
+{
+    float x;                ///< 位置X
+    float y;                ///< 位置Y
+};
+
+/**
+ * 关卡索引项
+ * 卡牌数量均为0表示该关卡ID不存在
+ */
+struct LevelPackIndexEntry
+{
+    uint32_t firstCard;     ///< 该关第一张卡牌在卡牌记录区中的序号
+    uint32_t firstSlotCard; ///< 使用模板时，第一张主牌堆卡牌在卡位卡牌区中的序号；否则为0
+    uint16_t mainCount;     ///< 主牌堆卡牌数量
+    uint16_t bottomCount;   ///< 底牌堆卡牌数量
+    uint16_t reserveCount;  ///< 备用牌堆卡牌数量
+    uint16_t layout;        ///< 布局模板序号加1，0表示不使用模板（主牌堆存放在卡牌记录区）
+};
+
+/**
+ * 卡牌记录
+ */
+struct LevelPackCardRecord
+{
+    int8_t face;            ///< 面值 (0-12)
+    int8_t suit;            ///< 花色 (0-3)
+    uint16_t reserved;      ///< 保留，固定为0
+    float x;                ///< 位置X
+    float y;                ///< 位置Y
+};
+
+/**
+ * 卡位卡牌记录（位置取自布局模板）
+ */
+struct LevelPackSlotCardRecord
+{
+    int8_t face;            ///< 面值 (0-12)
+    int8_t suit;            ///< 花色 (0-3)
+    uint16_t slot;          ///< 卡位序号
+};
+
+static const char LEVEL_PACK_MAGIC[4] = { 'L', 'V', 'P', 'K' };
+static const uint32_t LEVEL_PACK_VERSION = 2;
+static const uint32_t LEVEL_PACK_BYTE_ORDER_MARK = 0x01020304;
+
+static_assert(sizeof(LevelPackHeader) == 40, "LevelPackHeader layout changed");
+static_assert(sizeof(LevelPackLayoutEntry) == 32, "LevelPackLayoutEntry layout changed");
+static_assert(sizeof(LevelPackSlotRecord) == 8, "LevelPackSlotRecord layout changed");
+static_assert(sizeof(LevelPackIndexEntry) == 16, "LevelPackIndexEntry layout changed");
+static_assert(sizeof(LevelPackCardRecord) == 12, "LevelPackCardRecord layout changed");
+static_assert(sizeof(LevelPackSlotCardRecord) == 4, "LevelPackSlotCardRecord layout changed");
+static_assert(std::is_trivially_copyable<LevelPackCardRecord>::value, "LevelPackCardRecord must be trivially copyable");
+
+#endif // __LEVEL_PACK_FORMAT_H__
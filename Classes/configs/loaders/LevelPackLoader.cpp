@@ -0,0 +1,463 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LevelPackLoader.h"
+#include "../../utils/CardUtils.h"
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LevelPackLoader::LevelPackLoader()
+    : _data(nullptr)
+    , _size(0)
+    , _mappedAddress(nullptr)
+    , _header(nullptr)
+    , _index(nullptr)
+    , _cards(nullptr)
+    , _slotCards(nullptr)
+{
+}
+
+LevelPackLoader::~LevelPackLoader()
+{
+    close();
+}
+
+bool LevelPackLoader::open(const std::string& filePath)
+{
+    close();
+    
+    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
+    if (fullPath.empty()) {
+        cocos2d::log("LevelPackLoader: File not found %s", filePath.c_str());
+        return false;
+    }
+
+#if !defined(_WIN32)
+    // 优先直接映射文件，只有被访问到的页才会读入
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+            void* address = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                _mappedAddress = address;
+                _data = static_cast<const unsigned char*>(address);
+                _size = (size_t)fileStat.st_size;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    // 无法映射时整体读入
+    if (!_data) {
+        cocos2d::Data fileData = cocos2d::FileUtils::getInstance()->getDataFromFile(fullPath);
+        if (fileData.isNull()) {
+            cocos2d::log("LevelPackLoader: Failed to read file %s", filePath.c_str());
+            return false;
+        }
+        _buffer.assign(fileData.getBytes(), fileData.getBytes() + fileData.getSize());
+        _data = _buffer.data();
+        _size = _buffer.size();
+    }
+    
+    if (!validate()) {
+        cocos2d::log("LevelPackLoader: Invalid level pack %s", filePath.c_str());
+        close();
+        return false;
+    }
+    
+    _header = reinterpret_cast<const LevelPackHeader*>(_data);
+    const LevelPackLayoutEntry* layoutEntries = reinterpret_cast<const LevelPackLayoutEntry*>(_data + sizeof(LevelPackHeader));
+    const LevelPackSlotRecord* slots = reinterpret_cast<const LevelPackSlotRecord*>(layoutEntries + _header->layoutCount);
+    _index = reinterpret_cast<const LevelPackIndexEntry*>(slots + _header->slotCount);
+    _cards = reinterpret_cast<const LevelPackCardRecord*>(_index + _header->levelCount);
+    _slotCards = reinterpret_cast<const LevelPackSlotCardRecord*>(_cards + _header->cardCount);
+    
+    // 每个模板的重叠关系只在打开时计算一次
+    cocos2d::Size cardSize = CardUtils::getCardSize();
+    for (uint32_t i = 0; i < _header->layoutCount; ++i) {
+        const LevelPackLayoutEntry& entry = layoutEntries[i];
+        std::vector<cocos2d::Vec2> positions;
+        for (uint32_t slot = 0; slot < entry.slotCount; ++slot) {
+            positions.push_back(cocos2d::Vec2(slots[entry.firstSlot + slot].x, slots[entry.firstSlot + slot].y));
+        }
+        _layouts.push_back(std::make_shared<LayoutTemplate>(entry.name, positions, cardSize));
+    }
+    return true;
+}
+
+void LevelPackLoader::close()
+{
+#if !defined(_WIN32)
+    if (_mappedAddress) {
+        munmap(_mappedAddress, _size);
+    }
+#endif
+    _mappedAddress = nullptr;
+    _buffer.clear();
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _index = nullptr;
+    _cards = nullptr;
+    _slotCards = nullptr;
+    _layouts.clear();
+}
+
+bool LevelPackLoader::hasLevel(int levelId) const
+{
+    return findEntry(levelId) != nullptr;
+}
+
+bool LevelPackLoader::getLevelView(int levelId, LevelView& view) const
+{
+    const LevelPackIndexEntry* entry = findEntry(levelId);
+    if (!entry) {
+        return false;
+    }
+    
+    view.layoutIndex = (int)entry->layout - 1;
+    view.mainPileCount = entry->mainCount;
+    if (entry->layout != 0) {
+        view.mainPileCards = nullptr;
+        view.mainPileSlotCards = _slotCards + entry->firstSlotCard;
+        view.bottomPileCards = _cards + entry->firstCard;
+    } else {
+        view.mainPileCards = _cards + entry->firstCard;
+        view.mainPileSlotCards = nullptr;
+        view.bottomPileCards = view.mainPileCards + entry->mainCount;
+    }
+    view.bottomPileCount = entry->bottomCount;
+    view.reservePileCards = view.bottomPileCards + entry->bottomCount;
+    view.reservePileCount = entry->reserveCount;
+    return true;
+}
+
+LevelConfig* LevelPackLoader::loadLevelConfig(int levelId) const
+{
+    LevelView view;
+    if (!getLevelView(levelId, view)) {
+        return nullptr;
+    }
+    
+    LevelConfig* config = new LevelConfig();
+    
+    if (view.mainPileSlotCards) {
+        const std::shared_ptr<const LayoutTemplate>& layout = _layouts[view.layoutIndex];
+        for (int i = 0; i < view.mainPileCount; ++i) {
+            const LevelPackSlotCardRecord& record = view.mainPileSlotCards[i];
+            if (record.slot >= layout->getSlotCount()) {
+                cocos2d::log("LevelPackLoader: Level %d references slot %d outside layout %s",
+                             levelId, record.slot, layout->getName().c_str());
+                delete config;
+                return nullptr;
+            }
+            config->addMainPileCard(LevelConfig::CardConfig(record.face, record.suit,
+                                                            layout->getSlotPosition(record.slot), record.slot));
+        }
+        config->setLayout(layout);
+    }
+    
+    const LevelPackCardRecord* piles[] = { view.mainPileCards, view.bottomPileCards, view.reservePileCards };
+    const int counts[] = { view.mainPileSlotCards ? 0 : view.mainPileCount, view.bottomPileCount, view.reservePileCount };
+    void (LevelConfig::*addCard[])(const LevelConfig::CardConfig&) = {
+        &LevelConfig::addMainPileCard, &LevelConfig::addBottomPileCard, &LevelConfig::addReservePileCard
+    };
+    for (int pile = 0; pile < 3; ++pile) {
+        for (int i = 0; i < counts[pile]; ++i) {
+            const LevelPackCardRecord& record = piles[pile][i];
+            (config->*addCard[pile])(LevelConfig::CardConfig(record.face, record.suit, cocos2d::Vec2(record.x, record.y)));
+        }
+    }
+    
+    return config;
+}
+
+bool LevelPackLoader::buildPack(const std::vector<std::pair<int, const LevelConfig*>>& levels, std::string& output)
+{
+    output.clear();
+    
+    LevelPackHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LEVEL_PACK_MAGIC, sizeof(header.magic));
+    header.version = LEVEL_PACK_VERSION;
+    header.byteOrderMark = LEVEL_PACK_BYTE_ORDER_MARK;
+    header.firstLevelId = levels.empty() ? 0 : (uint32_t)levels.front().first;
+    header.levelCount = levels.empty() ? 0 : (uint32_t)(levels.back().first - levels.front().first + 1);
+    
+    // 未引用模板的关卡按主牌堆位置分组，出现两次以上的位置表生成共用模板
+    typedef std::vector<std::pair<float, float>> PositionKey;
+    std::map<PositionKey, int> positionGroups;
+    std::vector<PositionKey> positionKeys(levels.size());
+    std::set<std::string> explicitNames;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const LevelConfig* config = levels[i].second;
+        if (config && config->isFullySlotted()) {
+            explicitNames.insert(config->getLayout()->getName());
+        }
+        if (!config || config->isFullySlotted() || config->getMainPileCards().empty() ||
+            config->getMainPileCards().size() > (size_t)LayoutTemplate::MAX_SLOTS) {
+            continue;
+        }
+        for (const auto& card : config->getMainPileCards()) {
+            positionKeys[i].push_back(std::make_pair(card.position.x, card.position.y));
+        }
+        ++positionGroups[positionKeys[i]];
+    }
+    
+    std::vector<LevelPackLayoutEntry> layoutEntries;
+    std::vector<LevelPackSlotRecord> slots;
+    std::map<std::string, int> layoutByName;
+    std::map<PositionKey, int> layoutByPositions;
+    auto addLayout = [&](const std::string& name, const std::vector<cocos2d::Vec2>& positions) {
+        LevelPackLayoutEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, name.c_str(), name.size());
+        entry.firstSlot = (uint32_t)slots.size();
+        entry.slotCount = (uint32_t)positions.size();
+        for (const auto& position : positions) {
+            LevelPackSlotRecord slot = { position.x, position.y };
+            slots.push_back(slot);
+        }
+        layoutEntries.push_back(entry);
+        layoutByName[name] = (int)layoutEntries.size() - 1;
+        return (int)layoutEntries.size() - 1;
+    };
+    
+    std::vector<LevelPackIndexEntry> index(header.levelCount);
+    std::memset(index.data(), 0, index.size() * sizeof(LevelPackIndexEntry));
+    std::vector<LevelPackCardRecord> records;
+    std::vector<LevelPackSlotCardRecord> slotRecords;
+    
+    int previousLevelId = -1;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const auto& level = levels[i];
+        if (level.first < 0 || level.first <= previousLevelId || !level.second) {
+            cocos2d::log("LevelPackLoader: Level ids must be unique, ascending and non-negative (%d)", level.first);
+            return false;
+        }
+        previousLevelId = level.first;
+        
+        const LevelConfig* config = level.second;
+        const std::vector<LevelConfig::CardConfig>* piles[] = {
+            &config->getMainPileCards(), &config->getBottomPileCards(), &config->getReservePileCards()
+        };
+        for (const auto* pile : piles) {
+            if (pile->size() > 0xFFFF) {
+                cocos2d::log("LevelPackLoader: Level %d has too many cards in one pile", level.first);
+                return false;
+            }
+        }
+        
+        // 确定主牌堆使用的模板
+        int layoutIndex = -1;
+        if (config->isFullySlotted()) {
+            const LayoutTemplate& layout = *config->getLayout();
+            auto it = layoutByName.find(layout.getName());
+            if (layout.getName().empty() || layout.getName().size() >= sizeof(LevelPackLayoutEntry::name)) {
+                cocos2d::log("LevelPackLoader: Level %d uses layout with invalid name %s",
+                             level.first, layout.getName().c_str());
+                return false;
+            }
+            if (it == layoutByName.end()) {
+                layoutIndex = addLayout(layout.getName(), layout.getPositions());
+            } else {
+                const LevelPackLayoutEntry& existing = layoutEntries[it->second];
+                bool same = existing.slotCount == (uint32_t)layout.getSlotCount();
+                for (int slot = 0; same && slot < layout.getSlotCount(); ++slot) {
+                    const LevelPackSlotRecord& record = slots[existing.firstSlot + slot];
+                    same = record.x == layout.getSlotPosition(slot).x && record.y == layout.getSlotPosition(slot).y;
+                }
+                if (!same) {
+                    cocos2d::log("LevelPackLoader: Level %d uses layout %s with different slots",
+                                 level.first, layout.getName().c_str());
+                    return false;
+                }
+                layoutIndex = it->second;
+            }
+        } else if (!positionKeys[i].empty() && positionGroups[positionKeys[i]] > 1) {
+            auto it = layoutByPositions.find(positionKeys[i]);
+            if (it == layoutByPositions.end()) {
+                char name[sizeof(LevelPackLayoutEntry::name)];
+                int suffix = (int)layoutByPositions.size() + 1;
+                do {
+                    std::snprintf(name, sizeof(name), "auto-%d", suffix++);
+                } while (explicitNames.count(name) > 0);
+                std::vector<cocos2d::Vec2> positions;
+                for (const auto& card : config->getMainPileCards()) {
+                    positions.push_back(card.position);
+                }
+                it = layoutByPositions.insert(std::make_pair(positionKeys[i], addLayout(name, positions))).first;
+            }
+            layoutIndex = it->second;
+        }
+        
+        LevelPackIndexEntry& entry = index[level.first - header.firstLevelId];
+        entry.firstCard = (uint32_t)records.size();
+        entry.firstSlotCard = layoutIndex >= 0 ? (uint32_t)slotRecords.size() : 0;
+        entry.mainCount = (uint16_t)piles[0]->size();
+        entry.bottomCount = (uint16_t)piles[1]->size();
+        entry.reserveCount = (uint16_t)piles[2]->size();
+        entry.layout = (uint16_t)(layoutIndex + 1);
+        
+        for (int pile = 0; pile < 3; ++pile) {
+            for (size_t card = 0; card < piles[pile]->size(); ++card) {
+                const LevelConfig::CardConfig& cardConfig = (*piles[pile])[card];
+                if (pile == 0 && layoutIndex >= 0) {
+                    LevelPackSlotCardRecord record;
+                    record.face = (int8_t)cardConfig.cardFace;
+                    record.suit = (int8_t)cardConfig.cardSuit;
+                    record.slot = (uint16_t)(cardConfig.slot >= 0 ? cardConfig.slot : (int)card);
+                    slotRecords.push_back(record);
+                    continue;
+                }
+                LevelPackCardRecord record;
+                record.face = (int8_t)cardConfig.cardFace;
+                record.suit = (int8_t)cardConfig.cardSuit;
+                record.reserved = 0;
+                record.x = cardConfig.position.x;
+                record.y = cardConfig.position.y;
+                records.push_back(record);
+            }
+        }
+    }
+    header.cardCount = (uint32_t)records.size();
+    header.layoutCount = (uint32_t)layoutEntries.size();
+    header.slotCount = (uint32_t)slots.size();
+    header.slotCardCount = (uint32_t)slotRecords.size();
+    
+    output.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.append(reinterpret_cast<const char*>(layoutEntries.data()), layoutEntries.size() * sizeof(LevelPackLayoutEntry));
+    output.append(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(LevelPackSlotRecord));
+    output.append(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(LevelPackIndexEntry));
+    output.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(LevelPackCardRecord));
+    output.append(reinterpret_cast<const char*>(slotRecords.data()), slotRecords.size() * sizeof(LevelPackSlotCardRecord));
+    return true;
+}
+
+std::shared_ptr<const LayoutTemplate> LevelPackLoader::getLayout(int layoutIndex) const
+{
+    if (layoutIndex < 0 || layoutIndex >= (int)_layouts.size()) {
+        return std::shared_ptr<const LayoutTemplate>();
+    }
+    return _layouts[layoutIndex];
+}
+
+const LevelPackIndexEntry* LevelPackLoader::findEntry(int levelId) const
+{
+    if (!_header || levelId < (int)_header->firstLevelId) {
+        return nullptr;
+    }
+    
+    uint32_t slot = (uint32_t)levelId - _header->firstLevelId;
+    if (slot >= _header->levelCount) {
+        return nullptr;
+    }
+    
+    const LevelPackIndexEntry* entry = _index + slot;
+    if (entry->mainCount == 0 && entry->bottomCount == 0 && entry->reserveCount == 0) {
+        return nullptr;
+    }
+    return entry;
+}
+
+bool LevelPackLoader::validate() const
+{
+    if (_size < sizeof(LevelPackHeader)) {
+        return false;
+    }
+    
+    const LevelPackHeader* header = reinterpret_cast<const LevelPackHeader*>(_data);
+    if (std::memcmp(header->magic, LEVEL_PACK_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != LEVEL_PACK_VERSION ||
+        header->byteOrderMark != LEVEL_PACK_BYTE_ORDER_MARK) {
+        return false;
+    }
+    
+    // 用64位计算，避免伪造的数量导致溢出
+    uint64_t expectedSize = sizeof(LevelPackHeader) +
+                            (uint64_t)header->layoutCount * sizeof(LevelPackLayoutEntry) +
+                            (uint64_t)header->slotCount * sizeof(LevelPackSlotRecord) +
+                            (uint64_t)header->levelCount * sizeof(LevelPackIndexEntry) +
+                            (uint64_t)header->cardCount * sizeof(LevelPackCardRecord) +
+                            (uint64_t)header->slotCardCount * sizeof(LevelPackSlotCardRecord);
+    if (expectedSize != _size) {
+        return false;
+    }
+    
+    const LevelPackLayoutEntry* layouts = reinterpret_cast<const LevelPackLayoutEntry*>(_data + sizeof(LevelPackHeader));
+    for (uint32_t i = 0; i < header->layoutCount; ++i) {
+        if (std::memchr(layouts[i].name, '\0', sizeof(layouts[i].name)) == nullptr ||
+            layouts[i].slotCount > (uint32_t)LayoutTemplate::MAX_SLOTS ||
+            (uint64_t)layouts[i].firstSlot + layouts[i].slotCount > header->slotCount) {
+            return false;
+        }
+    }
+    
+    // 逐项检查索引不越界，之后读取时无需再检查索引（卡位序号在加载关卡时检查）
+    const LevelPackIndexEntry* index = reinterpret_cast<const LevelPackIndexEntry*>(
+        reinterpret_cast<const LevelPackSlotRecord*>(layouts + header->layoutCount) + header->slotCount);
+    for (uint32_t i = 0; i < header->levelCount; ++i) {
+        const LevelPackIndexEntry& entry = index[i];
+        if (entry.layout > header->layoutCount ||
+            (uint64_t)entry.mainCount + entry.bottomCount + entry.reserveCount > (uint64_t)LevelConfig::MAX_CARD_COUNT) {
+            return false;
+        }
+        uint64_t end = (uint64_t)entry.firstCard + entry.bottomCount + entry.reserveCount;
+        if (entry.layout != 0) {
+            if ((uint64_t)entry.firstSlotCard + entry.mainCount > header->slotCardCount) {
+                return false;
+            }
+        } else {
+            end += entry.mainCount;
+        }
+        if (end > header->cardCount) {
+            return false;
+        }
+    }
+    
+    // 面值与花色在加载关卡时不再检查，逐张确认在范围内
+    const LevelPackCardRecord* cards = reinterpret_cast<const LevelPackCardRecord*>(index + header->levelCount);
+    for (uint32_t i = 0; i < header->cardCount; ++i) {
+        if (!CardUtils::isValidCard((CardFaceType)cards[i].face, (CardSuitType)cards[i].suit)) {
+            return false;
+        }
+    }
+    const LevelPackSlotCardRecord* slotCards = reinterpret_cast<const LevelPackSlotCardRecord*>(cards + header->cardCount);
+    for (uint32_t i = 0; i < header->slotCardCount; ++i) {
+        if (!CardUtils::isValidCard((CardFaceType)slotCards[i].face, (CardSuitType)slotCards[i].suit)) {
+            return false;
+        }
+    }
+    return true;
+}
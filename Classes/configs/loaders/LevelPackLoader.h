@@ -0,0 +1,163 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __LEVEL_PACK_LOADER_H__
+#define __LEVEL_PACK_LOADER_H__
+
+#include "cocos2d.h"
+#include "LevelPackFormat.h"
+#include "../models/LevelConfig.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * 关卡包加载器
+ * 职责：映射编译好的二进制关卡包（见 LevelPackFormat.h），按关卡ID直接定位关卡数据，无需解析JSON
+ * 使用场景：关卡选择界面批量读取关卡、进入关卡时加载配置
+ * 包内的布局模板在打开时构建一次（含重叠关系），由引用它的所有关卡共享
+ * 文件可直接映射时使用 mmap；否则（如安卓APK内的资源）整体读入内存
+ */
+class LevelPackLoader
+{
+public:
+    /**
+     * 关卡只读视图，直接指向包内的卡牌记录
+     * 生命周期不超过所属的 LevelPackLoader
+     */
+    struct LevelView
+    {
+        const LevelPackCardRecord* mainPileCards;     ///< 主牌堆卡牌，使用模板时为nullptr
+        const LevelPackSlotCardRecord* mainPileSlotCards; ///< 主牌堆卡位卡牌，未使用模板时为nullptr
+        const LevelPackCardRecord* bottomPileCards;   ///< 底牌堆卡牌
+        const LevelPackCardRecord* reservePileCards;  ///< 备用牌堆卡牌
+        int mainPileCount;                            ///< 主牌堆卡牌数量
+        int bottomPileCount;                          ///< 底牌堆卡牌数量
+        int reservePileCount;                         ///< 备用牌堆卡牌数量
+        int layoutIndex;                              ///< 布局模板序号，-1表示未使用模板
+    };
+    
+    /**
+     * 构造函数
+     */
+    LevelPackLoader();
+    
+    /**
+     * 析构函数
+     */
+    ~LevelPackLoader();
+    
+    /**
+     * 打开关卡包
+     * 会校验文件头、索引和卡牌记录区是否完整
+     * @param filePath 关卡包路径（经 FileUtils 解析）
+     * @return 是否成功
+     */
+    bool open(const std::string& filePath);
+    
+    /**
+     * 关闭关卡包，释放映射
+     */
+    void close();
+    
+    /**
+     * 是否已打开
+     * @return 是否已打开
+     */
+    bool isOpen() const { return _data != nullptr; }
+    
+    /**
+     * 检查关卡是否存在
+     * @param levelId 关卡ID
+     * @return 是否存在
+     */
+    bool hasLevel(int levelId) const;
+    
+    /**
+     * 获取关卡只读视图
+     * @param levelId 关卡ID
+     * @param view 输出视图
+     * @return 关卡是否存在
+     */
+    bool getLevelView(int levelId, LevelView& view) const;
+    
+    /**
+     * 获取包内布局模板数量
+     * @return 模板数量
+     */
+    int getLayoutCount() const { return (int)_layouts.size(); }
+    
+    /**
+     * 获取包内布局模板
+     * @param layoutIndex 模板序号
+     * @return 模板，序号无效时为空
+     */
+    std::shared_ptr<const LayoutTemplate> getLayout(int layoutIndex) const;
+    
+    /**
+     * 加载关卡配置
+     * 使用模板的关卡会带上模板引用和每张主牌堆卡牌的卡位
+     * @param levelId 关卡ID
+     * @return 关卡配置对象，调用者负责释放；关卡不存在返回nullptr
+     */
+    LevelConfig* loadLevelConfig(int levelId) const;
+    
+    /**
+     * 将关卡配置编译为关卡包数据
+     * 关卡ID可以不连续，空缺的ID在索引中记为空项
+     * 主牌堆全部位于模板卡位上的关卡引用其模板；未引用模板但主牌堆位置与其他关卡完全相同的关卡
+     * 共用一份自动生成的模板（ID为 "auto-N"）
+     * @param levels 关卡ID与配置，按关卡ID升序
+     * @param output 输出的关卡包数据
+     * @return 是否成功（关卡ID重复、单个牌堆超过65535张、同名模板位置不一致时失败）
+     */
+    static bool buildPack(const std::vector<std::pair<int, const LevelConfig*>>& levels, std::string& output);
+
+private:
+    /**
+     * 获取关卡索引项
+     * @param levelId 关卡ID
+     * @return 索引项，不存在返回nullptr
+     */
+    const LevelPackIndexEntry* findEntry(int levelId) const;
+    
+    /**
+     * 校验已映射的数据
+     * @return 数据是否完整有效
+     */
+    bool validate() const;
+
+private:
+    const unsigned char* _data;             ///< 关卡包数据起始地址
+    size_t _size;                           ///< 关卡包数据长度
+    void* _mappedAddress;                   ///< mmap 映射地址，未映射为nullptr
+    std::vector<unsigned char> _buffer;     ///< 无法映射时读入的数据
+    const LevelPackHeader* _header;         ///< 文件头
+    const LevelPackIndexEntry* _index;      ///< 索引区
+    const LevelPackCardRecord* _cards;      ///< 卡牌记录区
+    const LevelPackSlotCardRecord* _slotCards;  ///< 卡位卡牌区
+    std::vector<std::shared_ptr<const LayoutTemplate>> _layouts;  ///< 包内布局模板
+};
+
+#endif // __LEVEL_PACK_LOADER_H__
@@ -0,0 +1,66 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LayoutTemplate.h"
+#include <cmath>
+
+LayoutTemplate::LayoutTemplate(const std::string& name, const std::vector<CoreVec2>& positions,
+                               const CoreSize& cardSize)
+    : _name(name)
+    , _positions(positions)
+{
+    if (_positions.size() > (size_t)MAX_SLOTS) {
+        _positions.resize(MAX_SLOTS);
+    }
+    
+    _overlapMasks.assign(_positions.size(), 0);
+    for (size_t i = 0; i < _positions.size(); ++i) {
+        for (size_t j = i + 1; j < _positions.size(); ++j) {
+            if (std::fabs(_positions[i].x - _positions[j].x) < cardSize.width &&
+                std::fabs(_positions[i].y - _positions[j].y) < cardSize.height) {
+                _overlapMasks[i] |= uint64_t(1) << j;
+                _overlapMasks[j] |= uint64_t(1) << i;
+            }
+        }
+    }
+}
+
+int LayoutTemplate::countOverlapPairs(uint64_t occupiedSlots) const
+{
+    int pairs = 0;
+    for (int slot = 0; slot < getSlotCount(); ++slot) {
+        if (occupiedSlots & (uint64_t(1) << slot)) {
+            uint64_t covering = getCoveringMask(slot) & occupiedSlots;
+            for (; covering; covering &= covering - 1) {
+                ++pairs;
+            }
+        }
+    }
+    return pairs;
+}
+
+uint64_t LayoutTemplate::getAllSlotsMask() const
+{
+    return _positions.size() >= (size_t)MAX_SLOTS ? ~uint64_t(0) : (uint64_t(1) << _positions.size()) - 1;
+}
@@ -0,0 +1,119 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __LAYOUT_TEMPLATE_H__
+#define __LAYOUT_TEMPLATE_H__
+
+#include "../../core/CoreTypes.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 布局模板类
+ * 职责：保存一组具名的主牌堆卡位（位置表），并在构造时一次性预计算卡位之间的重叠关系
+ * 使用场景：多个关卡共用同一几何布局时，关卡文件只引用模板ID和卡位序号；
+ *          重叠与遮挡关系按模板计算一次，供所有引用它的关卡共享
+ * 模板创建后不可修改，可在多个线程间共享
+ */
+class LayoutTemplate
+{
+public:
+    static const int MAX_SLOTS = 64;            ///< 卡位数量上限（重叠关系以64位掩码表示）
+    
+    /**
+     * 构造函数
+     * @param name 模板ID
+     * @param positions 卡位位置，数量超过 MAX_SLOTS 的部分被截断
+     * @param cardSize 卡牌尺寸，用于计算重叠
+     */
+    LayoutTemplate(const std::string& name, const std::vector<CoreVec2>& positions, const CoreSize& cardSize);
+    
+    /**
+     * 获取模板ID
+     * @return 模板ID
+     */
+    const std::string& getName() const { return _name; }
+    
+    /**
+     * 获取卡位数量
+     * @return 卡位数量
+     */
+    int getSlotCount() const { return (int)_positions.size(); }
+    
+    /**
+     * 获取卡位位置
+     * @param slot 卡位序号，须在 [0, getSlotCount()) 内
+     * @return 卡位位置
+     */
+    const CoreVec2& getSlotPosition(int slot) const { return _positions[slot]; }
+    
+    /**
+     * 获取全部卡位位置
+     * @return 卡位位置列表
+     */
+    const std::vector<CoreVec2>& getPositions() const { return _positions; }
+    
+    /**
+     * 获取与卡位重叠的其他卡位
+     * @param slot 卡位序号
+     * @return 卡位掩码，第i位表示与卡位i重叠
+     */
+    uint64_t getOverlapMask(int slot) const { return _overlapMasks[slot]; }
+    
+    /**
+     * 获取压在卡位上方的卡位（序号更大者后绘制，位于上层）
+     * @param slot 卡位序号
+     * @return 卡位掩码
+     */
+    uint64_t getCoveringMask(int slot) const { return _overlapMasks[slot] & ~((uint64_t(2) << slot) - 1); }
+    
+    /**
+     * 卡位在给定占用情况下是否未被遮挡
+     * @param slot 卡位序号
+     * @param occupiedSlots 仍有卡牌的卡位掩码
+     * @return 是否未被遮挡
+     */
+    bool isSlotUncovered(int slot, uint64_t occupiedSlots) const { return (getCoveringMask(slot) & occupiedSlots) == 0; }
+    
+    /**
+     * 统计给定卡位集合中相互重叠的卡位对数
+     * @param occupiedSlots 卡位掩码
+     * @return 重叠对数
+     */
+    int countOverlapPairs(uint64_t occupiedSlots) const;
+    
+    /**
+     * 获取卡位全集掩码
+     * @return 所有卡位对应的掩码
+     */
+    uint64_t getAllSlotsMask() const;
+
+private:
+    std::string _name;                      ///< 模板ID
+    std::vector<CoreVec2> _positions;       ///< 卡位位置
+    std::vector<uint64_t> _overlapMasks;    ///< 每个卡位的重叠卡位掩码
+};
+
+#endif // __LAYOUT_TEMPLATE_H__
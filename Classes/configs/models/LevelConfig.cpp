@@ -24,6 +24,8 @@
 
 #include "LevelConfig.h"
 
+const int LevelConfig::MAX_CARD_COUNT;
+
 LevelConfig::LevelConfig()
 {
 }
@@ -37,6 +39,20 @@ void LevelConfig::clear()
     _mainPileCards.clear();
     _bottomPileCards.clear();
     _reservePileCards.clear();
+    _layout.reset();
+}
+
+bool LevelConfig::isFullySlotted() const
+{
+    if (!_layout) {
+        return false;
+    }
+    for (const auto& card : _mainPileCards) {
+        if (card.slot < 0) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool LevelConfig::isValid() const
@@ -46,6 +62,11 @@ bool LevelConfig::isValid() const
         return false;
     }
     
+    // 检查卡牌总数不超过撤销快照的容量
+    if (_mainPileCards.size() + _bottomPileCards.size() + _reservePileCards.size() > (size_t)MAX_CARD_COUNT) {
+        return false;
+    }
+    
     // 检查主牌堆卡牌配置的有效性
     for (const auto& card : _mainPileCards) {
         if (card.cardFace < 0 || card.cardFace > 12 || 
@@ -54,6 +75,18 @@ bool LevelConfig::isValid() const
         }
     }
     
+    // 检查卡位：须有模板、在范围内且不重复占用
+    uint64_t usedSlots = 0;
+    for (const auto& card : _mainPileCards) {
+        if (card.slot < 0) {
+            continue;
+        }
+        if (!_layout || card.slot >= _layout->getSlotCount() || (usedSlots & (uint64_t(1) << card.slot))) {
+            return false;
+        }
+        usedSlots |= uint64_t(1) << card.slot;
+    }
+    
     // 检查底牌堆卡牌配置的有效性
     for (const auto& card : _bottomPileCards) {
         if (card.cardFace < 0 || card.cardFace > 12 || 
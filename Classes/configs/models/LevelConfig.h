@@ -25,7 +25,9 @@
 #ifndef __LEVEL_CONFIG_H__
 #define __LEVEL_CONFIG_H__
 
-#include "cocos2d.h"
+#include "../../core/CoreTypes.h"
+#include "LayoutTemplate.h"
+#include <memory>
 #include <vector>
 
 /**
@@ -36,6 +38,11 @@
 class LevelConfig
 {
 public:
+    /**
+     * 三个牌堆合计的卡牌数量上限，撤销快照按此容量预分配
+     */
+    static const int MAX_CARD_COUNT = 64;
+    
     /**
      * 卡牌配置结构
      * 存储单张卡牌的配置信息
@@ -44,11 +51,12 @@ public:
     {
         int cardFace;           ///< 卡牌面值 (0-12: A,2,3,4,5,6,7,8,9,10,J,Q,K)
         int cardSuit;           ///< 卡牌花色 (0-3: 梅花,方块,红桃,黑桃)
-        cocos2d::Vec2 position; ///< 卡牌位置
+        CoreVec2 position;      ///< 卡牌位置
+        int slot;               ///< 所在布局模板卡位，-1表示位置由关卡直接给出
         
-        CardConfig() : cardFace(0), cardSuit(0) {}
-        CardConfig(int face, int suit, const cocos2d::Vec2& pos) 
-            : cardFace(face), cardSuit(suit), position(pos) {}
+        CardConfig() : cardFace(0), cardSuit(0), slot(-1) {}
+        CardConfig(int face, int suit, const CoreVec2& pos, int slotIndex = -1)
+            : cardFace(face), cardSuit(suit), position(pos), slot(slotIndex) {}
     };
     
     /**
@@ -115,6 +123,25 @@ public:
      */
     void addReservePileCard(const CardConfig& card) { _reservePileCards.push_back(card); }
     
+    /**
+     * 获取布局模板
+     * @return 主牌堆引用的布局模板，未使用模板时为空
+     */
+    const std::shared_ptr<const LayoutTemplate>& getLayout() const { return _layout; }
+    
+    /**
+     * 设置布局模板
+     * 主牌堆中 slot >= 0 的卡牌位置须与模板卡位一致
+     * @param layout 布局模板
+     */
+    void setLayout(const std::shared_ptr<const LayoutTemplate>& layout) { _layout = layout; }
+    
+    /**
+     * 主牌堆是否全部位于布局模板卡位上
+     * @return 有模板且每张主牌堆卡牌都有卡位时返回true
+     */
+    bool isFullySlotted() const;
+    
     /**
      * 清空所有配置
      */
@@ -130,6 +157,7 @@ private:
     std::vector<CardConfig> _mainPileCards;      ///< 主牌堆卡牌配置
     std::vector<CardConfig> _bottomPileCards;    ///< 底牌堆卡牌配置
     std::vector<CardConfig> _reservePileCards;   ///< 备用牌堆卡牌配置
+    std::shared_ptr<const LayoutTemplate> _layout; ///< 主牌堆布局模板
 };
 
 #endif // __LEVEL_CONFIG_H__
@@ -23,8 +23,11 @@
  ****************************************************************************/
 
 #include "GameController.h"
-#include "../configs/loaders/LevelConfigLoader.h"
+#include "../managers/LevelConfigCache.h"
 #include "../services/GameModelFromLevelGenerator.h"
+#include "../services/GameModelAsyncLoader.h"
+#include <cstdio>
+#include <cstdlib>
 
 GameController::GameController()
     : _parent(nullptr)
@@ -33,6 +36,8 @@ GameController::GameController()
     , _undoManager(nullptr)
     , _playFieldController(nullptr)
     , _stackController(nullptr)
+    , _loadRequestId(0)
+    , _lifetimeToken(std::make_shared<char>(0))
 {
 }
 
@@ -85,21 +90,63 @@ bool GameController::init(cocos2d::Node* parent)
 
 bool GameController::startGame(const std::string& levelId)
 {
-    // 加载关卡配置
-    LevelConfig* levelConfig = LevelConfigLoader::loadLevelConfig(levelId);
+    // 加载关卡配置（重玩和已预取的下一关直接命中缓存）
+    LevelConfigCache::LevelConfigHandle levelConfig = LevelConfigCache::getInstance()->getLevelConfig(levelId);
     if (!levelConfig) {
         cocos2d::log("GameController: Failed to load level config for level %s", levelId.c_str());
         return false;
     }
     
     // 生成游戏模型
-    _gameModel = GameModelFromLevelGenerator::generateGameModel(levelConfig);
-    if (!_gameModel) {
+    GameModel* gameModel = GameModelFromLevelGenerator::generateGameModel(levelConfig.get());
+    if (!gameModel) {
         cocos2d::log("GameController: Failed to generate game model");
-        delete levelConfig;
         return false;
     }
     
+    // 使进行中的异步加载失效
+    ++_loadRequestId;
+    applyGameModel(levelId, gameModel);
+    return true;
+}
+
+void GameController::startGameAsync(const std::string& levelId, StartGameCallback callback)
+{
+    if (_gameView) {
+        _gameView->setLoading(true);
+    }
+    
+    int requestId = ++_loadRequestId;
+    std::weak_ptr<char> lifetime = _lifetimeToken;
+    GameModelAsyncLoader::loadGameModel(levelId, [this, lifetime, requestId, levelId, callback](GameModel* gameModel) {
+        // 控制器已销毁或已有更新的加载请求：丢弃结果
+        if (lifetime.expired() || requestId != _loadRequestId) {
+            delete gameModel;
+            return;
+        }
+        
+        if (gameModel) {
+            applyGameModel(levelId, gameModel);
+        } else {
+            cocos2d::log("GameController: Failed to load level %s", levelId.c_str());
+            if (_gameView) {
+                _gameView->setLoading(false);
+            }
+        }
+        if (callback) {
+            callback(gameModel != nullptr);
+        }
+    });
+}
+
+void GameController::applyGameModel(const std::string& levelId, GameModel* gameModel)
+{
+    // 替换上一局的模型
+    delete _gameModel;
+    _gameModel = gameModel;
+    _levelId = levelId;
+    _undoManager->clearAllRecords();
+    
     // 初始化撤销管理器
     _undoManager->init(_gameModel, [this](bool success) {
         onUndoComplete(success);
@@ -110,6 +157,9 @@ bool GameController::startGame(const std::string& levelId)
     _stackController->init(_gameModel, _undoManager);
     
     // 更新游戏视图
+    if (_gameView) {
+        _gameView->setLoading(false);
+    }
     updateGameView();
     
     // 播放入场动画
@@ -117,10 +167,42 @@ bool GameController::startGame(const std::string& levelId)
         _gameView->playEnterAnimation();
     }
     
-    delete levelConfig;
+    // 玩当前关时在后台预取下一关
+    std::string nextLevelId = getNextLevelId(levelId);
+    if (!nextLevelId.empty()) {
+        LevelConfigCache::getInstance()->prefetch(nextLevelId);
+    }
+}
+
+bool GameController::restartGame()
+{
+    if (_levelId.empty()) {
+        return false;
+    }
+    startGameAsync(_levelId);
     return true;
 }
 
+bool GameController::startNextLevel()
+{
+    std::string nextLevelId = getNextLevelId(_levelId);
+    if (nextLevelId.empty()) {
+        return false;
+    }
+    startGameAsync(nextLevelId);
+    return true;
+}
+
+std::string GameController::getNextLevelId(const std::string& levelId)
+{
+    if (levelId.empty() || levelId.size() > 9 || levelId.find_first_not_of("0123456789") != std::string::npos) {
+        return "";
+    }
+    char nextLevelId[16];
+    snprintf(nextLevelId, sizeof(nextLevelId), "%d", std::atoi(levelId.c_str()) + 1);
+    return nextLevelId;
+}
+
 bool GameController::handleCardClick(int cardId)
 {
     if (!_gameModel) {
@@ -153,6 +235,24 @@ bool GameController::handleUndo()
     return _undoManager->executeUndo();
 }
 
+bool GameController::handleUndoSteps(int count)
+{
+    if (!_undoManager) {
+        return false;
+    }
+    
+    return _undoManager->undoN(count);
+}
+
+bool GameController::handleUndoTo(int moveIndex)
+{
+    if (!_undoManager) {
+        return false;
+    }
+    
+    return _undoManager->undoTo(moveIndex);
+}
+
 bool GameController::isGameOver() const
 {
     return _gameModel ? _gameModel->isGameOver() : false;
@@ -198,8 +298,21 @@ void GameController::onStackCardClicked(int cardId)
 
 void GameController::onUndoComplete(bool success)
 {
-    if (success) {
-        updateGameView();
+    if (!success) {
+        return;
+    }
+    
+    // 增量同步视图，只对净变化的卡牌播放动画：从撤销前的位置移动到撤销后的位置
+    if (_gameView && _undoManager) {
+        _gameView->syncCardViews();
+        _gameView->setUndoButtonEnabled(_undoManager->hasUndoableAction());
+        for (const auto& delta : _undoManager->getLastUndoDeltas()) {
+            CardView* cardView = _gameView->getCardView(delta.cardId);
+            if (cardView) {
+                cardView->setPosition(delta.fromPosition);
+                _gameView->playUndoAnimation(delta.cardId, delta.toPosition);
+            }
+        }
     }
 }
 
@@ -32,6 +32,8 @@
 #include "../managers/UndoManager.h"
 #include "../controllers/PlayFieldController.h"
 #include "../controllers/StackController.h"
+#include <functional>
+#include <memory>
 #include <string>
 
 /**
@@ -66,6 +68,33 @@ public:
      */
     bool startGame(const std::string& levelId);
     
+    /**
+     * 开始游戏加载完成回调
+     * @param success 是否成功开始游戏
+     */
+    typedef std::function<void(bool success)> StartGameCallback;
+    
+    /**
+     * 异步开始游戏
+     * 关卡在后台线程加载和生成，期间视图显示加载状态，完成后在主线程切换到新对局
+     * 连续发起多次时只有最后一次生效
+     * @param levelId 关卡ID
+     * @param callback 完成回调，可为空
+     */
+    void startGameAsync(const std::string& levelId, StartGameCallback callback = nullptr);
+    
+    /**
+     * 重新开始当前关卡（异步，通常直接命中关卡缓存）
+     * @return 是否已发起
+     */
+    bool restartGame();
+    
+    /**
+     * 进入下一关（异步，关卡ID为数字时有效）
+     * @return 是否已发起
+     */
+    bool startNextLevel();
+    
     /**
      * 处理卡牌点击事件
      * @param cardId 卡牌ID
@@ -79,6 +108,20 @@ public:
      */
     bool handleUndo();
     
+    /**
+     * 连续撤销多步操作，视图只刷新一次
+     * @param count 撤销步数
+     * @return 是否处理成功
+     */
+    bool handleUndoSteps(int count);
+    
+    /**
+     * 撤销到指定步数，视图只刷新一次
+     * @param moveIndex 撤销后保留的操作数量
+     * @return 是否处理成功
+     */
+    bool handleUndoTo(int moveIndex);
+    
     /**
      * 获取游戏视图
      * @return 游戏视图
@@ -104,6 +147,9 @@ private:
     UndoManager* _undoManager;          ///< 撤销管理器
     PlayFieldController* _playFieldController; ///< 桌面牌区控制器
     StackController* _stackController;  ///< 手牌区控制器
+    std::string _levelId;               ///< 当前关卡ID
+    int _loadRequestId;                 ///< 最近一次异步加载的序号
+    std::shared_ptr<char> _lifetimeToken; ///< 异步回调通过其弱引用判断控制器是否仍存在
     
     /**
      * 初始化子控制器
@@ -117,6 +163,20 @@ private:
      */
     bool initGameView();
     
+    /**
+     * 获取下一关的关卡ID
+     * @param levelId 当前关卡ID
+     * @return 下一关ID，非数字ID返回空字符串
+     */
+    static std::string getNextLevelId(const std::string& levelId);
+    
+    /**
+     * 切换到新生成的对局
+     * @param levelId 关卡ID
+     * @param gameModel 游戏模型，所有权转移给控制器
+     */
+    void applyGameModel(const std::string& levelId, GameModel* gameModel);
+    
     /**
      * 桌面卡牌点击事件处理
      * @param cardId 卡牌ID
@@ -0,0 +1,158 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "GameSession.h"
+
+GameSession::GameSession()
+    : _gameModel(nullptr)
+{
+}
+
+GameSession::~GameSession()
+{
+}
+
+bool GameSession::start(GameModel* gameModel)
+{
+    _stateManager.clear();
+    _gameModel = _stateManager.saveState(gameModel, GAT_INIT, -1, -1) ? gameModel : nullptr;
+    return _gameModel != nullptr;
+}
+
+bool GameSession::canClick(int cardId) const
+{
+    GameMoveType type;
+    return findMove(cardId, type);
+}
+
+void GameSession::getClickableCards(std::vector<int>& cardIds) const
+{
+    cardIds.clear();
+    MoveGenerator::Board board;
+    if (!MoveGenerator::buildBoard(_gameModel, board)) {
+        return;
+    }
+    MoveGenerator::MoveList moves;
+    MoveGenerator::generateMoves(board, moves);
+    for (int i = 0; i < moves.count; ++i) {
+        cardIds.push_back(board.cardIds[moves.moves[i].card]);
+    }
+}
+
+bool GameSession::handleCardClick(int cardId)
+{
+    GameMoveType type;
+    if (!findMove(cardId, type)) {
+        return false;
+    }
+    
+    // 在修改模型前保存底部卡牌ID；卡牌数只减不增，开始时能保存快照则之后的保存都会成功
+    int bottomCardId = _gameModel->getBottomPileTopCard()->getCardId();
+    if (type == GMT_MAIN_TO_BOTTOM) {
+        applyMainToBottom(cardId);
+        _stateManager.saveState(_gameModel, GAT_MAIN_TO_BOTTOM, cardId, bottomCardId);
+    } else {
+        applyReserveToBottom(cardId);
+        _stateManager.saveState(_gameModel, GAT_RESERVE_TO_BOTTOM, cardId, bottomCardId);
+    }
+    return true;
+}
+
+bool GameSession::handleUndo()
+{
+    return _gameModel && _stateManager.undo(_gameModel);
+}
+
+bool GameSession::isWon() const
+{
+    return _gameModel && _gameModel->getMainPileCards().empty();
+}
+
+bool GameSession::findMove(int cardId, GameMoveType& type) const
+{
+    MoveGenerator::Board board;
+    MoveGenerator::Move move;
+    if (!MoveGenerator::buildBoard(_gameModel, board) || !MoveGenerator::findMove(board, cardId, move)) {
+        return false;
+    }
+    type = (GameMoveType)move.type;
+    return true;
+}
+
+void GameSession::applyMainToBottom(int cardId)
+{
+    CardModel* mainPileCard = _gameModel->findMainPileCard(cardId);
+    CardModel* bottomCard = _gameModel->getBottomPileTopCard();
+    if (!mainPileCard || !bottomCard) {
+        return;
+    }
+    
+    // 先保存底部卡牌的位置
+    CoreVec2 bottomCardPos = bottomCard->getPosition();
+    
+    // 移除主牌堆的卡牌
+    _gameModel->removeMainPileCard(cardId);
+    
+    // 替换底牌堆的顶部卡牌
+    auto& bottomPileCards = _gameModel->getBottomPileCards();
+    int topIndex = _gameModel->getBottomPileTopIndex();
+    if (topIndex >= 0 && topIndex < (int)bottomPileCards.size()) {
+        // 删除原来的顶部卡牌
+        delete bottomPileCards[topIndex];
+        // 设置新的顶部卡牌
+        bottomPileCards[topIndex] = mainPileCard;
+        mainPileCard->setPosition(bottomCardPos);
+    }
+}
+
+void GameSession::applyReserveToBottom(int cardId)
+{
+    CardModel* reservePileCard = _gameModel->findReservePileCard(cardId);
+    CardModel* bottomCard = _gameModel->getBottomPileTopCard();
+    if (!reservePileCard || !bottomCard) {
+        return;
+    }
+    
+    CoreVec2 bottomCardPos = bottomCard->getPosition();
+    CoreVec2 reserveCardPos = reservePileCard->getPosition();
+    
+    // 将原来的底部卡牌放到被点击的备用牌位置
+    auto& reservePileCards = _gameModel->getReservePileCards();
+    for (size_t i = 0; i < reservePileCards.size(); ++i) {
+        if (reservePileCards[i] == reservePileCard) {
+            bottomCard->setPosition(reserveCardPos);
+            bottomCard->setClickable(true);
+            reservePileCards[i] = bottomCard;
+            break;
+        }
+    }
+    
+    // 替换底牌堆的顶部卡牌
+    auto& bottomPileCards = _gameModel->getBottomPileCards();
+    int topIndex = _gameModel->getBottomPileTopIndex();
+    bottomPileCards[topIndex] = reservePileCard;
+    reservePileCard->setPosition(bottomCardPos);
+    reservePileCard->setClickable(false);
+}
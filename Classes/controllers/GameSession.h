@@ -0,0 +1,139 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __GAME_SESSION_H__
+#define __GAME_SESSION_H__
+
+#include "../models/GameModel.h"
+#include "../managers/GameStateManager.h"
+#include "../services/MoveGenerator.h"
+#include <vector>
+
+/**
+ * 对局会话控制器
+ * 职责：持有一局游戏的状态历史，按 TestScene 的规则处理卡牌点击与撤销
+ * 使用场景：TestScene 的规则层（动画结束后调用），以及无界面的机器人对局与批量模拟
+ *
+ * 规则：主牌与底牌顶部面值相差1即可接走，原顶部卡牌被移除；备用牌可与底牌顶部无条件交换。
+ * 点击是否合法由 MoveGenerator 判断。
+ * 每次操作成功后保存一份状态快照，撤销即恢复上一份快照。
+ */
+class GameSession
+{
+public:
+    /**
+     * 构造函数
+     */
+    GameSession();
+    
+    /**
+     * 析构函数
+     */
+    ~GameSession();
+    
+    /**
+     * 开始一局：清空状态历史并保存初始状态
+     * 初始状态无法保存（模型为空或卡牌数超过快照容量）时不开始，会话保持未开始状态
+     * @param gameModel 游戏模型（不转移所有权，会话期间需保持有效）
+     * @return 是否已开始
+     */
+    bool start(GameModel* gameModel);
+    
+    /**
+     * 获取游戏模型
+     * @return 游戏模型，未开始时为nullptr
+     */
+    GameModel* getGameModel() const { return _gameModel; }
+    
+    /**
+     * 检查点击卡牌是否会产生一次操作
+     * @param cardId 卡牌ID
+     * @return 是否可点击
+     */
+    bool canClick(int cardId) const;
+    
+    /**
+     * 列出当前可点击的卡牌
+     * @param cardIds 输出卡牌ID（先主牌、后备用牌）
+     */
+    void getClickableCards(std::vector<int>& cardIds) const;
+    
+    /**
+     * 处理卡牌点击：合法时修改模型并保存状态
+     * @param cardId 卡牌ID
+     * @return 是否执行了操作
+     */
+    bool handleCardClick(int cardId);
+    
+    /**
+     * 撤销上一步操作
+     * @return 是否成功撤销
+     */
+    bool handleUndo();
+    
+    /**
+     * 检查是否可以撤销
+     * @return 是否可以撤销
+     */
+    bool canUndo() const { return _stateManager.canUndo(); }
+    
+    /**
+     * 检查是否已获胜（主牌堆清空）
+     * @return 是否获胜
+     */
+    bool isWon() const;
+    
+    /**
+     * 获取状态管理器（导出历史、读取撤销时的卡牌位置变化）
+     * @return 状态管理器
+     */
+    GameStateManager& getStateManager() { return _stateManager; }
+
+private:
+    /**
+     * 查找点击卡牌对应的合法操作
+     * @param cardId 卡牌ID
+     * @param type 输出操作类型
+     * @return 点击是否合法
+     */
+    bool findMove(int cardId, GameMoveType& type) const;
+    
+    /**
+     * 主牌替换底牌顶部，原顶部卡牌被释放（只修改模型，不做合法性检查）
+     * @param cardId 主牌ID
+     */
+    void applyMainToBottom(int cardId);
+    
+    /**
+     * 备用牌与底牌顶部交换（只修改模型）
+     * @param cardId 备用牌ID
+     */
+    void applyReserveToBottom(int cardId);
+    
+    GameModel* _gameModel;              ///< 游戏模型
+    GameStateManager _stateManager;     ///< 状态管理器
+};
+
+#endif // __GAME_SESSION_H__
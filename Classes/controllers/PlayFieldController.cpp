@@ -111,7 +111,7 @@ bool PlayFieldController::executeMoveToHand(int playfieldCardId)
     // 执行移动：交换卡牌数据
     CardFaceType tempFace = playfieldCard->getFace();
     CardSuitType tempSuit = playfieldCard->getSuit();
-    cocos2d::Vec2 tempPos = playfieldCard->getPosition();
+    CoreVec2 tempPos = playfieldCard->getPosition();
     
     playfieldCard->setFace(handTopCard->getFace());
     playfieldCard->setSuit(handTopCard->getSuit());
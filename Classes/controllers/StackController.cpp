@@ -23,7 +23,7 @@
  ****************************************************************************/
 
 #include "StackController.h"
-USING_NS_CC;
+
 StackController::StackController()
     : _gameModel(nullptr)
     , _undoManager(nullptr)
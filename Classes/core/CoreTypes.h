@@ -0,0 +1,117 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CORE_TYPES_H__
+#define __CORE_TYPES_H__
+
+/**
+ * 规则核心基础类型
+ * 模型、规则服务与控制器（pokergame_core）只通过本文件使用位置、尺寸、颜色与日志，不直接依赖引擎：
+ * - 定义 POKERGAME_CORE_HEADLESS 时使用下面的精简实现，可脱离 cocos2d 单独编译（服务端模拟、单元测试、基准测试）
+ * - 否则（应用内）直接取 cocos2d 的对应类型，视图层传入的 cocos2d::Vec2 等无需转换
+ */
+
+#if defined(POKERGAME_CORE_HEADLESS)
+
+#include <cmath>
+#include <cstdio>
+
+/**
+ * 二维向量，只保留规则层用到的运算
+ */
+struct CoreVec2
+{
+    float x;    ///< X坐标
+    float y;    ///< Y坐标
+    
+    CoreVec2() : x(0.0f), y(0.0f) {}
+    CoreVec2(float xValue, float yValue) : x(xValue), y(yValue) {}
+    
+    bool operator==(const CoreVec2& other) const { return x == other.x && y == other.y; }
+    bool operator!=(const CoreVec2& other) const { return !(*this == other); }
+    CoreVec2 operator+(const CoreVec2& other) const { return CoreVec2(x + other.x, y + other.y); }
+    CoreVec2 operator-(const CoreVec2& other) const { return CoreVec2(x - other.x, y - other.y); }
+    CoreVec2 operator*(float scale) const { return CoreVec2(x * scale, y * scale); }
+    
+    /**
+     * 到另一点的距离
+     * @param other 另一点
+     * @return 距离
+     */
+    float distance(const CoreVec2& other) const { return std::sqrt((x - other.x) * (x - other.x) + (y - other.y) * (y - other.y)); }
+};
+
+/**
+ * 尺寸
+ */
+struct CoreSize
+{
+    float width;    ///< 宽
+    float height;   ///< 高
+    
+    CoreSize() : width(0.0f), height(0.0f) {}
+    CoreSize(float widthValue, float heightValue) : width(widthValue), height(heightValue) {}
+};
+
+/**
+ * RGB颜色
+ */
+struct CoreColor3B
+{
+    unsigned char r;    ///< 红
+    unsigned char g;    ///< 绿
+    unsigned char b;    ///< 蓝
+    
+    CoreColor3B() : r(0), g(0), b(0) {}
+    CoreColor3B(unsigned char red, unsigned char green, unsigned char blue) : r(red), g(green), b(blue) {}
+};
+
+/**
+ * 日志开关（默认开启），批量模拟前关闭可省去每步操作的日志开销；应在启动工作线程前设置
+ * @return 开关的引用
+ */
+inline bool& coreLogEnabled()
+{
+    static bool enabled = true;
+    return enabled;
+}
+
+/**
+ * 输出一行日志到标准错误
+ */
+#define CORE_LOG(...) (coreLogEnabled() ? (void)(std::fprintf(stderr, __VA_ARGS__), std::fputc('\n', stderr)) : (void)0)
+
+#else
+
+#include "cocos2d.h"
+
+typedef cocos2d::Vec2 CoreVec2;
+typedef cocos2d::Size CoreSize;
+typedef cocos2d::Color3B CoreColor3B;
+
+#define CORE_LOG(...) cocos2d::log(__VA_ARGS__)
+
+#endif
+
+#endif // __CORE_TYPES_H__
@@ -24,13 +24,23 @@
 
 #include "GameStateManager.h"
 #include "../models/CardModel.h"
+#include "../configs/models/LevelConfig.h"
 #include <algorithm>
 
-USING_NS_CC;
+static_assert(GameStateManager::MAX_SNAPSHOT_CARDS >= LevelConfig::MAX_CARD_COUNT,
+              "every valid level must fit in a state snapshot");
+
+const int GameStateManager::MAX_SNAPSHOT_CARDS;
+const size_t GameStateManager::MAX_STATES;
 
 GameStateManager::GameStateManager()
-    : _currentStateIndex(0)
+    : _stateHistory(MAX_STATES)
+    , _firstStateIndex(0)
+    , _stateCount(0)
+    , _currentStateIndex(0)
 {
+    _reusableCards.reserve(MAX_SNAPSHOT_CARDS);
+    _lastRestoreDeltas.reserve(MAX_SNAPSHOT_CARDS);
 }
 
 GameStateManager::~GameStateManager()
@@ -38,16 +48,45 @@ GameStateManager::~GameStateManager()
     clear();
 }
 
-void GameStateManager::saveState(GameModel* gameModel, const std::string& actionType, int sourceCardId, int targetCardId)
+bool GameStateManager::canSaveState(const GameModel* gameModel)
 {
-    if (!gameModel) return;
+    if (!gameModel) {
+        return false;
+    }
+    size_t cardCount = gameModel->getMainPileCards().size() + gameModel->getBottomPileCards().size() +
+                       gameModel->getReservePileCards().size();
+    return cardCount <= (size_t)MAX_SNAPSHOT_CARDS;
+}
+
+bool GameStateManager::saveState(GameModel* gameModel, GameActionType actionType, int sourceCardId, int targetCardId)
+{
+    if (!canSaveState(gameModel)) {
+        if (gameModel) {
+            CORE_LOG("GameStateManager: too many cards to snapshot (more than %d)", MAX_SNAPSHOT_CARDS);
+        }
+        return false;
+    }
     
-    GameStateSnapshot snapshot;
+    // 如果当前不在历史末尾，删除后面的状态
+    if (_stateCount > 0) {
+        _stateCount = _currentStateIndex + 1;
+    }
+    
+    // 状态池已满时覆盖最早的状态
+    if (_stateCount == MAX_STATES) {
+        _firstStateIndex = (_firstStateIndex + 1) % MAX_STATES;
+        --_stateCount;
+    }
+    
+    GameStateSnapshot& snapshot = getState(_stateCount);
     
-    // 深拷贝所有卡牌
-    snapshot.mainPileCards = cloneCardList(gameModel->getMainPileCards());
-    snapshot.bottomPileCards = cloneCardList(gameModel->getBottomPileCards());
-    snapshot.reservePileCards = cloneCardList(gameModel->getReservePileCards());
+    // 拷贝所有卡牌数据
+    CardSnapshot* cursor = snapshot.cards;
+    snapshot.mainPileCount = captureCardList(gameModel->getMainPileCards(), cursor);
+    cursor += snapshot.mainPileCount;
+    snapshot.bottomPileCount = captureCardList(gameModel->getBottomPileCards(), cursor);
+    cursor += snapshot.bottomPileCount;
+    snapshot.reservePileCount = captureCardList(gameModel->getReservePileCards(), cursor);
     
     // 保存索引
     snapshot.bottomPileTopIndex = gameModel->getBottomPileTopIndex();
@@ -58,34 +97,21 @@ void GameStateManager::saveState(GameModel* gameModel, const std::string& action
     snapshot.sourceCardId = sourceCardId;
     snapshot.targetCardId = targetCardId;
     
-    // 如果当前不在历史末尾，删除后面的状态
-    if (_currentStateIndex + 1 < _stateHistory.size()) {
-        _stateHistory.erase(_stateHistory.begin() + _currentStateIndex + 1, _stateHistory.end());
-    }
+    ++_stateCount;
+    _currentStateIndex = _stateCount - 1;
     
-    // 添加新状态
-    _stateHistory.push_back(snapshot);
-    _currentStateIndex = _stateHistory.size() - 1;
-    
-    // 限制状态数量
-    while (_stateHistory.size() > MAX_STATES) {
-        _stateHistory.erase(_stateHistory.begin());
-        if (_currentStateIndex > 0) {
-            _currentStateIndex--;
-        }
-    }
-    
-    cocos2d::log("Saved state: %s, source: %d, target: %d, current index: %zu, total states: %zu", 
-                 actionType.c_str(), sourceCardId, targetCardId, _currentStateIndex, _stateHistory.size());
+    CORE_LOG("Saved state: %s, source: %d, target: %d, current index: %zu, total states: %zu", 
+                 getActionTypeName(actionType), sourceCardId, targetCardId, _currentStateIndex, _stateCount);
+    return true;
 }
 
 bool GameStateManager::undo(GameModel* gameModel)
 {
-    cocos2d::log("Undo requested - canUndo: %s, current index: %zu, total states: %zu", 
-                 canUndo() ? "YES" : "NO", _currentStateIndex, _stateHistory.size());
+    CORE_LOG("Undo requested - canUndo: %s, current index: %zu, total states: %zu", 
+                 canUndo() ? "YES" : "NO", _currentStateIndex, _stateCount);
     
     if (!canUndo() || !gameModel) {
-        cocos2d::log("Undo failed - canUndo: %s, gameModel: %s", 
+        CORE_LOG("Undo failed - canUndo: %s, gameModel: %s", 
                      canUndo() ? "YES" : "NO", gameModel ? "OK" : "NULL");
         return false;
     }
@@ -93,29 +119,12 @@ bool GameStateManager::undo(GameModel* gameModel)
     // 移动到上一个状态
     _currentStateIndex--;
     
-    // 检查索引是否有效
-    if (_currentStateIndex >= _stateHistory.size()) {
-        cocos2d::log("Invalid state index: %zu, size: %zu", _currentStateIndex, _stateHistory.size());
-        return false;
-    }
-    
     // 恢复状态
-    const GameStateSnapshot& snapshot = _stateHistory[_currentStateIndex];
-    
-    // 清空当前卡牌
-    gameModel->clearAllCards();
+    const GameStateSnapshot& snapshot = getState(_currentStateIndex);
+    restoreSnapshot(gameModel, snapshot);
     
-    // 恢复卡牌列表
-    restoreCardList(gameModel->getMainPileCards(), snapshot.mainPileCards);
-    restoreCardList(gameModel->getBottomPileCards(), snapshot.bottomPileCards);
-    restoreCardList(gameModel->getReservePileCards(), snapshot.reservePileCards);
-    
-    // 恢复索引
-    gameModel->setBottomPileTopIndex(snapshot.bottomPileTopIndex);
-    gameModel->setReservePileTopIndex(snapshot.reservePileTopIndex);
-    
-    cocos2d::log("Undo to state: %s, source: %d, target: %d", 
-                 snapshot.actionType.c_str(), snapshot.sourceCardId, snapshot.targetCardId);
+    CORE_LOG("Undo to state: %s, source: %d, target: %d", 
+                 getActionTypeName(snapshot.actionType), snapshot.sourceCardId, snapshot.targetCardId);
     
     return true;
 }
@@ -129,29 +138,12 @@ bool GameStateManager::redo(GameModel* gameModel)
     // 移动到下一个状态
     _currentStateIndex++;
     
-    // 检查索引是否有效
-    if (_currentStateIndex >= _stateHistory.size()) {
-        cocos2d::log("Invalid state index in redo: %zu, size: %zu", _currentStateIndex, _stateHistory.size());
-        return false;
-    }
-    
     // 恢复状态
-    const GameStateSnapshot& snapshot = _stateHistory[_currentStateIndex];
+    const GameStateSnapshot& snapshot = getState(_currentStateIndex);
+    restoreSnapshot(gameModel, snapshot);
     
-    // 清空当前卡牌
-    gameModel->clearAllCards();
-    
-    // 恢复卡牌列表
-    restoreCardList(gameModel->getMainPileCards(), snapshot.mainPileCards);
-    restoreCardList(gameModel->getBottomPileCards(), snapshot.bottomPileCards);
-    restoreCardList(gameModel->getReservePileCards(), snapshot.reservePileCards);
-    
-    // 恢复索引
-    gameModel->setBottomPileTopIndex(snapshot.bottomPileTopIndex);
-    gameModel->setReservePileTopIndex(snapshot.reservePileTopIndex);
-    
-    cocos2d::log("Redo to state: %s, source: %d, target: %d", 
-                 snapshot.actionType.c_str(), snapshot.sourceCardId, snapshot.targetCardId);
+    CORE_LOG("Redo to state: %s, source: %d, target: %d", 
+                 getActionTypeName(snapshot.actionType), snapshot.sourceCardId, snapshot.targetCardId);
     
     return true;
 }
@@ -163,58 +155,147 @@ bool GameStateManager::canUndo() const
 
 bool GameStateManager::canRedo() const
 {
-    return _currentStateIndex < _stateHistory.size() - 1;
+    return _currentStateIndex + 1 < _stateCount;
 }
 
 void GameStateManager::clear()
 {
-    _stateHistory.clear();
+    _firstStateIndex = 0;
+    _stateCount = 0;
     _currentStateIndex = 0;
 }
 
 size_t GameStateManager::getStateCount() const
 {
-    return _stateHistory.size();
+    return _stateCount;
 }
 
-std::shared_ptr<CardModel> GameStateManager::cloneCard(const CardModel* card)
+bool GameStateManager::exportHistory(std::vector<int>& initialCardIds, std::vector<ActionRecord>& actions) const
 {
-    if (!card) return nullptr;
-    
-    auto clonedCard = std::make_shared<CardModel>(card->getFace(), card->getSuit(), card->getPosition());
-    clonedCard->setRevealed(card->isRevealed());
-    clonedCard->setClickable(card->isClickable());
+    initialCardIds.clear();
+    actions.clear();
+    if (_stateCount == 0 || getState(0).actionType != GAT_INIT) {
+        return false;
+    }
     
-    return clonedCard;
+    const GameStateSnapshot& initial = getState(0);
+    int cardCount = initial.mainPileCount + initial.bottomPileCount + initial.reservePileCount;
+    for (int i = 0; i < cardCount; ++i) {
+        initialCardIds.push_back(initial.cards[i].cardId);
+    }
+    for (size_t i = 1; i <= _currentStateIndex; ++i) {
+        const GameStateSnapshot& snapshot = getState(i);
+        ActionRecord action = { snapshot.actionType, snapshot.sourceCardId, snapshot.targetCardId };
+        actions.push_back(action);
+    }
+    return true;
 }
 
-std::vector<std::shared_ptr<CardModel>> GameStateManager::cloneCardList(const std::vector<CardModel*>& cards)
+const char* GameStateManager::getActionTypeName(GameActionType actionType)
 {
-    std::vector<std::shared_ptr<CardModel>> clonedCards;
-    clonedCards.reserve(cards.size());
-    
-    for (auto* card : cards) {
+    switch (actionType) {
+        case GAT_INIT:              return "init";
+        case GAT_MAIN_TO_BOTTOM:    return "main_to_bottom";
+        case GAT_RESERVE_TO_BOTTOM: return "reserve_to_bottom";
+        case GAT_DRAW_CARD:         return "draw_card";
+        default:                    return "none";
+    }
+}
+
+int GameStateManager::captureCardList(const std::vector<CardModel*>& cards, CardSnapshot* target)
+{
+    int count = 0;
+    for (const auto* card : cards) {
         if (card) {
-            clonedCards.push_back(cloneCard(card));
+            CardSnapshot& cardSnapshot = target[count++];
+            cardSnapshot.cardId = card->getCardId();
+            cardSnapshot.x = card->getPosition().x;
+            cardSnapshot.y = card->getPosition().y;
+            cardSnapshot.face = (int8_t)card->getFace();
+            cardSnapshot.suit = (int8_t)card->getSuit();
+            cardSnapshot.revealed = card->isRevealed();
+            cardSnapshot.clickable = card->isClickable();
         }
     }
-    
-    return clonedCards;
+    return count;
 }
 
-void GameStateManager::restoreCardList(std::vector<CardModel*>& targetCards, const std::vector<std::shared_ptr<CardModel>>& sourceCards)
+void GameStateManager::restoreCardList(std::vector<CardModel*>& targetCards, const CardSnapshot* sourceCards, int count)
 {
-    targetCards.clear();
-    targetCards.reserve(sourceCards.size());
+    targetCards.reserve(count);
     
-    for (const auto& card : sourceCards) {
-        if (card) {
+    for (int i = 0; i < count; ++i) {
+        const CardSnapshot& card = sourceCards[i];
+        CoreVec2 position(card.x, card.y);
+        
+        // 查找可复用的卡牌对象
+        CardModel* restoredCard = nullptr;
+        for (size_t j = 0; j < _reusableCards.size(); ++j) {
+            CardModel* candidate = _reusableCards[j];
+            if (candidate->getCardId() == card.cardId && candidate->getFace() == card.face &&
+                candidate->getSuit() == card.suit) {
+                restoredCard = candidate;
+                _reusableCards[j] = _reusableCards.back();
+                _reusableCards.pop_back();
+                break;
+            }
+        }
+        
+        if (restoredCard) {
+            if (restoredCard->getPosition() != position) {
+                CardDelta delta;
+                delta.cardId = card.cardId;
+                delta.fromPosition = restoredCard->getPosition();
+                delta.toPosition = position;
+                _lastRestoreDeltas.push_back(delta);
+            }
+            restoredCard->setPosition(position);
+        } else {
             // 创建新的CardModel对象
-            CardModel* newCard = new CardModel(card->getFace(), card->getSuit(), card->getPosition());
-            newCard->setCardId(card->getCardId());  // 设置CardId
-            newCard->setRevealed(card->isRevealed());
-            newCard->setClickable(card->isClickable());
-            targetCards.push_back(newCard);
+            restoredCard = new CardModel((CardFaceType)card.face, (CardSuitType)card.suit, position);
+            restoredCard->setCardId(card.cardId);  // 设置CardId
+        }
+        restoredCard->setRevealed(card.revealed);
+        restoredCard->setClickable(card.clickable);
+        targetCards.push_back(restoredCard);
+    }
+}
+
+void GameStateManager::restoreSnapshot(GameModel* gameModel, const GameStateSnapshot& snapshot)
+{
+    _lastRestoreDeltas.clear();
+    
+    // 取出当前所有卡牌，由快照决定哪些被复用
+    _reusableCards.clear();
+    std::vector<CardModel*>* piles[] = {
+        &gameModel->getMainPileCards(),
+        &gameModel->getBottomPileCards(),
+        &gameModel->getReservePileCards()
+    };
+    for (auto* pile : piles) {
+        for (auto* card : *pile) {
+            if (card) {
+                _reusableCards.push_back(card);
+            }
         }
+        pile->clear();
     }
+    
+    // 恢复卡牌列表
+    const CardSnapshot* cursor = snapshot.cards;
+    restoreCardList(gameModel->getMainPileCards(), cursor, snapshot.mainPileCount);
+    cursor += snapshot.mainPileCount;
+    restoreCardList(gameModel->getBottomPileCards(), cursor, snapshot.bottomPileCount);
+    cursor += snapshot.bottomPileCount;
+    restoreCardList(gameModel->getReservePileCards(), cursor, snapshot.reservePileCount);
+    
+    // 快照中不存在的卡牌在新对象分配完之后再释放，避免新对象复用其地址
+    for (auto* card : _reusableCards) {
+        delete card;
+    }
+    _reusableCards.clear();
+    
+    // 恢复索引
+    gameModel->setBottomPileTopIndex(snapshot.bottomPileTopIndex);
+    gameModel->setReservePileTopIndex(snapshot.reservePileTopIndex);
 }
@@ -25,11 +25,24 @@
 #ifndef __GAME_STATE_MANAGER_H__
 #define __GAME_STATE_MANAGER_H__
 
-#include "cocos2d.h"
+#include "../core/CoreTypes.h"
 #include "../models/GameModel.h"
 #include "../models/CardModel.h"
 #include <vector>
-#include <memory>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * 游戏操作类型枚举
+ */
+enum GameActionType
+{
+    GAT_NONE = 0,
+    GAT_INIT,               ///< 初始状态
+    GAT_MAIN_TO_BOTTOM,     ///< 主牌堆到底牌堆
+    GAT_RESERVE_TO_BOTTOM,  ///< 备用牌堆与底牌堆交换
+    GAT_DRAW_CARD           ///< 从备用牌堆抽牌
+};
 
 /**
  * 游戏状态管理器
@@ -39,22 +52,60 @@
 class GameStateManager
 {
 public:
+    /**
+     * 快照中可保存的最大卡牌数量（三个牌堆合计），不小于 LevelConfig::MAX_CARD_COUNT
+     */
+    static const int MAX_SNAPSHOT_CARDS = 64;
+    
+    /**
+     * 卡牌快照，定长且可平凡复制
+     */
+    struct CardSnapshot
+    {
+        int cardId;         ///< 卡牌ID
+        float x;            ///< 位置X
+        float y;            ///< 位置Y
+        int8_t face;        ///< 面值
+        int8_t suit;        ///< 花色
+        bool revealed;      ///< 是否翻开
+        bool clickable;     ///< 是否可点击
+    };
+    
     /**
      * 游戏状态快照
-     * 保存某一时刻的完整游戏状态
+     * 保存某一时刻的完整游戏状态，卡牌按主牌堆、底牌堆、备用牌堆顺序连续存放
      */
     struct GameStateSnapshot
     {
-        std::vector<std::shared_ptr<CardModel>> mainPileCards;     ///< 主牌堆卡牌
-        std::vector<std::shared_ptr<CardModel>> bottomPileCards;   ///< 底牌堆卡牌
-        std::vector<std::shared_ptr<CardModel>> reservePileCards;  ///< 备用牌堆卡牌
-        int bottomPileTopIndex;                                    ///< 底牌堆顶部索引
-        int reservePileTopIndex;                                   ///< 备用牌堆顶部索引
-        std::string actionType;                                    ///< 操作类型
-        int sourceCardId;                                          ///< 源卡牌ID
-        int targetCardId;                                          ///< 目标卡牌ID
-        
-        GameStateSnapshot() : bottomPileTopIndex(-1), reservePileTopIndex(-1), sourceCardId(-1), targetCardId(-1) {}
+        CardSnapshot cards[MAX_SNAPSHOT_CARDS];     ///< 卡牌数据
+        int mainPileCount;                          ///< 主牌堆卡牌数量
+        int bottomPileCount;                        ///< 底牌堆卡牌数量
+        int reservePileCount;                       ///< 备用牌堆卡牌数量
+        int bottomPileTopIndex;                     ///< 底牌堆顶部索引
+        int reservePileTopIndex;                    ///< 备用牌堆顶部索引
+        GameActionType actionType;                  ///< 操作类型
+        int sourceCardId;                           ///< 源卡牌ID
+        int targetCardId;                           ///< 目标卡牌ID
+    };
+    
+    /**
+     * 恢复状态时单张卡牌的位置变化，供视图播放过渡动画
+     */
+    struct CardDelta
+    {
+        int cardId;                     ///< 卡牌ID
+        CoreVec2 fromPosition;          ///< 恢复前的位置
+        CoreVec2 toPosition;            ///< 恢复后的位置
+    };
+    
+    /**
+     * 不含卡牌数据的操作记录，用于在重新生成的模型上重放
+     */
+    struct ActionRecord
+    {
+        GameActionType actionType;      ///< 操作类型
+        int sourceCardId;               ///< 源卡牌ID
+        int targetCardId;               ///< 目标卡牌ID
     };
     
     /**
@@ -69,12 +120,21 @@ public:
     
     /**
      * 保存当前游戏状态
+     * 快照写入预分配的状态池，不分配内存
      * @param gameModel 游戏模型
      * @param actionType 操作类型
      * @param sourceCardId 源卡牌ID
      * @param targetCardId 目标卡牌ID
+     * @return 是否已保存；模型为空或卡牌数超过 MAX_SNAPSHOT_CARDS 时返回false，历史不变
      */
-    void saveState(GameModel* gameModel, const std::string& actionType, int sourceCardId, int targetCardId);
+    bool saveState(GameModel* gameModel, GameActionType actionType, int sourceCardId, int targetCardId);
+    
+    /**
+     * 检查游戏模型能否写入快照
+     * @param gameModel 游戏模型
+     * @return 模型非空且卡牌数不超过 MAX_SNAPSHOT_CARDS
+     */
+    static bool canSaveState(const GameModel* gameModel);
     
     /**
      * 撤销到上一个状态
@@ -112,34 +172,73 @@ public:
      * @return 状态数量
      */
     size_t getStateCount() const;
+    
+    /**
+     * 导出从初始状态到当前状态的操作序列
+     * @param initialCardIds 输出初始状态的卡牌ID，按主牌堆、底牌堆、备用牌堆顺序
+     * @param actions 输出操作序列（不含初始状态）
+     * @return 初始状态仍在历史中时返回true；超出容量被淘汰后无法重放，返回false
+     */
+    bool exportHistory(std::vector<int>& initialCardIds, std::vector<ActionRecord>& actions) const;
+    
+    /**
+     * 获取最近一次撤销/重做中位置发生变化的卡牌
+     * 恢复时沿用ID相同的卡牌对象，视图持有的模型指针保持有效
+     * @return 卡牌位置变化列表
+     */
+    const std::vector<CardDelta>& getLastRestoreDeltas() const { return _lastRestoreDeltas; }
+    
+    /**
+     * 获取操作类型名称
+     * @param actionType 操作类型
+     * @return 操作类型名称
+     */
+    static const char* getActionTypeName(GameActionType actionType);
 
 private:
     /**
-     * 深拷贝卡牌模型
-     * @param card 源卡牌
-     * @return 拷贝的卡牌
+     * 将卡牌列表写入快照
+     * @param cards 源卡牌列表
+     * @param target 快照中的起始位置
+     * @return 写入的卡牌数量
      */
-    std::shared_ptr<CardModel> cloneCard(const CardModel* card);
+    int captureCardList(const std::vector<CardModel*>& cards, CardSnapshot* target);
     
     /**
-     * 深拷贝卡牌列表
-     * @param cards 源卡牌列表
-     * @return 拷贝的卡牌列表
+     * 从快照恢复卡牌列表
+     * 优先复用 _reusableCards 中ID、面值和花色都相同的卡牌对象，并记录位置变化
+     * @param targetCards 目标卡牌列表
+     * @param sourceCards 快照中的起始位置
+     * @param count 卡牌数量
      */
-    std::vector<std::shared_ptr<CardModel>> cloneCardList(const std::vector<CardModel*>& cards);
+    void restoreCardList(std::vector<CardModel*>& targetCards, const CardSnapshot* sourceCards, int count);
     
     /**
-     * 恢复卡牌列表到游戏模型
+     * 将快照恢复到游戏模型
      * @param gameModel 游戏模型
-     * @param targetCards 目标卡牌列表
-     * @param sourceCards 源卡牌列表
+     * @param snapshot 状态快照
      */
-    void restoreCardList(std::vector<CardModel*>& targetCards, const std::vector<std::shared_ptr<CardModel>>& sourceCards);
+    void restoreSnapshot(GameModel* gameModel, const GameStateSnapshot& snapshot);
+    
+    /**
+     * 获取逻辑序号对应的快照
+     * @param index 逻辑序号，0为最早的状态
+     * @return 状态快照
+     */
+    GameStateSnapshot& getState(size_t index) { return _stateHistory[(_firstStateIndex + index) % MAX_STATES]; }
+    const GameStateSnapshot& getState(size_t index) const { return _stateHistory[(_firstStateIndex + index) % MAX_STATES]; }
 
 private:
-    std::vector<GameStateSnapshot> _stateHistory;  ///< 状态历史
+    std::vector<GameStateSnapshot> _stateHistory;  ///< 预分配的状态池（环形使用）
+    size_t _firstStateIndex;                       ///< 最早状态在池中的位置
+    size_t _stateCount;                            ///< 状态数量
     size_t _currentStateIndex;                     ///< 当前状态索引
+    std::vector<CardModel*> _reusableCards;        ///< 恢复过程中待复用的卡牌对象
+    std::vector<CardDelta> _lastRestoreDeltas;     ///< 最近一次恢复的位置变化
     static const size_t MAX_STATES = 100;          ///< 最大状态数量
 };
 
+static_assert(std::is_trivially_copyable<GameStateManager::GameStateSnapshot>::value,
+              "GameStateSnapshot must stay trivially copyable");
+
 #endif // __GAME_STATE_MANAGER_H__
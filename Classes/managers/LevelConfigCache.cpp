@@ -0,0 +1,246 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LevelConfigCache.h"
+#include "../configs/loaders/LevelConfigLoader.h"
+#include <algorithm>
+
+const size_t LevelConfigCache::DEFAULT_BYTE_BUDGET;
+
+LevelConfigCache* LevelConfigCache::getInstance()
+{
+    static LevelConfigCache instance;
+    return &instance;
+}
+
+LevelConfigCache::LevelConfigCache(size_t byteBudget)
+    : _byteBudget(byteBudget)
+    , _usedBytes(0)
+    , _hitCount(0)
+    , _missCount(0)
+    , _stopping(false)
+{
+}
+
+LevelConfigCache::~LevelConfigCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+        _prefetchQueue.clear();
+    }
+    _condition.notify_all();
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+LevelConfigCache::LevelConfigHandle LevelConfigCache::getLevelConfig(const std::string& levelId)
+{
+    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(
+        LevelConfigLoader::getLevelFileName(levelId));
+    return getLevelConfig(levelId, fullPath);
+}
+
+LevelConfigCache::LevelConfigHandle LevelConfigCache::getLevelConfig(const std::string& levelId, const std::string& fullPath)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    
+    // 还在排队的预取请求直接取消，由当前线程加载；正在预取的则等它完成，避免重复加载
+    for (auto it = _prefetchQueue.begin(); it != _prefetchQueue.end(); ++it) {
+        if (it->levelId == levelId) {
+            _prefetchQueue.erase(it);
+            break;
+        }
+    }
+    _condition.wait(lock, [this, &levelId]() { return _stopping || _prefetchingLevelId != levelId; });
+    
+    auto found = _entryMap.find(levelId);
+    if (found != _entryMap.end()) {
+        ++_hitCount;
+        _entries.splice(_entries.begin(), _entries, found->second);
+        return found->second->config;
+    }
+    ++_missCount;
+    
+    // 未命中：在当前线程加载，加载期间不持有锁
+    lock.unlock();
+    LevelConfigHandle config = loadLevel(levelId, fullPath);
+    lock.lock();
+    
+    if (config) {
+        insertLocked(levelId, config);
+    }
+    return config;
+}
+
+void LevelConfigCache::prefetch(const std::string& levelId)
+{
+    // 在调用线程解析路径，后台线程只读取已解析的完整路径
+    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(
+        LevelConfigLoader::getLevelFileName(levelId));
+    
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stopping || _entryMap.count(levelId) > 0 || _prefetchingLevelId == levelId) {
+            return;
+        }
+        for (const auto& request : _prefetchQueue) {
+            if (request.levelId == levelId) {
+                return;
+            }
+        }
+        
+        PrefetchRequest request;
+        request.levelId = levelId;
+        request.fullPath = fullPath;
+        _prefetchQueue.push_back(request);
+        
+        if (!_worker.joinable()) {
+            _worker = std::thread(&LevelConfigCache::workerLoop, this);
+        }
+    }
+    _condition.notify_all();
+}
+
+void LevelConfigCache::setByteBudget(size_t byteBudget)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _byteBudget = byteBudget;
+    evictLocked();
+}
+
+size_t LevelConfigCache::getByteBudget() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _byteBudget;
+}
+
+size_t LevelConfigCache::getUsedBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _usedBytes;
+}
+
+size_t LevelConfigCache::getHitCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hitCount;
+}
+
+size_t LevelConfigCache::getMissCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _missCount;
+}
+
+void LevelConfigCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _entryMap.clear();
+    _usedBytes = 0;
+}
+
+LevelConfigCache::LevelConfigHandle LevelConfigCache::reloadLevelConfig(const std::string& levelId, const std::string& fullPath)
+{
+    LevelConfigHandle config(LevelConfigLoader::loadLevelConfigFromFile(fullPath));
+    if (config) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        insertLocked(levelId, config);
+    }
+    return config;
+}
+
+size_t LevelConfigCache::estimateBytes(const LevelConfig& config)
+{
+    size_t cardCount = config.getMainPileCards().capacity() + config.getBottomPileCards().capacity() +
+                       config.getReservePileCards().capacity();
+    return sizeof(LevelConfig) + cardCount * sizeof(LevelConfig::CardConfig);
+}
+
+LevelConfigCache::LevelConfigHandle LevelConfigCache::loadLevel(const std::string& levelId, const std::string& fullPath)
+{
+    LevelConfig* config = LevelConfigLoader::loadLevelConfigFromPack(levelId);
+    if (!config && !fullPath.empty()) {
+        config = LevelConfigLoader::loadLevelConfigFromFile(fullPath);
+    }
+    return LevelConfigHandle(config);
+}
+
+void LevelConfigCache::insertLocked(const std::string& levelId, const LevelConfigHandle& config)
+{
+    auto found = _entryMap.find(levelId);
+    if (found != _entryMap.end()) {
+        _usedBytes -= found->second->bytes;
+        _entries.erase(found->second);
+        _entryMap.erase(found);
+    }
+    
+    CacheEntry entry;
+    entry.levelId = levelId;
+    entry.config = config;
+    entry.bytes = estimateBytes(*config);
+    _entries.push_front(entry);
+    _entryMap[levelId] = _entries.begin();
+    _usedBytes += entry.bytes;
+    
+    evictLocked();
+}
+
+void LevelConfigCache::evictLocked()
+{
+    while (_usedBytes > _byteBudget && _entries.size() > 1) {
+        const CacheEntry& oldest = _entries.back();
+        cocos2d::log("LevelConfigCache: Evicting level %s (%zu bytes)", oldest.levelId.c_str(), oldest.bytes);
+        _usedBytes -= oldest.bytes;
+        _entryMap.erase(oldest.levelId);
+        _entries.pop_back();
+    }
+}
+
+void LevelConfigCache::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this]() { return _stopping || !_prefetchQueue.empty(); });
+        if (_stopping) {
+            return;
+        }
+        
+        PrefetchRequest request = _prefetchQueue.front();
+        _prefetchQueue.pop_front();
+        _prefetchingLevelId = request.levelId;
+        
+        lock.unlock();
+        LevelConfigHandle config = loadLevel(request.levelId, request.fullPath);
+        lock.lock();
+        
+        if (config && _entryMap.count(request.levelId) == 0) {
+            insertLocked(request.levelId, config);
+        }
+        _prefetchingLevelId.clear();
+        _condition.notify_all();
+    }
+}
@@ -0,0 +1,212 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __LEVEL_CONFIG_CACHE_H__
+#define __LEVEL_CONFIG_CACHE_H__
+
+#include "cocos2d.h"
+#include "../configs/models/LevelConfig.h"
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * 关卡配置缓存
+ * 职责：缓存已解析的关卡配置，按字节预算做LRU淘汰，并在后台线程预取关卡
+ * 使用场景：重玩、进入下一关时直接命中缓存，不再重新读取和解析
+ * 缓存中的配置不可修改，以共享句柄返回；被淘汰后已取出的句柄仍然有效
+ */
+class LevelConfigCache
+{
+public:
+    /**
+     * 共享的只读关卡配置句柄
+     */
+    typedef std::shared_ptr<const LevelConfig> LevelConfigHandle;
+    
+    /**
+     * 默认字节预算
+     */
+    static const size_t DEFAULT_BYTE_BUDGET = 256 * 1024;
+    
+    /**
+     * 获取全局缓存实例
+     * @return 缓存实例
+     */
+    static LevelConfigCache* getInstance();
+    
+    /**
+     * 构造函数
+     * @param byteBudget 字节预算
+     */
+    explicit LevelConfigCache(size_t byteBudget = DEFAULT_BYTE_BUDGET);
+    
+    /**
+     * 析构函数，停止预取线程
+     */
+    ~LevelConfigCache();
+    
+    /**
+     * 获取关卡配置
+     * 命中直接返回；该关卡正在后台加载时等待其完成；否则在当前线程加载
+     * @param levelId 关卡ID
+     * @return 关卡配置句柄，加载失败返回空句柄
+     */
+    LevelConfigHandle getLevelConfig(const std::string& levelId);
+    
+    /**
+     * 获取关卡配置，使用已解析的文件路径
+     * 不访问 FileUtils 的路径解析，可在后台线程调用
+     * @param levelId 关卡ID
+     * @param fullPath 关卡JSON文件完整路径
+     * @return 关卡配置句柄，加载失败返回空句柄
+     */
+    LevelConfigHandle getLevelConfig(const std::string& levelId, const std::string& fullPath);
+    
+    /**
+     * 在后台线程预取关卡配置，已缓存或已在预取中则忽略
+     * 需在主线程调用（文件路径在调用线程解析）
+     * @param levelId 关卡ID
+     */
+    void prefetch(const std::string& levelId);
+    
+    /**
+     * 设置字节预算，超出部分立即淘汰
+     * @param byteBudget 字节预算
+     */
+    void setByteBudget(size_t byteBudget);
+    
+    /**
+     * 获取字节预算
+     * @return 字节预算
+     */
+    size_t getByteBudget() const;
+    
+    /**
+     * 获取当前占用的字节数（估算）
+     * @return 字节数
+     */
+    size_t getUsedBytes() const;
+    
+    /**
+     * 获取命中次数
+     * @return 命中次数
+     */
+    size_t getHitCount() const;
+    
+    /**
+     * 获取未命中次数
+     * @return 未命中次数
+     */
+    size_t getMissCount() const;
+    
+    /**
+     * 清空缓存（不影响已取出的句柄和进行中的预取）
+     */
+    void clear();
+    
+    /**
+     * 从 JSON 文件重新解析单个关卡并替换缓存项（开发期热重载，不读取关卡包）
+     * @param levelId 关卡ID
+     * @param fullPath 关卡文件完整路径
+     * @return 新的关卡配置，解析失败返回空句柄且保留原缓存项
+     */
+    LevelConfigHandle reloadLevelConfig(const std::string& levelId, const std::string& fullPath);
+    
+    /**
+     * 估算关卡配置占用的字节数
+     * @param config 关卡配置
+     * @return 字节数
+     */
+    static size_t estimateBytes(const LevelConfig& config);
+
+private:
+    /**
+     * 缓存项
+     */
+    struct CacheEntry
+    {
+        std::string levelId;        ///< 关卡ID
+        LevelConfigHandle config;   ///< 关卡配置
+        size_t bytes;               ///< 估算字节数
+    };
+    
+    /**
+     * 预取请求
+     */
+    struct PrefetchRequest
+    {
+        std::string levelId;        ///< 关卡ID
+        std::string fullPath;       ///< 已解析的JSON文件完整路径
+    };
+    
+    /**
+     * 加载关卡配置（不持有锁）
+     * @param levelId 关卡ID
+     * @param fullPath JSON文件路径
+     * @return 关卡配置句柄
+     */
+    static LevelConfigHandle loadLevel(const std::string& levelId, const std::string& fullPath);
+    
+    /**
+     * 插入缓存并按预算淘汰，调用前需持有锁
+     * @param levelId 关卡ID
+     * @param config 关卡配置
+     */
+    void insertLocked(const std::string& levelId, const LevelConfigHandle& config);
+    
+    /**
+     * 按预算淘汰最久未使用的项，调用前需持有锁
+     * 至少保留最近使用的一项
+     */
+    void evictLocked();
+    
+    /**
+     * 预取线程主循环
+     */
+    void workerLoop();
+
+private:
+    typedef std::list<CacheEntry> EntryList;
+    
+    mutable std::mutex _mutex;                                        ///< 保护以下所有成员
+    std::condition_variable _condition;                               ///< 预取请求/完成通知
+    EntryList _entries;                                               ///< 按最近使用排序，表头最新
+    std::unordered_map<std::string, EntryList::iterator> _entryMap;   ///< 关卡ID到缓存项
+    std::deque<PrefetchRequest> _prefetchQueue;                       ///< 待预取的关卡
+    std::string _prefetchingLevelId;                                  ///< 正在预取的关卡，空表示无
+    size_t _byteBudget;                                               ///< 字节预算
+    size_t _usedBytes;                                                ///< 已用字节
+    size_t _hitCount;                                                 ///< 命中次数
+    size_t _missCount;                                                ///< 未命中次数
+    bool _stopping;                                                   ///< 是否正在停止
+    std::thread _worker;                                              ///< 预取线程，首次预取时启动
+};
+
+#endif // __LEVEL_CONFIG_CACHE_H__
@@ -0,0 +1,140 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LevelFileWatcher.h"
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+LevelFileWatcher::LevelFileWatcher()
+    : _inotifyFd(-1)
+{
+#if defined(__linux__)
+    _inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+LevelFileWatcher::~LevelFileWatcher()
+{
+    unwatchAll();
+#if defined(__linux__)
+    if (_inotifyFd >= 0) {
+        close(_inotifyFd);
+    }
+#endif
+}
+
+bool LevelFileWatcher::watchFile(const std::string& fullPath)
+{
+    if (fullPath.empty()) {
+        return false;
+    }
+    
+#if defined(__linux__)
+    if (_inotifyFd >= 0) {
+        size_t slash = fullPath.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : fullPath.substr(0, slash);
+        int watch = inotify_add_watch(_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watch < 0) {
+            return false;
+        }
+        _directories[watch] = directory;
+        _files.insert(fullPath);
+        return true;
+    }
+#endif
+    
+    _files.insert(fullPath);
+    _modifiedTimes[fullPath] = getModifiedTime(fullPath);
+    return true;
+}
+
+void LevelFileWatcher::unwatchAll()
+{
+#if defined(__linux__)
+    for (const auto& directory : _directories) {
+        inotify_rm_watch(_inotifyFd, directory.first);
+    }
+#endif
+    _directories.clear();
+    _files.clear();
+    _modifiedTimes.clear();
+}
+
+int LevelFileWatcher::poll(const ChangeCallback& callback)
+{
+    std::set<std::string> changedFiles;
+    
+#if defined(__linux__)
+    if (_inotifyFd >= 0) {
+        alignas(struct inotify_event) char buffer[4096];
+        for (;;) {
+            ssize_t length = read(_inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+            for (char* cursor = buffer; cursor < buffer + length; ) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(cursor);
+                cursor += sizeof(struct inotify_event) + event->len;
+                
+                auto directory = _directories.find(event->wd);
+                if (directory == _directories.end() || event->len == 0) {
+                    continue;
+                }
+                std::string fullPath = directory->second + "/" + event->name;
+                if (_files.count(fullPath)) {
+                    changedFiles.insert(fullPath);
+                }
+            }
+        }
+    }
+#endif
+    
+    for (auto& entry : _modifiedTimes) {
+        time_t modifiedTime = getModifiedTime(entry.first);
+        if (modifiedTime != entry.second) {
+            entry.second = modifiedTime;
+            changedFiles.insert(entry.first);
+        }
+    }
+    
+    if (callback) {
+        for (const auto& fullPath : changedFiles) {
+            callback(fullPath);
+        }
+    }
+    return (int)changedFiles.size();
+}
+
+time_t LevelFileWatcher::getModifiedTime(const std::string& fullPath)
+{
+    struct stat info;
+    if (stat(fullPath.c_str(), &info) != 0) {
+        return 0;
+    }
+    return info.st_mtime;
+}
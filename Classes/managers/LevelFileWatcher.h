@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __LEVEL_FILE_WATCHER_H__
+#define __LEVEL_FILE_WATCHER_H__
+
+#include <ctime>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+
+/**
+ * 关卡文件监视器（开发期热重载）
+ * 职责：检测被监视的关卡文件是否被修改，只报告发生变化的文件
+ * 使用场景：调试构建中编辑 Resources/level*.json 后无需重启即可重载当前关卡
+ *
+ * Linux 上使用 inotify 监视文件所在目录（编辑器常以“写临时文件再改名”的方式保存，
+ * 直接监视文件会在改名后失效）；其他平台退化为比较文件修改时间。
+ * poll() 不阻塞，由主线程定时调用，回调也在主线程执行。
+ */
+class LevelFileWatcher
+{
+public:
+    /**
+     * 文件变化回调
+     * @param fullPath 发生变化的文件完整路径
+     */
+    typedef std::function<void(const std::string& fullPath)> ChangeCallback;
+    
+    /**
+     * 构造函数
+     */
+    LevelFileWatcher();
+    
+    /**
+     * 析构函数
+     */
+    ~LevelFileWatcher();
+    
+    /**
+     * 开始监视文件
+     * @param fullPath 文件完整路径
+     * @return 是否成功
+     */
+    bool watchFile(const std::string& fullPath);
+    
+    /**
+     * 停止监视所有文件
+     */
+    void unwatchAll();
+    
+    /**
+     * 检查文件变化，同一次调用中多次变化的文件只回调一次
+     * @param callback 变化回调
+     * @return 发生变化的文件数
+     */
+    int poll(const ChangeCallback& callback);
+
+private:
+    /**
+     * 读取文件修改时间
+     * @param fullPath 文件完整路径
+     * @return 修改时间，文件不存在返回0
+     */
+    static time_t getModifiedTime(const std::string& fullPath);
+    
+    int _inotifyFd;                                 ///< inotify 描述符，不可用时为-1
+    std::map<int, std::string> _directories;        ///< inotify 监视描述符 -> 目录
+    std::set<std::string> _files;                   ///< 被监视的文件完整路径
+    std::map<std::string, time_t> _modifiedTimes;   ///< 轮询方式下记录的修改时间
+};
+
+#endif // __LEVEL_FILE_WATCHER_H__
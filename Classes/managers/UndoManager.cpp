@@ -59,7 +59,14 @@ void UndoManager::addUndoRecord(const UndoModel::UndoRecord& record)
 
 bool UndoManager::executeUndo()
 {
-    if (!_undoModel || !_gameModel) {
+    return undoN(1);
+}
+
+bool UndoManager::undoN(int count)
+{
+    _lastUndoDeltas.clear();
+    
+    if (!_undoModel || !_gameModel || count <= 0) {
         notifyUndoComplete(false);
         return false;
     }
@@ -69,12 +76,49 @@ bool UndoManager::executeUndo()
         return false;
     }
     
-    UndoModel::UndoRecord record = _undoModel->getLastUndoRecord();
-    _undoModel->removeLastUndoRecord();
+    // 先把所有逆操作作用到模型上，中间不刷新视图
+    int undoneCount = 0;
+    bool allSucceeded = true;
+    while (undoneCount < count && _undoModel->hasUndoableAction()) {
+        UndoModel::UndoRecord record = _undoModel->getLastUndoRecord();
+        _undoModel->removeLastUndoRecord();
+        
+        captureCardBeforeUndo(record.sourceCardId);
+        captureCardBeforeUndo(record.targetCardId);
+        
+        if (!UndoService::executeUndo(_gameModel, record)) {
+            allSucceeded = false;
+            break;
+        }
+        ++undoneCount;
+    }
+    
+    // 只保留位置确实发生变化的卡牌，作为净变化
+    std::vector<CardDelta> netDeltas;
+    for (auto& delta : _lastUndoDeltas) {
+        CardModel* card = _gameModel->findCard(delta.cardId);
+        if (card && card->getPosition() != delta.fromPosition) {
+            delta.toPosition = card->getPosition();
+            netDeltas.push_back(delta);
+        }
+    }
+    _lastUndoDeltas.swap(netDeltas);
+    
+    // 整个批次只通知一次
+    notifyUndoComplete(undoneCount > 0);
+    return allSucceeded && undoneCount > 0;
+}
+
+bool UndoManager::undoTo(int moveIndex)
+{
+    int recordCount = getRecordCount();
+    if (moveIndex < 0 || moveIndex >= recordCount) {
+        _lastUndoDeltas.clear();
+        notifyUndoComplete(false);
+        return false;
+    }
     
-    bool success = UndoService::executeUndo(_gameModel, record);
-    notifyUndoComplete(success);
-    return success;
+    return undoN(recordCount - moveIndex);
 }
 
 bool UndoManager::hasUndoableAction() const
@@ -94,6 +138,28 @@ int UndoManager::getRecordCount() const
     return _undoModel ? _undoModel->getRecordCount() : 0;
 }
 
+void UndoManager::captureCardBeforeUndo(int cardId)
+{
+    if (cardId < 0 || !_gameModel) {
+        return;
+    }
+    
+    for (const auto& delta : _lastUndoDeltas) {
+        if (delta.cardId == cardId) {
+            return;
+        }
+    }
+    
+    CardModel* card = _gameModel->findCard(cardId);
+    if (card) {
+        CardDelta delta;
+        delta.cardId = cardId;
+        delta.fromPosition = card->getPosition();
+        delta.toPosition = card->getPosition();
+        _lastUndoDeltas.push_back(delta);
+    }
+}
+
 void UndoManager::notifyUndoComplete(bool success)
 {
     if (_undoCompleteCallback) {
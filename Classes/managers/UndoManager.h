@@ -28,6 +28,7 @@
 #include "../models/UndoModel.h"
 #include "../models/GameModel.h"
 #include <functional>
+#include <vector>
 
 /**
  * 撤销管理器
@@ -43,6 +44,17 @@ public:
      */
     typedef std::function<void(bool success)> UndoCompleteCallback;
     
+    /**
+     * 撤销批次中单张卡牌的净变化
+     * 多步撤销只记录批次开始与结束之间的差异，中间状态不会体现
+     */
+    struct CardDelta
+    {
+        int cardId;                     ///< 卡牌ID
+        CoreVec2 fromPosition;          ///< 撤销前位置
+        CoreVec2 toPosition;            ///< 撤销后位置
+    };
+    
     /**
      * 构造函数
      */
@@ -72,6 +84,27 @@ public:
      */
     bool executeUndo();
     
+    /**
+     * 连续撤销多步操作
+     * 所有逆操作先作用于模型，结束后只通知一次回调
+     * @param count 撤销步数，超过记录数时撤销全部
+     * @return 是否全部成功
+     */
+    bool undoN(int count);
+    
+    /**
+     * 撤销到指定步数
+     * @param moveIndex 撤销后保留的操作数量（0表示回到初始状态）
+     * @return 是否全部成功
+     */
+    bool undoTo(int moveIndex);
+    
+    /**
+     * 获取最近一次撤销批次的卡牌净变化
+     * @return 净变化列表，仅包含位置确实改变的卡牌
+     */
+    const std::vector<CardDelta>& getLastUndoDeltas() const { return _lastUndoDeltas; }
+    
     /**
      * 检查是否有可撤销的操作
      * @return 是否有可撤销的操作
@@ -89,6 +122,12 @@ public:
      */
     int getRecordCount() const;
     
+    /**
+     * 获取撤销历史日志，可交给统计线程无锁读取
+     * @return 撤销历史日志，未初始化返回nullptr
+     */
+    const UndoHistoryLog* getHistoryLog() const { return _undoModel ? &_undoModel->getHistoryLog() : nullptr; }
+    
     /**
      * 设置撤销完成回调函数
      * @param callback 撤销完成回调函数
@@ -99,6 +138,13 @@ private:
     UndoModel* _undoModel;              ///< 撤销数据模型
     GameModel* _gameModel;              ///< 游戏数据模型
     UndoCompleteCallback _undoCompleteCallback; ///< 撤销完成回调函数
+    std::vector<CardDelta> _lastUndoDeltas;     ///< 最近一次撤销批次的净变化
+    
+    /**
+     * 记录卡牌在撤销批次开始前的位置，同一卡牌只记录第一次
+     * @param cardId 卡牌ID
+     */
+    void captureCardBeforeUndo(int cardId);
     
     /**
      * 通知撤销完成
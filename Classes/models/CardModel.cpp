@@ -25,20 +25,21 @@
 #include "CardModel.h"
 #include <sstream>
 #include <algorithm>
+#include <vector>
 
-int CardModel::_nextCardId = 1;
+std::atomic<int> CardModel::_nextCardId(1);
 
 CardModel::CardModel()
     : _cardId(_nextCardId++)
     , _face(CFT_NONE)
     , _suit(CST_NONE)
-    , _position(cocos2d::Vec2::ZERO)
+    , _position(CoreVec2())
     , _isRevealed(false)
     , _isClickable(false)
 {
 }
 
-CardModel::CardModel(CardFaceType face, CardSuitType suit, const cocos2d::Vec2& position)
+CardModel::CardModel(CardFaceType face, CardSuitType suit, const CoreVec2& position)
     : _cardId(_nextCardId++)
     , _face(face)
     , _suit(suit)
@@ -25,7 +25,9 @@
 #ifndef __CARD_MODEL_H__
 #define __CARD_MODEL_H__
 
-#include "cocos2d.h"
+#include "../core/CoreTypes.h"
+#include <atomic>
+#include <string>
 
 /**
  * 卡牌面值类型枚举
@@ -81,7 +83,7 @@ public:
      * @param suit 卡牌花色
      * @param position 卡牌位置
      */
-    CardModel(CardFaceType face, CardSuitType suit, const cocos2d::Vec2& position);
+    CardModel(CardFaceType face, CardSuitType suit, const CoreVec2& position);
     
     /**
      * 析构函数
@@ -104,7 +106,7 @@ public:
      * 获取卡牌位置
      * @return 卡牌位置
      */
-    const cocos2d::Vec2& getPosition() const { return _position; }
+    const CoreVec2& getPosition() const { return _position; }
     
     /**
      * 获取卡牌ID
@@ -146,7 +148,7 @@ public:
      * 设置卡牌位置
      * @param position 卡牌位置
      */
-    void setPosition(const cocos2d::Vec2& position) { _position = position; }
+    void setPosition(const CoreVec2& position) { _position = position; }
     
     /**
      * 设置卡牌是否翻开
@@ -193,12 +195,12 @@ public:
     bool deserialize(const std::string& data);
 
 private:
-    static int _nextCardId; ///< 下一个卡牌ID
+    static std::atomic<int> _nextCardId; ///< 下一个卡牌ID（后台线程也会创建卡牌）
     
     int _cardId;                    ///< 卡牌唯一ID
     CardFaceType _face;             ///< 卡牌面值
     CardSuitType _suit;             ///< 卡牌花色
-    cocos2d::Vec2 _position;        ///< 卡牌位置
+    CoreVec2 _position;             ///< 卡牌位置
     bool _isRevealed;               ///< 是否翻开
     bool _isClickable;              ///< 是否可点击
 };
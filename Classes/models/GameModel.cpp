@@ -25,11 +25,61 @@
 #include "GameModel.h"
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+void hashBytes(uint64_t& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+void hashInt(uint64_t& hash, int value)
+{
+    hashBytes(hash, &value, sizeof(value));
+}
+
+void hashFloat(uint64_t& hash, float value)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    hashBytes(hash, &bits, sizeof(bits));
+}
+
+void hashCardList(uint64_t& hash, const std::vector<CardModel*>& cards)
+{
+    hashInt(hash, (int)cards.size());
+    for (const auto* card : cards) {
+        if (!card) {
+            hashInt(hash, -1);
+            continue;
+        }
+        hashInt(hash, card->getCardId());
+        hashInt(hash, card->getFace());
+        hashInt(hash, card->getSuit());
+        hashFloat(hash, card->getPosition().x);
+        hashFloat(hash, card->getPosition().y);
+        hashInt(hash, (card->isRevealed() ? 1 : 0) | (card->isClickable() ? 2 : 0));
+    }
+}
+
+} // namespace
 
 GameModel::GameModel()
     : _bottomPileTopIndex(-1)
     , _reservePileTopIndex(-1)
     , _gameState("playing")
+    , _hasDealSeed(false)
+    , _dealSeed(0)
+    , _dealIndex(0)
 {
 }
 
@@ -186,6 +236,18 @@ CardModel* GameModel::findReservePileCard(int cardId) const
     return (it != _reservePileCards.end()) ? *it : nullptr;
 }
 
+CardModel* GameModel::findCard(int cardId) const
+{
+    CardModel* card = findMainPileCard(cardId);
+    if (!card) {
+        card = findBottomPileCard(cardId);
+    }
+    if (!card) {
+        card = findReservePileCard(cardId);
+    }
+    return card;
+}
+
 CardModel* GameModel::getBottomPileTopCard() const
 {
     if (_bottomPileTopIndex >= 0 && _bottomPileTopIndex < (int)_bottomPileCards.size()) {
@@ -229,6 +291,24 @@ bool GameModel::isGameOver() const
     return _mainPileCards.empty() || _bottomPileCards.empty();
 }
 
+void GameModel::setDealSeed(uint64_t seed, uint64_t dealIndex)
+{
+    _hasDealSeed = true;
+    _dealSeed = seed;
+    _dealIndex = dealIndex;
+}
+
+uint64_t GameModel::computeStateHash() const
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hashCardList(hash, _mainPileCards);
+    hashCardList(hash, _bottomPileCards);
+    hashCardList(hash, _reservePileCards);
+    hashInt(hash, _bottomPileTopIndex);
+    hashInt(hash, _reservePileTopIndex);
+    return hash;
+}
+
 std::string GameModel::serialize() const
 {
     std::ostringstream oss;
@@ -261,6 +341,10 @@ std::string GameModel::serialize() const
     oss << "bottomPileTopIndex:" << _bottomPileTopIndex << ";";
     oss << "reservePileTopIndex:" << _reservePileTopIndex << ";";
     oss << "gameState:" << _gameState << ";";
+    if (_hasDealSeed) {
+        oss << "dealSeed:" << _dealSeed << ";";
+        oss << "dealIndex:" << _dealIndex << ";";
+    }
     
     return oss.str();
 }
@@ -268,6 +352,9 @@ std::string GameModel::serialize() const
 bool GameModel::deserialize(const std::string& data)
 {
     clearAllCards();
+    _hasDealSeed = false;
+    _dealSeed = 0;
+    _dealIndex = 0;
     
     std::istringstream iss(data);
     std::string line;
@@ -323,6 +410,11 @@ bool GameModel::deserialize(const std::string& data)
             _reservePileTopIndex = std::stoi(value);
         } else if (key == "gameState") {
             _gameState = value;
+        } else if (key == "dealSeed") {
+            _hasDealSeed = true;
+            _dealSeed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "dealIndex") {
+            _dealIndex = std::strtoull(value.c_str(), nullptr, 10);
         }
     }
     
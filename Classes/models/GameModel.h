@@ -25,10 +25,11 @@
 #ifndef __GAME_MODEL_H__
 #define __GAME_MODEL_H__
 
-#include "cocos2d.h"
+#include "../core/CoreTypes.h"
 #include "CardModel.h"
 #include <vector>
 #include <string>
+#include <cstdint>
 
 /**
  * 游戏数据模型
@@ -198,6 +199,13 @@ public:
      */
     CardModel* findReservePileCard(int cardId) const;
     
+    /**
+     * 根据ID在所有牌堆中查找卡牌
+     * @param cardId 卡牌ID
+     * @return 卡牌模型，未找到返回nullptr
+     */
+    CardModel* findCard(int cardId) const;
+    
     /**
      * 获取当前底牌堆顶部卡牌
      * @return 顶部卡牌模型，无顶部卡牌返回nullptr
@@ -221,6 +229,38 @@ public:
      */
     bool isGameOver() const;
     
+    /**
+     * 计算游戏状态哈希
+     * 覆盖三个牌堆中每张卡牌的ID、面值、花色、位置和状态，以及顶部索引
+     * @return 状态哈希值，状态相同则哈希相同
+     */
+    uint64_t computeStateHash() const;
+    
+    /**
+     * 记录发牌种子
+     * @param seed 随机种子
+     * @param dealIndex 牌局编号
+     */
+    void setDealSeed(uint64_t seed, uint64_t dealIndex);
+    
+    /**
+     * 是否为随机发牌（记录了种子）
+     * @return 是否随机发牌
+     */
+    bool hasDealSeed() const { return _hasDealSeed; }
+    
+    /**
+     * 获取发牌种子
+     * @return 随机种子，未随机发牌时为0
+     */
+    uint64_t getDealSeed() const { return _dealSeed; }
+    
+    /**
+     * 获取牌局编号
+     * @return 牌局编号，未随机发牌时为0
+     */
+    uint64_t getDealIndex() const { return _dealIndex; }
+    
     /**
      * 序列化游戏数据
      * @return 序列化后的数据
@@ -241,6 +281,9 @@ private:
     int _bottomPileTopIndex;                     ///< 底牌堆顶部卡牌索引
     int _reservePileTopIndex;                    ///< 备用牌堆顶部卡牌索引
     std::string _gameState;                      ///< 游戏状态
+    bool _hasDealSeed;                           ///< 是否记录了发牌种子
+    uint64_t _dealSeed;                          ///< 发牌种子，用于复现牌局
+    uint64_t _dealIndex;                         ///< 牌局编号
 };
 
 #endif // __GAME_MODEL_H__
@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "UndoHistoryLog.h"
+#include <thread>
+
+const int UndoHistoryLog::HISTORY_CAPACITY;
+
+UndoHistoryLog::UndoHistoryLog()
+    : _sequence(0)
+    , _moveCount(0)
+    , _undoCount(0)
+    , _recordCount(0)
+    , _entryTotal(0)
+{
+    for (auto& entry : _entries) {
+        entry.kind.store(EK_MOVE, std::memory_order_relaxed);
+        entry.actionType.store(0, std::memory_order_relaxed);
+        entry.sourceCardId.store(-1, std::memory_order_relaxed);
+        entry.targetCardId.store(-1, std::memory_order_relaxed);
+    }
+}
+
+void UndoHistoryLog::recordMove(int actionType, int sourceCardId, int targetCardId, int recordCount)
+{
+    append(EK_MOVE, actionType, sourceCardId, targetCardId, recordCount);
+}
+
+void UndoHistoryLog::recordUndo(int actionType, int sourceCardId, int targetCardId, int recordCount)
+{
+    append(EK_UNDO, actionType, sourceCardId, targetCardId, recordCount);
+}
+
+void UndoHistoryLog::setRecordCount(int recordCount)
+{
+    beginWrite();
+    _recordCount.store(recordCount, std::memory_order_relaxed);
+    endWrite();
+}
+
+void UndoHistoryLog::append(int kind, int actionType, int sourceCardId, int targetCardId, int recordCount)
+{
+    beginWrite();
+    
+    // 只有写入线程修改计数器，relaxed读取即可
+    uint64_t total = _entryTotal.load(std::memory_order_relaxed);
+    AtomicEntry& entry = _entries[total % HISTORY_CAPACITY];
+    entry.kind.store(kind, std::memory_order_relaxed);
+    entry.actionType.store(actionType, std::memory_order_relaxed);
+    entry.sourceCardId.store(sourceCardId, std::memory_order_relaxed);
+    entry.targetCardId.store(targetCardId, std::memory_order_relaxed);
+    _entryTotal.store(total + 1, std::memory_order_relaxed);
+    
+    if (kind == EK_MOVE) {
+        _moveCount.store(_moveCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    } else {
+        _undoCount.store(_undoCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    _recordCount.store(recordCount, std::memory_order_relaxed);
+    
+    endWrite();
+}
+
+void UndoHistoryLog::beginWrite()
+{
+    // 序号变为奇数，读取方看到后会放弃本次读取
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void UndoHistoryLog::endWrite()
+{
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool UndoHistoryLog::tryReadSnapshot(Snapshot& snapshot) const
+{
+    uint64_t begin = _sequence.load(std::memory_order_acquire);
+    if (begin & 1) {
+        return false;
+    }
+    
+    snapshot.version = begin / 2;
+    snapshot.moveCount = _moveCount.load(std::memory_order_relaxed);
+    snapshot.undoCount = _undoCount.load(std::memory_order_relaxed);
+    snapshot.recordCount = _recordCount.load(std::memory_order_relaxed);
+    
+    uint64_t total = _entryTotal.load(std::memory_order_relaxed);
+    int count = total < (uint64_t)HISTORY_CAPACITY ? (int)total : HISTORY_CAPACITY;
+    uint64_t first = total - count;
+    for (int i = 0; i < count; ++i) {
+        const AtomicEntry& source = _entries[(first + i) % HISTORY_CAPACITY];
+        Entry& target = snapshot.entries[i];
+        target.kind = source.kind.load(std::memory_order_relaxed);
+        target.actionType = source.actionType.load(std::memory_order_relaxed);
+        target.sourceCardId = source.sourceCardId.load(std::memory_order_relaxed);
+        target.targetCardId = source.targetCardId.load(std::memory_order_relaxed);
+    }
+    snapshot.entryCount = count;
+    
+    // 读取期间序号未变化，说明快照一致
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return _sequence.load(std::memory_order_relaxed) == begin;
+}
+
+void UndoHistoryLog::readSnapshot(Snapshot& snapshot) const
+{
+    while (!tryReadSnapshot(snapshot)) {
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,158 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __UNDO_HISTORY_LOG_H__
+#define __UNDO_HISTORY_LOG_H__
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * 撤销历史日志（单写多读）
+ * 职责：以顺序锁（seqlock）发布操作历史统计，游戏线程写入时不加锁，
+ *       其他线程读取快照时不阻塞写入方，也不分配内存
+ * 使用场景：统计/埋点线程采样玩家操作次数、撤销频率和最近操作
+ * 约束：只允许一个线程（游戏线程）调用写入接口，读取接口可被任意多个线程并发调用
+ */
+class UndoHistoryLog
+{
+public:
+    /**
+     * 最近操作环形缓冲区容量
+     */
+    static const int HISTORY_CAPACITY = 64;
+    
+    /**
+     * 历史条目类型
+     */
+    enum EntryKind
+    {
+        EK_MOVE = 0,    ///< 记录了一次操作
+        EK_UNDO         ///< 撤销了一次操作
+    };
+    
+    /**
+     * 历史条目
+     */
+    struct Entry
+    {
+        int kind;               ///< 条目类型（EntryKind）
+        int actionType;         ///< 操作类型（UndoActionType）
+        int sourceCardId;       ///< 源卡牌ID
+        int targetCardId;       ///< 目标卡牌ID
+    };
+    
+    /**
+     * 历史快照，由读取方在自己的栈上分配
+     */
+    struct Snapshot
+    {
+        uint64_t version;                   ///< 快照对应的写入版本
+        int moveCount;                      ///< 累计操作次数
+        int undoCount;                      ///< 累计撤销次数
+        int recordCount;                    ///< 当前可撤销记录数
+        int entryCount;                     ///< entries 中有效条目数
+        Entry entries[HISTORY_CAPACITY];    ///< 最近的条目，按时间从旧到新
+        
+        /**
+         * 撤销频率
+         * @return 撤销次数与操作次数之比，无操作时为0
+         */
+        float getUndoRate() const { return moveCount > 0 ? (float)undoCount / moveCount : 0.0f; }
+    };
+    
+    /**
+     * 构造函数
+     */
+    UndoHistoryLog();
+    
+    /**
+     * 记录一次操作（仅游戏线程）
+     * @param actionType 操作类型
+     * @param sourceCardId 源卡牌ID
+     * @param targetCardId 目标卡牌ID
+     * @param recordCount 操作后的可撤销记录数
+     */
+    void recordMove(int actionType, int sourceCardId, int targetCardId, int recordCount);
+    
+    /**
+     * 记录一次撤销（仅游戏线程）
+     * @param actionType 被撤销的操作类型
+     * @param sourceCardId 源卡牌ID
+     * @param targetCardId 目标卡牌ID
+     * @param recordCount 撤销后的可撤销记录数
+     */
+    void recordUndo(int actionType, int sourceCardId, int targetCardId, int recordCount);
+    
+    /**
+     * 更新可撤销记录数，不产生历史条目（仅游戏线程）
+     * @param recordCount 可撤销记录数
+     */
+    void setRecordCount(int recordCount);
+    
+    /**
+     * 尝试读取一次快照（任意线程，不阻塞）
+     * @param snapshot 输出快照
+     * @return 读取期间没有发生写入则返回true，否则快照无效
+     */
+    bool tryReadSnapshot(Snapshot& snapshot) const;
+    
+    /**
+     * 读取一致的快照，与写入冲突时自旋重试（任意线程）
+     * @param snapshot 输出快照
+     */
+    void readSnapshot(Snapshot& snapshot) const;
+
+private:
+    /**
+     * 历史条目的原子存储
+     */
+    struct AtomicEntry
+    {
+        std::atomic<int> kind;
+        std::atomic<int> actionType;
+        std::atomic<int> sourceCardId;
+        std::atomic<int> targetCardId;
+    };
+    
+    /**
+     * 写入一个条目并发布
+     */
+    void append(int kind, int actionType, int sourceCardId, int targetCardId, int recordCount);
+    
+    void beginWrite();
+    void endWrite();
+    
+    std::atomic<uint64_t> _sequence;                ///< 顺序锁序号，奇数表示正在写入
+    std::atomic<int> _moveCount;                    ///< 累计操作次数
+    std::atomic<int> _undoCount;                    ///< 累计撤销次数
+    std::atomic<int> _recordCount;                  ///< 当前可撤销记录数
+    std::atomic<uint64_t> _entryTotal;              ///< 累计写入的条目数
+    AtomicEntry _entries[HISTORY_CAPACITY];         ///< 环形缓冲区
+    
+    UndoHistoryLog(const UndoHistoryLog&) = delete;
+    UndoHistoryLog& operator=(const UndoHistoryLog&) = delete;
+};
+
+#endif // __UNDO_HISTORY_LOG_H__
@@ -25,7 +25,12 @@
 #include "UndoModel.h"
 #include <sstream>
 
+const int UndoModel::MAX_UNDO_RECORDS;
+
 UndoModel::UndoModel()
+    : _undoRecords(MAX_UNDO_RECORDS)
+    , _firstRecordIndex(0)
+    , _recordCount(0)
 {
 }
 
@@ -35,48 +40,63 @@ UndoModel::~UndoModel()
 
 void UndoModel::addUndoRecord(const UndoRecord& record)
 {
-    _undoRecords.push_back(record);
+    // 记录池已满时丢弃最早的记录
+    if (_recordCount == MAX_UNDO_RECORDS) {
+        _firstRecordIndex = getPoolIndex(1);
+        --_recordCount;
+    }
+    
+    _undoRecords[getPoolIndex(_recordCount)] = record;
+    ++_recordCount;
+    _historyLog.recordMove(record.actionType, record.sourceCardId, record.targetCardId, _recordCount);
 }
 
 UndoModel::UndoRecord UndoModel::getLastUndoRecord()
 {
-    if (_undoRecords.empty()) {
+    if (_recordCount == 0) {
         return UndoRecord();
     }
-    return _undoRecords.back();
+    return _undoRecords[getPoolIndex(_recordCount - 1)];
 }
 
 void UndoModel::removeLastUndoRecord()
 {
-    if (!_undoRecords.empty()) {
-        _undoRecords.pop_back();
+    if (_recordCount > 0) {
+        const UndoRecord& record = _undoRecords[getPoolIndex(_recordCount - 1)];
+        --_recordCount;
+        _historyLog.recordUndo(record.actionType, record.sourceCardId, record.targetCardId, _recordCount);
     }
 }
 
 bool UndoModel::hasUndoableAction() const
 {
-    return !_undoRecords.empty();
+    return _recordCount > 0;
 }
 
 void UndoModel::clearAllRecords()
 {
-    _undoRecords.clear();
+    _firstRecordIndex = 0;
+    _recordCount = 0;
+    _historyLog.setRecordCount(0);
 }
 
 std::string UndoModel::serialize() const
 {
     std::ostringstream oss;
-    oss << "recordCount:" << _undoRecords.size() << ";";
+    oss << "recordCount:" << _recordCount << ";";
     
-    for (const auto& record : _undoRecords) {
+    for (int i = 0; i < _recordCount; ++i) {
+        const UndoRecord& record = _undoRecords[getPoolIndex(i)];
         oss << "actionType:" << (int)record.actionType << ";";
         oss << "sourceCardId:" << record.sourceCardId << ";";
         oss << "targetCardId:" << record.targetCardId << ";";
-        oss << "sourcePosition:" << record.sourcePosition.x << "," << record.sourcePosition.y << ";";
-        oss << "targetPosition:" << record.targetPosition.x << "," << record.targetPosition.y << ";";
+        oss << "sourcePosition:" << record.sourceX << "," << record.sourceY << ";";
+        oss << "targetPosition:" << record.targetX << "," << record.targetY << ";";
         oss << "handTopIndex:" << record.handTopIndex << ";";
         oss << "playfieldIndex:" << record.playfieldIndex << ";";
         oss << "stackIndex:" << record.stackIndex << ";";
+        oss << "sourceCard:" << (int)record.sourceFace << "," << (int)record.sourceSuit << ";";
+        oss << "targetCard:" << (int)record.targetFace << "," << (int)record.targetSuit << ";";
         oss << "---"; // 记录分隔符
     }
     
@@ -115,14 +135,14 @@ bool UndoModel::deserialize(const std::string& data)
                 } else if (key == "sourcePosition") {
                     size_t commaPos = value.find(',');
                     if (commaPos != std::string::npos) {
-                        record.sourcePosition.x = std::stof(value.substr(0, commaPos));
-                        record.sourcePosition.y = std::stof(value.substr(commaPos + 1));
+                        record.sourceX = std::stof(value.substr(0, commaPos));
+                        record.sourceY = std::stof(value.substr(commaPos + 1));
                     }
                 } else if (key == "targetPosition") {
                     size_t commaPos = value.find(',');
                     if (commaPos != std::string::npos) {
-                        record.targetPosition.x = std::stof(value.substr(0, commaPos));
-                        record.targetPosition.y = std::stof(value.substr(commaPos + 1));
+                        record.targetX = std::stof(value.substr(0, commaPos));
+                        record.targetY = std::stof(value.substr(commaPos + 1));
                     }
                 } else if (key == "handTopIndex") {
                     record.handTopIndex = std::stoi(value);
@@ -130,11 +150,29 @@ bool UndoModel::deserialize(const std::string& data)
                     record.playfieldIndex = std::stoi(value);
                 } else if (key == "stackIndex") {
                     record.stackIndex = std::stoi(value);
+                } else if (key == "sourceCard") {
+                    size_t commaPos = value.find(',');
+                    if (commaPos != std::string::npos) {
+                        record.sourceFace = (int8_t)std::stoi(value.substr(0, commaPos));
+                        record.sourceSuit = (int8_t)std::stoi(value.substr(commaPos + 1));
+                    }
+                } else if (key == "targetCard") {
+                    size_t commaPos = value.find(',');
+                    if (commaPos != std::string::npos) {
+                        record.targetFace = (int8_t)std::stoi(value.substr(0, commaPos));
+                        record.targetSuit = (int8_t)std::stoi(value.substr(commaPos + 1));
+                    }
                 }
             }
             
-            _undoRecords.push_back(record);
+            if (_recordCount == MAX_UNDO_RECORDS) {
+                _firstRecordIndex = getPoolIndex(1);
+                --_recordCount;
+            }
+            _undoRecords[getPoolIndex(_recordCount)] = record;
+            ++_recordCount;
         }
+        _historyLog.setRecordCount(_recordCount);
     }
     
     return true;
@@ -25,8 +25,12 @@
 #ifndef __UNDO_MODEL_H__
 #define __UNDO_MODEL_H__
 
-#include "cocos2d.h"
+#include "../core/CoreTypes.h"
+#include "UndoHistoryLog.h"
 #include <vector>
+#include <cstdint>
+#include <string>
+#include <type_traits>
 
 /**
  * 撤销操作类型枚举
@@ -48,30 +52,53 @@ class UndoModel
 public:
     /**
      * 撤销记录结构
+     * 定长、可平凡复制（trivially copyable），存放在预分配的记录池中，记录操作时不分配内存
      */
     struct UndoRecord
     {
         UndoActionType actionType;           ///< 操作类型
         int sourceCardId;                    ///< 源卡牌ID
         int targetCardId;                    ///< 目标卡牌ID
-        cocos2d::Vec2 sourcePosition;        ///< 源位置
-        cocos2d::Vec2 targetPosition;        ///< 目标位置
+        float sourceX;                       ///< 源位置X
+        float sourceY;                       ///< 源位置Y
+        float targetX;                       ///< 目标位置X
+        float targetY;                       ///< 目标位置Y
         int handTopIndex;                    ///< 手牌区顶部索引
         int playfieldIndex;                  ///< 桌面牌区索引
         int stackIndex;                      ///< 手牌区索引
+        int8_t sourceFace;                   ///< 源卡牌操作前面值
+        int8_t sourceSuit;                   ///< 源卡牌操作前花色
+        int8_t targetFace;                   ///< 目标卡牌操作前面值
+        int8_t targetSuit;                   ///< 目标卡牌操作前花色
         
         UndoRecord()
             : actionType(UAT_NONE)
             , sourceCardId(-1)
             , targetCardId(-1)
-            , sourcePosition(cocos2d::Vec2::ZERO)
-            , targetPosition(cocos2d::Vec2::ZERO)
+            , sourceX(0.0f)
+            , sourceY(0.0f)
+            , targetX(0.0f)
+            , targetY(0.0f)
             , handTopIndex(-1)
             , playfieldIndex(-1)
             , stackIndex(-1)
+            , sourceFace(-1)
+            , sourceSuit(-1)
+            , targetFace(-1)
+            , targetSuit(-1)
         {}
+        
+        CoreVec2 getSourcePosition() const { return CoreVec2(sourceX, sourceY); }
+        CoreVec2 getTargetPosition() const { return CoreVec2(targetX, targetY); }
+        void setSourcePosition(const CoreVec2& position) { sourceX = position.x; sourceY = position.y; }
+        void setTargetPosition(const CoreVec2& position) { targetX = position.x; targetY = position.y; }
     };
     
+    /**
+     * 记录池容量，超出后丢弃最早的记录
+     */
+    static const int MAX_UNDO_RECORDS = 1024;
+    
     /**
      * 构造函数
      */
@@ -114,7 +141,14 @@ public:
      * 获取撤销记录数量
      * @return 撤销记录数量
      */
-    int getRecordCount() const { return (int)_undoRecords.size(); }
+    int getRecordCount() const { return _recordCount; }
+    
+    /**
+     * 获取撤销历史日志
+     * 日志可在其他线程无锁读取，见 UndoHistoryLog
+     * @return 撤销历史日志
+     */
+    const UndoHistoryLog& getHistoryLog() const { return _historyLog; }
     
     /**
      * 序列化撤销数据
@@ -130,7 +164,20 @@ public:
     bool deserialize(const std::string& data);
 
 private:
-    std::vector<UndoRecord> _undoRecords; ///< 撤销记录列表
+    std::vector<UndoRecord> _undoRecords; ///< 预分配的撤销记录池（环形使用）
+    int _firstRecordIndex;                ///< 最早一条记录在池中的位置
+    int _recordCount;                     ///< 当前记录数量
+    UndoHistoryLog _historyLog;           ///< 供其他线程读取的历史日志
+    
+    /**
+     * 将逻辑序号转换为记录池中的位置
+     * @param index 逻辑序号，0为最早的记录
+     * @return 记录池中的位置
+     */
+    int getPoolIndex(int index) const { return (_firstRecordIndex + index) % MAX_UNDO_RECORDS; }
 };
 
+static_assert(std::is_trivially_copyable<UndoModel::UndoRecord>::value,
+              "UndoRecord must stay trivially copyable");
+
 #endif // __UNDO_MODEL_H__
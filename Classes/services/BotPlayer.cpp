@@ -0,0 +1,289 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "BotPlayer.h"
+#include "GameModelFromLevelGenerator.h"
+#include "GameSolver.h"
+#include "PositionEvaluator.h"
+#include "../utils/ParallelUtils.h"
+#include <algorithm>
+
+namespace {
+
+const int FACE_COUNT = CFT_NUM_CARD_FACE_TYPES;
+
+/**
+ * 随机策略：在可点击的卡牌中均匀选择
+ */
+class RandomPolicy : public BotPolicy
+{
+public:
+    virtual int chooseAction(const GameSession& session, DealRandom& random)
+    {
+        session.getClickableCards(_cardIds);
+        if (_cardIds.empty()) {
+            return ACTION_UNDO;
+        }
+        return _cardIds[random.nextBounded((uint32_t)_cardIds.size())];
+    }
+
+private:
+    std::vector<int> _cardIds;  ///< 可点击的卡牌，跨调用复用
+};
+
+/**
+ * 贪心策略：逐个试走可点击的卡牌，用 PositionEvaluator 评估走后的局面，选评分最高的一步，同分随机
+ * 评估为无解的分支直接剪掉；连续两次交换等价于直接交换到第二张，因此交换后只考虑接牌，保证每两步至少接走一张主牌。
+ * 无路可走时撤销，并在撤销后的局面中排除刚才走过的那一步，相当于按贪心顺序回溯
+ */
+class GreedyPolicy : public BotPolicy
+{
+public:
+    virtual void onGameStart(const GameSession& session)
+    {
+        _history.clear();
+        _swapped.clear();
+        _excluded.assign(1, std::vector<int>());
+    }
+    
+    virtual int chooseAction(const GameSession& session, DealRandom& random)
+    {
+        if (!MoveGenerator::buildBoard(session.getGameModel(), _board)) {
+            return ACTION_RESIGN;
+        }
+        MoveGenerator::MoveList moves;
+        MoveGenerator::generateMoves(_board, moves);
+        
+        const std::vector<int>& excluded = _excluded[_history.size()];
+        bool afterSwap = !_swapped.empty() && _swapped.back();
+        int bestCardId = ACTION_UNDO;
+        int bestScore = 0;
+        int ties = 0;
+        bool bestSwap = false;
+        for (int i = 0; i < moves.count; ++i) {
+            if (afterSwap && moves.moves[i].type == GMT_RESERVE_TO_BOTTOM) {
+                continue;
+            }
+            int cardId = _board.cardIds[moves.moves[i].card];
+            if (std::find(excluded.begin(), excluded.end(), cardId) != excluded.end()) {
+                continue;
+            }
+            PositionEvaluation evaluation;
+            MoveGenerator::applyMove(_board, moves.moves[i]);
+            bool alive = PositionEvaluator::evaluate(_board, evaluation);
+            MoveGenerator::unapplyMove(_board, moves.moves[i]);
+            if (!alive) {
+                continue;
+            }
+            int score = PositionEvaluator::score(evaluation);
+            if (bestCardId == ACTION_UNDO || score > bestScore) {
+                bestScore = score;
+                bestCardId = cardId;
+                bestSwap = moves.moves[i].type == GMT_RESERVE_TO_BOTTOM;
+                ties = 1;
+            } else if (score == bestScore && random.nextBounded((uint32_t)++ties) == 0) {
+                bestCardId = cardId;
+                bestSwap = moves.moves[i].type == GMT_RESERVE_TO_BOTTOM;
+            }
+        }
+        
+        if (bestCardId == ACTION_UNDO) {
+            if (_history.empty()) {
+                return ACTION_RESIGN;
+            }
+            // 回到上一层，并记下这一步已经走不通
+            _excluded.pop_back();
+            _excluded.back().push_back(_history.back());
+            _history.pop_back();
+            _swapped.pop_back();
+            return ACTION_UNDO;
+        }
+        _history.push_back(bestCardId);
+        _swapped.push_back(bestSwap);
+        _excluded.push_back(std::vector<int>());
+        return bestCardId;
+    }
+
+private:
+    MoveGenerator::Board _board;                ///< 当前局面，跨调用复用
+    std::vector<int> _history;                  ///< 当前路径上点击过的卡牌
+    std::vector<bool> _swapped;                 ///< 当前路径上每一步是否为备用牌交换
+    std::vector<std::vector<int>> _excluded;    ///< 每一层已经走不通的卡牌，_excluded[i] 对应第 i 步
+};
+
+/**
+ * 求解器策略：沿 GameSolver 给出的最短解点击，局面无解时撤销
+ */
+class SolverPolicy : public BotPolicy
+{
+public:
+    virtual void onGameStart(const GameSession& session)
+    {
+        _result.line.clear();
+        _next = 0;
+    }
+    
+    virtual int chooseAction(const GameSession& session, DealRandom& random)
+    {
+        // 缓存的解在撤销后或被打断时失效，重新求解
+        if (_next >= _result.line.size() || !session.canClick(_result.line[_next].cardId)) {
+            _next = 0;
+            if (!_solver.solve(session.getGameModel(), _result) || _result.line.empty()) {
+                _result.line.clear();
+                return ACTION_UNDO;
+            }
+        }
+        return _result.line[_next++].cardId;
+    }
+
+private:
+    GameSolver _solver;         ///< 求解器，置换表跨对局复用
+    GameSolveResult _result;    ///< 当前的解
+    size_t _next;               ///< 下一步在解中的下标
+};
+
+} // namespace
+
+void BotStats::add(const BotGameResult& result)
+{
+    ++games;
+    wins += result.won ? 1 : 0;
+    moves += result.moves;
+    winMoves += result.won ? result.moves : 0;
+    undos += result.undos;
+    gamesWithUndo += result.undos > 0 ? 1 : 0;
+}
+
+void BotStats::merge(const BotStats& other)
+{
+    games += other.games;
+    wins += other.wins;
+    moves += other.moves;
+    winMoves += other.winMoves;
+    undos += other.undos;
+    gamesWithUndo += other.gamesWithUndo;
+}
+
+BotPolicy* BotPlayer::createPolicy(BotPolicyType type)
+{
+    switch (type) {
+        case BPT_RANDOM:    return new RandomPolicy();
+        case BPT_GREEDY:    return new GreedyPolicy();
+        case BPT_SOLVER:    return new SolverPolicy();
+        default:            return nullptr;
+    }
+}
+
+const char* BotPlayer::getPolicyName(BotPolicyType type)
+{
+    switch (type) {
+        case BPT_RANDOM:    return "random";
+        case BPT_GREEDY:    return "greedy";
+        case BPT_SOLVER:    return "solver";
+        default:            return "unknown";
+    }
+}
+
+bool BotPlayer::parsePolicyName(const std::string& name, BotPolicyType& type)
+{
+    const BotPolicyType types[] = { BPT_RANDOM, BPT_GREEDY, BPT_SOLVER };
+    for (BotPolicyType candidate : types) {
+        if (name == getPolicyName(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+BotGameResult BotPlayer::playGame(GameSession& session, GameModel* gameModel, BotPolicy& policy,
+                                  const BotParams& params, uint64_t gameIndex)
+{
+    BotGameResult result = { false, 0, 0 };
+    if (!session.start(gameModel)) {
+        return result;
+    }
+    policy.onGameStart(session);
+    DealRandom random(params.seed, gameIndex);
+    
+    while (!session.isWon() && result.moves < params.maxMoves) {
+        int action = policy.chooseAction(session, random);
+        if (action == BotPolicy::ACTION_UNDO) {
+            if (result.undos >= params.maxUndos || !session.handleUndo()) {
+                break;
+            }
+            ++result.undos;
+            continue;
+        }
+        if (action < 0 || !session.handleCardClick(action)) {
+            break;
+        }
+        ++result.moves;
+    }
+    result.won = session.isWon();
+    return result;
+}
+
+void BotPlayer::playLevels(const std::vector<const LevelConfig*>& levels, int gamesPerLevel,
+                           const PolicyFactory& factory, const BotParams& params, int threadCount,
+                           std::vector<BotStats>& levelStats)
+{
+    levelStats.assign(levels.size(), BotStats());
+    const long long total = (long long)levels.size() * std::max(0, gamesPerLevel);
+    if (total == 0) {
+        return;
+    }
+    threadCount = ParallelUtils::resolveThreadCount(threadCount, total);
+    
+    // 第 k 局属于第 k / gamesPerLevel 个关卡；每个线程持有自己的会话、策略与统计，结束后按关卡合并
+    std::vector<GameSession> sessions(threadCount);
+    std::vector<BotPolicy*> policies;
+    for (int i = 0; i < threadCount; ++i) {
+        policies.push_back(factory());
+    }
+    std::vector<std::vector<BotStats>> threadStats(threadCount, std::vector<BotStats>(levels.size()));
+    ParallelUtils::parallelFor(total, threadCount, [&](int threadIndex, long long index) {
+        size_t levelIndex = (size_t)(index / gamesPerLevel);
+        GameModel* gameModel = policies[threadIndex] ?
+                               GameModelFromLevelGenerator::generateGameModel(levels[levelIndex]) : nullptr;
+        if (!gameModel) {
+            return;
+        }
+        GameSession& session = sessions[threadIndex];
+        threadStats[threadIndex][levelIndex].add(playGame(session, gameModel, *policies[threadIndex], params,
+                                                          (uint64_t)index));
+        session.start(nullptr);
+        delete gameModel;
+    });
+    
+    for (auto* policy : policies) {
+        delete policy;
+    }
+    for (const auto& stats : threadStats) {
+        for (size_t i = 0; i < levels.size(); ++i) {
+            levelStats[i].merge(stats[i]);
+        }
+    }
+}
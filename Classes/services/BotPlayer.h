@@ -0,0 +1,187 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __BOT_PLAYER_H__
+#define __BOT_PLAYER_H__
+
+#include "../configs/models/LevelConfig.h"
+#include "../controllers/GameSession.h"
+#include "../utils/DealRandom.h"
+#include <functional>
+#include <vector>
+
+/**
+ * 内置的机器人策略
+ */
+enum BotPolicyType
+{
+    BPT_RANDOM,     ///< 随机点击可点击的卡牌，无路可走时撤销
+    BPT_GREEDY,     ///< 按 PositionEvaluator 的评分选择下一步并剪掉无解分支，无路可走时撤销并改走其他分支
+    BPT_SOLVER      ///< 按 GameSolver 的最短解点击，当前局面无解时撤销
+};
+
+/**
+ * 机器人策略接口
+ * 每个工作线程持有独立的策略实例，实现无需线程安全
+ */
+class BotPolicy
+{
+public:
+    static const int ACTION_UNDO = -1;      ///< 撤销上一步
+    static const int ACTION_RESIGN = -2;    ///< 放弃本局
+    
+    virtual ~BotPolicy() {}
+    
+    /**
+     * 开始新的一局
+     * @param session 对局会话
+     */
+    virtual void onGameStart(const GameSession& session) {}
+    
+    /**
+     * 选择下一步
+     * @param session 对局会话
+     * @param random 本局的随机数生成器
+     * @return 要点击的卡牌ID，或 ACTION_UNDO / ACTION_RESIGN
+     */
+    virtual int chooseAction(const GameSession& session, DealRandom& random) = 0;
+};
+
+/**
+ * 机器人对局参数
+ */
+struct BotParams
+{
+    int maxMoves;       ///< 单局最多点击次数（含被撤销的），超出判负；随机交换可能无限循环
+    int maxUndos;       ///< 单局最多撤销次数，用尽后策略要求撤销即判负
+    uint64_t seed;      ///< 随机种子，第 k 局使用 (seed, k) 序列
+    
+    BotParams()
+        : maxMoves(500)
+        , maxUndos(20)
+        , seed(1)
+    {}
+};
+
+/**
+ * 单局结果
+ */
+struct BotGameResult
+{
+    bool won;       ///< 是否清空主牌堆
+    int moves;      ///< 点击次数（含被撤销的）
+    int undos;      ///< 撤销次数
+};
+
+/**
+ * 汇总统计
+ */
+struct BotStats
+{
+    long long games;            ///< 对局数
+    long long wins;             ///< 获胜局数
+    long long moves;            ///< 点击次数合计
+    long long winMoves;         ///< 获胜局的点击次数合计
+    long long undos;            ///< 撤销次数合计
+    long long gamesWithUndo;    ///< 用过撤销的对局数
+    
+    BotStats() : games(0), wins(0), moves(0), winMoves(0), undos(0), gamesWithUndo(0) {}
+    
+    /**
+     * 累加一局结果
+     */
+    void add(const BotGameResult& result);
+    
+    /**
+     * 合并另一份统计
+     */
+    void merge(const BotStats& other);
+};
+
+/**
+ * 机器人对局服务
+ * 职责：在无界面环境下用可替换的策略反复游玩关卡，统计胜率、步数与撤销使用情况
+ * 使用场景：关卡平衡、压力测试
+ *
+ * 机器人通过 GameSession 的 handleCardClick / handleUndo 游玩，与 TestScene 走同一套规则代码。
+ * 批量对局按下标领取，每个线程持有独立的会话与策略；第 k 局只由关卡与 (seed, k) 决定，结果与线程数无关。
+ */
+class BotPlayer
+{
+public:
+    /**
+     * 策略工厂，每个工作线程调用一次
+     */
+    typedef std::function<BotPolicy*()> PolicyFactory;
+    
+    /**
+     * 创建内置策略
+     * @param type 策略类型
+     * @return 策略实例（调用方负责释放）
+     */
+    static BotPolicy* createPolicy(BotPolicyType type);
+    
+    /**
+     * 获取策略名称
+     * @param type 策略类型
+     * @return 名称
+     */
+    static const char* getPolicyName(BotPolicyType type);
+    
+    /**
+     * 按名称解析策略类型
+     * @param name 名称（random/greedy/solver）
+     * @param type 输出策略类型
+     * @return 是否解析成功
+     */
+    static bool parsePolicyName(const std::string& name, BotPolicyType& type);
+    
+    /**
+     * 在会话中玩一局
+     * @param session 对局会话，内部调用 start
+     * @param gameModel 游戏模型（会被修改）
+     * @param policy 策略
+     * @param params 对局参数
+     * @param gameIndex 对局编号，决定随机序列
+     * @return 单局结果
+     */
+    static BotGameResult playGame(GameSession& session, GameModel* gameModel, BotPolicy& policy,
+                                  const BotParams& params, uint64_t gameIndex);
+    
+    /**
+     * 多线程批量对局：每个关卡玩 gamesPerLevel 局
+     * @param levels 关卡列表（只读，可为nullptr，对应统计为空）
+     * @param gamesPerLevel 每个关卡的对局数
+     * @param factory 策略工厂
+     * @param params 对局参数
+     * @param threadCount 线程数，<=0 时使用硬件并发数
+     * @param levelStats 输出每个关卡的统计，长度与 levels 相同
+     */
+    static void playLevels(const std::vector<const LevelConfig*>& levels, int gamesPerLevel,
+                           const PolicyFactory& factory, const BotParams& params, int threadCount,
+                           std::vector<BotStats>& levelStats);
+};
+
+#endif // __BOT_PLAYER_H__
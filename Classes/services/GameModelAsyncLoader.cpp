@@ -0,0 +1,52 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "GameModelAsyncLoader.h"
+#include "GameModelFromLevelGenerator.h"
+#include "../configs/loaders/LevelConfigLoader.h"
+#include "../managers/LevelConfigCache.h"
+#include <thread>
+
+void GameModelAsyncLoader::loadGameModel(const std::string& levelId, LoadCallback callback)
+{
+    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(
+        LevelConfigLoader::getLevelFileName(levelId));
+    
+    std::thread([levelId, fullPath, callback]() {
+        LevelConfigCache::LevelConfigHandle levelConfig =
+            LevelConfigCache::getInstance()->getLevelConfig(levelId, fullPath);
+        GameModel* gameModel = levelConfig ? GameModelFromLevelGenerator::generateGameModel(levelConfig.get()) : nullptr;
+        if (!gameModel) {
+            cocos2d::log("GameModelAsyncLoader: Failed to load level %s", levelId.c_str());
+        }
+        
+        cocos2d::Director::getInstance()->getScheduler()->performFunctionInCocosThread([gameModel, callback]() {
+            if (callback) {
+                callback(gameModel);
+            } else {
+                delete gameModel;
+            }
+        });
+    }).detach();
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __GAME_MODEL_ASYNC_LOADER_H__
+#define __GAME_MODEL_ASYNC_LOADER_H__
+
+#include "cocos2d.h"
+#include "../models/GameModel.h"
+#include <functional>
+#include <string>
+
+/**
+ * 游戏模型异步加载服务
+ * 职责：在后台线程读取、解析关卡并生成游戏模型，完成后通过 Director 的调度器回到主线程交付
+ * 使用场景：场景初始化、重玩、进入下一关，避免加载阻塞渲染帧
+ */
+class GameModelAsyncLoader
+{
+public:
+    /**
+     * 加载完成回调，在主线程调用
+     * @param gameModel 生成的游戏模型，所有权交给回调方；加载失败为nullptr
+     */
+    typedef std::function<void(GameModel* gameModel)> LoadCallback;
+    
+    /**
+     * 异步加载游戏模型
+     * 需在主线程调用；关卡文件路径在调用线程解析，读取、解析和生成在后台线程完成
+     * 回调方在回调前被销毁时，需自行在回调中丢弃结果（如持有弱引用或 retain 场景）
+     * @param levelId 关卡ID
+     * @param callback 完成回调
+     */
+    static void loadGameModel(const std::string& levelId, LoadCallback callback);
+};
+
+#endif // __GAME_MODEL_ASYNC_LOADER_H__
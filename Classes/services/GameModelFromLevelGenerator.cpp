@@ -23,8 +23,7 @@
  ****************************************************************************/
 
 #include "GameModelFromLevelGenerator.h"
-#include <random>
-#include <algorithm>
+#include "../utils/DealRandom.h"
 
 GameModel* GameModelFromLevelGenerator::generateGameModel(const LevelConfig* levelConfig)
 {
@@ -33,6 +32,10 @@ GameModel* GameModelFromLevelGenerator::generateGameModel(const LevelConfig* lev
 
 GameModel* GameModelFromLevelGenerator::generateGameModel(const LevelConfig* levelConfig, bool randomize)
 {
+    if (randomize) {
+        return generateSeededGameModel(levelConfig, DealRandom::makeSeed());
+    }
+    
     if (!levelConfig || !levelConfig->isValid()) {
         return nullptr;
     }
@@ -66,11 +69,16 @@ GameModel* GameModelFromLevelGenerator::generateGameModel(const LevelConfig* lev
         }
     }
     
-    // 随机化位置（如果需要）
-    if (randomize) {
-        randomizeCardPositions(gameModel, levelConfig);
+    return gameModel;
+}
+
+GameModel* GameModelFromLevelGenerator::generateSeededGameModel(const LevelConfig* levelConfig, uint64_t seed, uint64_t dealIndex)
+{
+    GameModel* gameModel = generateGameModel(levelConfig, false);
+    if (gameModel) {
+        randomizeCardPositions(gameModel, levelConfig, seed, dealIndex);
+        gameModel->setDealSeed(seed, dealIndex);
     }
-    
     return gameModel;
 }
 
@@ -78,7 +86,7 @@ CardModel* GameModelFromLevelGenerator::createCardModel(const LevelConfig::CardC
 {
     CardFaceType face = (CardFaceType)cardConfig.cardFace;
     CardSuitType suit = (CardSuitType)cardConfig.cardSuit;
-    cocos2d::Vec2 position = cardConfig.position;
+    CoreVec2 position = cardConfig.position;
     
     CardModel* card = new CardModel(face, suit, position);
     
@@ -100,15 +108,15 @@ CardModel* GameModelFromLevelGenerator::createCardModel(const LevelConfig::CardC
     return card;
 }
 
-void GameModelFromLevelGenerator::randomizeCardPositions(GameModel* gameModel, const LevelConfig* levelConfig)
+void GameModelFromLevelGenerator::randomizeCardPositions(GameModel* gameModel, const LevelConfig* levelConfig,
+                                                         uint64_t seed, uint64_t dealIndex)
 {
     if (!gameModel || !levelConfig) return;
     
-    // 随机化主牌堆位置
+    // 随机化主牌堆位置；不使用 std::shuffle，其结果依赖标准库实现，无法跨平台复现
     auto& mainPileCards = gameModel->getMainPileCards();
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(mainPileCards.begin(), mainPileCards.end(), g);
+    DealRandom random(seed, dealIndex);
+    random.shuffle(mainPileCards.begin(), mainPileCards.size());
     
     // 重新分配位置
     const auto& originalMainPileCards = levelConfig->getMainPileCards();
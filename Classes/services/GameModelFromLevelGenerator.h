@@ -45,11 +45,22 @@ public:
     
     /**
      * 从关卡配置生成游戏模型（带随机化）
+     * 随机化时从系统熵源取种子，种子记录在游戏模型中，可用于复现该局
      * @param levelConfig 关卡配置
      * @param randomize 是否随机化卡牌位置
      * @return 游戏模型，生成失败返回nullptr
      */
     static GameModel* generateGameModel(const LevelConfig* levelConfig, bool randomize);
+    
+    /**
+     * 从关卡配置生成游戏模型，并用指定种子随机化卡牌位置
+     * 同一关卡配置、种子和牌局编号总是得到同一局
+     * @param levelConfig 关卡配置
+     * @param seed 随机种子
+     * @param dealIndex 牌局编号（如每日挑战的天数），可直接定位到第 k 局
+     * @return 游戏模型，生成失败返回nullptr
+     */
+    static GameModel* generateSeededGameModel(const LevelConfig* levelConfig, uint64_t seed, uint64_t dealIndex = 0);
 
 private:
     /**
@@ -63,8 +74,11 @@ private:
      * 随机化卡牌位置
      * @param gameModel 游戏模型
      * @param levelConfig 关卡配置
+     * @param seed 随机种子
+     * @param dealIndex 牌局编号
      */
-    static void randomizeCardPositions(GameModel* gameModel, const LevelConfig* levelConfig);
+    static void randomizeCardPositions(GameModel* gameModel, const LevelConfig* levelConfig,
+                                       uint64_t seed, uint64_t dealIndex);
 };
 
 #endif // __GAME_MODEL_FROM_LEVEL_GENERATOR_H__
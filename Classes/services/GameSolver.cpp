@@ -0,0 +1,391 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "GameSolver.h"
+#include "PositionEvaluator.h"
+#include "../utils/ParallelUtils.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+const int FACE_COUNT = LevelSolver::FACE_COUNT;
+const int INFINITE_COST = 1 << 20;      ///< 无解分支的估价
+const int FOUND = -1;                   ///< search 找到解时的返回值
+const int MAX_CHILDREN = 2 + (FACE_COUNT - 1) * 2;  ///< 直接接牌最多2种，交换到其余面值后再接牌每种最多2种
+
+/**
+ * 一个后继：可选的交换加一次接牌
+ */
+struct Child
+{
+    GameSolver::Position position;  ///< 后继局面
+    int8_t swapFace;                ///< 交换到的备用牌面值，-1表示不交换
+    int8_t mainFace;                ///< 接走的主牌面值
+    int cost;                       ///< 点击次数
+    int mobility;                   ///< 后继局面顶部可接的主牌张数，用于排序
+};
+
+/**
+ * 指定面值的牌在顶部时可接的主牌张数
+ */
+int countMainMoves(const GameSolver::Position& position, int face)
+{
+    int count = 0;
+    if (face > 0) {
+        count += position.mainCounts[face - 1];
+    }
+    if (face >= 0 && face + 1 < FACE_COUNT) {
+        count += position.mainCounts[face + 1];
+    }
+    return count;
+}
+
+/**
+ * 剩余点击次数的下界：每张主牌一次，加上 LevelSolver::countMinSwaps 给出的最少交换次数
+ * @return 下界，无解返回 INFINITE_COST
+ */
+int estimate(const GameSolver::Position& position)
+{
+    int clicks = GameSolver::countMinClicks(position);
+    return clicks < 0 ? INFINITE_COST : clicks;
+}
+
+/**
+ * 置换表键：每个面值计数占4位，顶部面值加1放在主牌键的高位
+ */
+void makeKeys(const GameSolver::Position& position, uint64_t& mainKey, uint64_t& reserveKey)
+{
+    mainKey = (uint64_t)(position.topFace + 1) << (FACE_COUNT * 4);
+    reserveKey = 0;
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        mainKey |= (uint64_t)position.mainCounts[face] << (face * 4);
+        reserveKey |= (uint64_t)position.reserveCounts[face] << (face * 4);
+    }
+}
+
+/**
+ * 在局面上接走一张主牌，原顶部卡牌被移除
+ */
+void playMainCard(GameSolver::Position& position, int mainFace)
+{
+    --position.mainCounts[mainFace];
+    --position.mainRemaining;
+    position.topFace = (int8_t)mainFace;
+}
+
+/**
+ * 生成所有后继，按点击次数升序、可接张数降序排列
+ * 下界在进入后继时才计算：下界准确时排在前面的后继通常就在最优路径上，其余后继不必计算
+ * @return 后继个数
+ */
+int generateChildren(const GameSolver::Position& position, Child* children)
+{
+    int count = 0;
+    const int topFace = position.topFace;
+    if (topFace < 0) {
+        return 0;
+    }
+    
+    for (int swapFace = -1; swapFace < FACE_COUNT; ++swapFace) {
+        if (swapFace >= 0 && (swapFace == topFace || position.reserveCounts[swapFace] == 0)) {
+            continue;
+        }
+        const int handFace = swapFace >= 0 ? swapFace : topFace;
+        for (int mainFace = handFace - 1; mainFace <= handFace + 1; mainFace += 2) {
+            if (mainFace < 0 || mainFace >= FACE_COUNT || position.mainCounts[mainFace] == 0) {
+                continue;
+            }
+            Child& child = children[count];
+            child.position = position;
+            if (swapFace >= 0) {
+                --child.position.reserveCounts[swapFace];
+                ++child.position.reserveCounts[topFace];
+            }
+            playMainCard(child.position, mainFace);
+            child.swapFace = (int8_t)swapFace;
+            child.mainFace = (int8_t)mainFace;
+            child.cost = swapFace >= 0 ? 2 : 1;
+            child.mobility = countMainMoves(child.position, mainFace);
+            ++count;
+        }
+    }
+    
+    // 插入排序，后继最多 MAX_CHILDREN 个
+    for (int i = 1; i < count; ++i) {
+        Child moving = children[i];
+        int j = i;
+        for (; j > 0; --j) {
+            const Child& previous = children[j - 1];
+            if (previous.cost < moving.cost || (previous.cost == moving.cost && previous.mobility >= moving.mobility)) {
+                break;
+            }
+            children[j] = previous;
+        }
+        children[j] = moving;
+    }
+    return count;
+}
+
+} // namespace
+
+GameSolver::GameSolver(int tableBits)
+    : _tableMask(0)
+    , _generation(0)
+    , _nodes(0)
+    , _nodeLimit(DEFAULT_NODE_LIMIT)
+    , _aborted(false)
+{
+    if (tableBits < 1) {
+        tableBits = 1;
+    }
+    TableEntry empty = { 0, 0, 0, 0 };
+    _table.assign((size_t)1 << tableBits, empty);
+    _tableMask = ((uint64_t)1 << tableBits) - 1;
+}
+
+bool GameSolver::buildPosition(const GameModel* gameModel, Position& position)
+{
+    if (!gameModel) {
+        return false;
+    }
+    
+    int mainCounts[FACE_COUNT] = { 0 };
+    int handCounts[FACE_COUNT] = { 0 };
+    int reserveCounts[FACE_COUNT] = { 0 };
+    int mainRemaining = 0;
+    for (const auto* card : gameModel->getMainPileCards()) {
+        if (!card || card->getFace() < 0 || card->getFace() >= FACE_COUNT) {
+            return false;
+        }
+        ++mainCounts[card->getFace()];
+        ++mainRemaining;
+    }
+    for (const auto* card : gameModel->getReservePileCards()) {
+        if (!card || card->getFace() < 0 || card->getFace() >= FACE_COUNT) {
+            return false;
+        }
+        ++reserveCounts[card->getFace()];
+        ++handCounts[card->getFace()];
+    }
+    const CardModel* topCard = gameModel->getBottomPileTopCard();
+    if (topCard && (topCard->getFace() < 0 || topCard->getFace() >= FACE_COUNT)) {
+        return false;
+    }
+    position.topFace = topCard ? (int8_t)topCard->getFace() : (int8_t)-1;
+    if (topCard) {
+        ++handCounts[topCard->getFace()];
+    }
+    
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        if (mainCounts[face] > LevelSolver::MAX_FACE_COUNT || handCounts[face] > LevelSolver::MAX_FACE_COUNT) {
+            return false;
+        }
+        position.mainCounts[face] = (uint8_t)mainCounts[face];
+        position.reserveCounts[face] = (uint8_t)reserveCounts[face];
+    }
+    position.mainRemaining = (uint8_t)mainRemaining;
+    return true;
+}
+
+int GameSolver::countMinClicks(const Position& position)
+{
+    if (position.mainRemaining == 0) {
+        return 0;
+    }
+    // 先用廉价的下界排除大部分无解局面
+    PositionEvaluation evaluation;
+    if (!PositionEvaluator::evaluate(position, evaluation)) {
+        return -1;
+    }
+    LevelSolver::SolverState state;
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        state.mainCounts[face] = position.mainCounts[face];
+        state.handCounts[face] = position.reserveCounts[face];
+    }
+    if (position.topFace >= 0) {
+        ++state.handCounts[position.topFace];
+    }
+    state.mainRemaining = position.mainRemaining;
+    int swaps = LevelSolver::countMinSwaps(state, position.topFace);
+    return swaps < 0 ? -1 : position.mainRemaining + swaps;
+}
+
+bool GameSolver::solve(const GameModel* gameModel, GameSolveResult& result, long long nodeLimit)
+{
+    result.line.clear();
+    result.nodes = 0;
+    Position position;
+    if (!buildPosition(gameModel, position)) {
+        result.status = GSS_UNSUPPORTED;
+        return false;
+    }
+    if (!solvePosition(position, result, nodeLimit)) {
+        return false;
+    }
+    
+    // 按 TestScene 的规则在卡牌ID上重放面值序列：同面值取牌堆中的第一张，交换后原顶部进入备用牌的空位
+    std::vector<const CardModel*> mainCards(gameModel->getMainPileCards().begin(), gameModel->getMainPileCards().end());
+    std::vector<const CardModel*> reserveCards(gameModel->getReservePileCards().begin(), gameModel->getReservePileCards().end());
+    const CardModel* topCard = gameModel->getBottomPileTopCard();
+    for (auto& move : result.line) {
+        auto& cards = move.type == GMT_MAIN_TO_BOTTOM ? mainCards : reserveCards;
+        for (size_t i = 0; i < cards.size(); ++i) {
+            if (cards[i]->getFace() != move.face) {
+                continue;
+            }
+            move.cardId = cards[i]->getCardId();
+            if (move.type == GMT_MAIN_TO_BOTTOM) {
+                topCard = cards[i];
+                cards.erase(cards.begin() + i);
+            } else {
+                std::swap(topCard, cards[i]);
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+bool GameSolver::solvePosition(const Position& position, GameSolveResult& result, long long nodeLimit)
+{
+    result.line.clear();
+    ++_generation;
+    _nodes = 0;
+    _nodeLimit = nodeLimit;
+    _aborted = false;
+    _line.clear();
+    
+    int threshold = estimate(position);
+    if (position.mainRemaining == 0) {
+        result.status = GSS_SOLVED;
+    } else if (threshold >= INFINITE_COST) {
+        result.status = GSS_UNSOLVABLE;
+    } else {
+        // 局面可解时 search 总能找到解，阈值每轮增加到超出部分的最小估价
+        while (true) {
+            int next = search(position, 0, threshold);
+            if (next == FOUND) {
+                result.status = GSS_SOLVED;
+                result.line = _line;
+                break;
+            }
+            if (_aborted || next >= INFINITE_COST) {
+                result.status = _aborted ? GSS_NODE_LIMIT : GSS_UNSOLVABLE;
+                break;
+            }
+            threshold = next;
+        }
+    }
+    
+    result.nodes = _nodes;
+    return result.status == GSS_SOLVED;
+}
+
+int GameSolver::solveAll(const std::vector<const GameModel*>& gameModels, int threadCount,
+                         std::vector<GameSolveResult>& results, long long nodeLimit)
+{
+    const int count = (int)gameModels.size();
+    results.assign(gameModels.size(), GameSolveResult());
+    if (count == 0) {
+        return 0;
+    }
+    threadCount = ParallelUtils::resolveThreadCount(threadCount, count);
+    
+    // 单局求解只展开约“步数”个节点，拆分同一棵搜索树得不偿失；并行放在对局之间
+    std::vector<GameSolver> solvers(threadCount);
+    ParallelUtils::parallelFor(count, threadCount, [&](int threadIndex, long long index) {
+        solvers[threadIndex].solve(gameModels[index], results[index], nodeLimit);
+    });
+    
+    int solvedCount = 0;
+    for (const auto& result : results) {
+        solvedCount += result.status == GSS_SOLVED ? 1 : 0;
+    }
+    return solvedCount;
+}
+
+int GameSolver::search(const Position& position, int cost, int threshold)
+{
+    ++_nodes;
+    if (position.mainRemaining == 0) {
+        return FOUND;
+    }
+    if (_nodes > _nodeLimit) {
+        _aborted = true;
+        return INFINITE_COST;
+    }
+    
+    uint64_t mainKey;
+    uint64_t reserveKey;
+    makeKeys(position, mainKey, reserveKey);
+    TableEntry* entry = probe(mainKey, reserveKey);
+    int bound = estimate(position);
+    if (entry->generation == _generation && entry->mainKey == mainKey && entry->reserveKey == reserveKey
+        && entry->bound > bound) {
+        bound = entry->bound;
+    }
+    if (cost + bound > threshold) {
+        return cost + bound;
+    }
+    
+    Child children[MAX_CHILDREN];
+    int childCount = generateChildren(position, children);
+    int minExceeded = INFINITE_COST;
+    for (int i = 0; i < childCount; ++i) {
+        const Child& child = children[i];
+        if (child.swapFace >= 0) {
+            GameMove swap = { GMT_RESERVE_TO_BOTTOM, -1, (CardFaceType)child.swapFace };
+            _line.push_back(swap);
+        }
+        GameMove play = { GMT_MAIN_TO_BOTTOM, -1, (CardFaceType)child.mainFace };
+        _line.push_back(play);
+        
+        int result = search(child.position, cost + child.cost, threshold);
+        if (result == FOUND) {
+            return FOUND;
+        }
+        _line.resize(_line.size() - child.cost);
+        if (_aborted) {
+            return INFINITE_COST;
+        }
+        if (result < minExceeded) {
+            minExceeded = result;
+        }
+    }
+    
+    // 本局面的剩余代价至少为超出阈值的最小估价减去已花费的代价；置换表项总是覆盖写入
+    entry->mainKey = mainKey;
+    entry->reserveKey = reserveKey;
+    entry->generation = _generation;
+    entry->bound = minExceeded >= INFINITE_COST ? INFINITE_COST : minExceeded - cost;
+    return minExceeded;
+}
+
+GameSolver::TableEntry* GameSolver::probe(uint64_t mainKey, uint64_t reserveKey)
+{
+    uint64_t hash = mainKey * 0x9E3779B97F4A7C15ULL ^ reserveKey * 0xC2B2AE3D27D4EB4FULL;
+    hash ^= hash >> 29;
+    return &_table[(size_t)(hash & _tableMask)];
+}
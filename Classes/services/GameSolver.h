@@ -0,0 +1,178 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __GAME_SOLVER_H__
+#define __GAME_SOLVER_H__
+
+#include "../models/GameModel.h"
+#include "LevelSolver.h"
+#include "MoveGenerator.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * 求解结果状态
+ */
+enum GameSolveStatus
+{
+    GSS_SOLVED,         ///< 可解，已给出最短操作序列
+    GSS_UNSOLVABLE,     ///< 不可解
+    GSS_NODE_LIMIT,     ///< 超出节点上限，结论未知
+    GSS_UNSUPPORTED     ///< 对局无法表示（单一面值超过 LevelSolver::MAX_FACE_COUNT 张）
+};
+
+/**
+ * 求解结果
+ */
+struct GameSolveResult
+{
+    GameSolveStatus status;         ///< 结果状态
+    std::vector<GameMove> line;     ///< 最短操作序列（点击次数最少），仅 GSS_SOLVED 时有效
+    long long nodes;                ///< 展开的节点数
+    
+    GameSolveResult() : status(GSS_UNSUPPORTED), nodes(0) {}
+};
+
+/**
+ * 对局求解服务
+ * 职责：判断一局 GameModel 能否清空主牌堆，并给出点击次数最少的操作序列
+ * 使用场景：校验发牌是否可赢、提示、离线分析
+ *
+ * 规则与 TestScene::onCardClicked 一致：主牌与底牌顶部面值相差1即可接走，原顶部卡牌被移除；
+ * 备用牌可与底牌顶部无条件交换。抽牌（onDrawCard）把备用牌压到底牌上、原顶部被压住，
+ * 结果被交换同一张备用牌支配（点击数相同且保留更多手牌），因此不参与搜索。
+ *
+ * 搜索为带置换表的迭代加深（IDA*）：
+ * - 花色与位置不影响结果，局面只记录主牌与备用牌的面值计数和底牌顶部面值
+ * - 连续两次交换等价于直接交换到第二张，因此交换总是与随后的一次接牌合并为一步（代价2）
+ * - 下界为剩余主牌数加 LevelSolver::countMinSwaps 的最少交换次数，无解分支直接剪掉；
+ *   该下界在此规则下是准确的，第一轮即沿最优路径直达，置换表只在下界变弱时（规则扩展后）起作用
+ * - 后继按点击次数升序、顶部可接张数降序排列
+ * - 置换表保存每个局面剩余代价的下界，跨迭代复用
+ */
+class GameSolver
+{
+public:
+    static const int DEFAULT_TABLE_BITS = 14;           ///< 默认置换表大小（2^14 项）
+    static const long long DEFAULT_NODE_LIMIT = 1 << 22; ///< 默认节点上限
+    
+    /**
+     * 紧凑对局局面：按面值计数
+     */
+    struct Position
+    {
+        uint8_t mainCounts[LevelSolver::FACE_COUNT];    ///< 主牌堆剩余卡牌的面值计数
+        uint8_t reserveCounts[LevelSolver::FACE_COUNT]; ///< 备用牌堆的面值计数
+        int8_t topFace;                                 ///< 底牌顶部面值，-1表示无顶部卡牌
+        uint8_t mainRemaining;                          ///< 主牌堆剩余张数
+    };
+    
+    /**
+     * 构造函数
+     * @param tableBits 置换表大小为 2^tableBits 项
+     */
+    explicit GameSolver(int tableBits = DEFAULT_TABLE_BITS);
+    
+    /**
+     * 从游戏模型构建局面
+     * @param gameModel 游戏模型
+     * @param position 输出局面
+     * @return 是否可表示（主牌、备用牌加顶部的单一面值计数不超过 LevelSolver::MAX_FACE_COUNT）
+     */
+    static bool buildPosition(const GameModel* gameModel, Position& position);
+    
+    /**
+     * 计算局面最少还需的点击次数：剩余主牌数加 LevelSolver::countMinSwaps
+     * @param position 局面
+     * @return 最少点击次数，不可解返回-1
+     */
+    static int countMinClicks(const Position& position);
+    
+    /**
+     * 求解游戏模型的当前局面
+     * @param gameModel 游戏模型
+     * @param result 输出结果，操作序列中的卡牌ID对应该模型中的卡牌
+     * @param nodeLimit 节点上限
+     * @return 是否可解（result.status == GSS_SOLVED）
+     */
+    bool solve(const GameModel* gameModel, GameSolveResult& result, long long nodeLimit = DEFAULT_NODE_LIMIT);
+    
+    /**
+     * 求解局面，只给出面值序列
+     * @param position 局面
+     * @param result 输出结果，操作的 cardId 为-1
+     * @param nodeLimit 节点上限
+     * @return 是否可解
+     */
+    bool solvePosition(const Position& position, GameSolveResult& result, long long nodeLimit = DEFAULT_NODE_LIMIT);
+    
+    /**
+     * 多线程批量求解，每个线程持有独立的求解器与置换表，按下标领取对局
+     * 第 i 个结果总是对应第 i 个模型，内容与线程数和调度顺序无关
+     * @param gameModels 游戏模型列表（只读，可为nullptr，对应结果为 GSS_UNSUPPORTED）
+     * @param threadCount 线程数，<=0 时使用硬件并发数
+     * @param results 输出结果，长度与 gameModels 相同
+     * @param nodeLimit 单局节点上限
+     * @return 可解的对局数
+     */
+    static int solveAll(const std::vector<const GameModel*>& gameModels, int threadCount,
+                        std::vector<GameSolveResult>& results, long long nodeLimit = DEFAULT_NODE_LIMIT);
+
+private:
+    /**
+     * 置换表项
+     */
+    struct TableEntry
+    {
+        uint64_t mainKey;       ///< 主牌计数与顶部面值
+        uint64_t reserveKey;    ///< 备用牌计数
+        uint32_t generation;    ///< 写入时的求解序号，不同序号的项视为空
+        int32_t bound;          ///< 剩余代价的下界
+    };
+    
+    /**
+     * 在阈值内搜索
+     * @param position 局面
+     * @param cost 已花费的点击次数
+     * @param threshold 本轮阈值
+     * @return 找到解返回-1，否则返回超出阈值的最小估价
+     */
+    int search(const Position& position, int cost, int threshold);
+    
+    /**
+     * 查找局面对应的置换表槽位
+     * @return 槽位（可能属于其他局面，调用方比较键值）
+     */
+    TableEntry* probe(uint64_t mainKey, uint64_t reserveKey);
+    
+    std::vector<TableEntry> _table;     ///< 置换表，总是覆盖写入
+    uint64_t _tableMask;                ///< 下标掩码
+    uint32_t _generation;               ///< 当前求解序号，每次求解加1，免去清空置换表
+    long long _nodes;                   ///< 已展开节点数
+    long long _nodeLimit;               ///< 节点上限
+    bool _aborted;                      ///< 是否因超出节点上限而中止
+    std::vector<GameMove> _line;        ///< 当前搜索路径（只有面值）
+};
+
+#endif // __GAME_SOLVER_H__
@@ -0,0 +1,318 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "HintService.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+
+const int FACE_COUNT = LevelSolver::FACE_COUNT;
+const uint16_t FULL_MASK = (uint16_t)((1 << FACE_COUNT) - 1);
+
+/**
+ * 与掩码中任一面值相差1的面值集合（不循环）
+ */
+uint16_t neighbourMask(uint16_t mask)
+{
+    return (uint16_t)(((mask << 1) | (mask >> 1)) & FULL_MASK);
+}
+
+/**
+ * 主牌堆中与 face 相邻的卡牌张数，作为无解时的次级评分
+ */
+int countAdjacentMain(const GameSolver::Position& position, int face)
+{
+    int count = 0;
+    if (face > 0) {
+        count += position.mainCounts[face - 1];
+    }
+    if (face + 1 < FACE_COUNT) {
+        count += position.mainCounts[face + 1];
+    }
+    return count;
+}
+
+/**
+ * 执行一步操作后的局面
+ */
+GameSolver::Position playMove(const GameSolver::Position& position, GameMoveType type, int face)
+{
+    GameSolver::Position child = position;
+    if (type == GMT_MAIN_TO_BOTTOM) {
+        --child.mainCounts[face];
+        --child.mainRemaining;
+    } else {
+        --child.reserveCounts[face];
+        ++child.reserveCounts[position.topFace];
+    }
+    child.topFace = (int8_t)face;
+    return child;
+}
+
+} // namespace
+
+HintService::HintService()
+    : _valid(false)
+    , _mainMask(0)
+    , _reserveMask(0)
+    , _topCardId(-1)
+    , _version(0)
+    , _hasRequest(false)
+    , _resultVersion(0)
+    , _hasResult(false)
+    , _stopping(false)
+{
+}
+
+HintService::~HintService()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_one();
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+bool HintService::reset(const GameModel* gameModel)
+{
+    ++_version;
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        _mainCardIds[face].clear();
+        _reserveCardIds[face].clear();
+    }
+    _mainMask = 0;
+    _reserveMask = 0;
+    _topCardId = -1;
+    _valid = GameSolver::buildPosition(gameModel, _position);
+    if (!_valid) {
+        return false;
+    }
+    
+    for (const auto* card : gameModel->getMainPileCards()) {
+        _mainCardIds[card->getFace()].push_back(card->getCardId());
+        _mainMask |= (uint16_t)(1 << card->getFace());
+    }
+    for (const auto* card : gameModel->getReservePileCards()) {
+        _reserveCardIds[card->getFace()].push_back(card->getCardId());
+        _reserveMask |= (uint16_t)(1 << card->getFace());
+    }
+    const CardModel* topCard = gameModel->getBottomPileTopCard();
+    _topCardId = topCard ? topCard->getCardId() : -1;
+    return true;
+}
+
+bool HintService::applyMove(const GameMove& move)
+{
+    int face = move.face;
+    int topFace = _position.topFace;
+    if (!_valid || topFace < 0 || face < 0 || face >= FACE_COUNT) {
+        return false;
+    }
+    
+    if (move.type == GMT_MAIN_TO_BOTTOM) {
+        auto& cardIds = _mainCardIds[face];
+        auto found = std::find(cardIds.begin(), cardIds.end(), move.cardId);
+        if (found == cardIds.end() || std::abs(face - topFace) != 1) {
+            return false;
+        }
+        cardIds.erase(found);
+        if (cardIds.empty()) {
+            _mainMask &= (uint16_t)~(1 << face);
+        }
+    } else {
+        auto& cardIds = _reserveCardIds[face];
+        auto found = std::find(cardIds.begin(), cardIds.end(), move.cardId);
+        if (found == cardIds.end()) {
+            return false;
+        }
+        cardIds.erase(found);
+        if (cardIds.empty()) {
+            _reserveMask &= (uint16_t)~(1 << face);
+        }
+        // 原顶部卡牌换到备用牌堆
+        _reserveCardIds[topFace].push_back(_topCardId);
+        _reserveMask |= (uint16_t)(1 << topFace);
+    }
+    _position = playMove(_position, move.type, face);
+    _topCardId = move.cardId;
+    ++_version;
+    return true;
+}
+
+Hint HintService::findHint(int budgetMicros) const
+{
+    if (!_valid) {
+        return Hint();
+    }
+    return resolveHint(evaluate(_position, _mainMask, _reserveMask, budgetMicros));
+}
+
+void HintService::requestHint(int budgetMicros)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _request.position = _position;
+        _request.mainMask = _valid ? _mainMask : 0;
+        _request.reserveMask = _valid ? _reserveMask : 0;
+        _request.version = _version;
+        _request.budgetMicros = budgetMicros;
+        _hasRequest = true;
+        if (!_worker.joinable()) {
+            _worker = std::thread(&HintService::workerLoop, this);
+        }
+    }
+    _condition.notify_one();
+}
+
+bool HintService::pollHint(Hint& hint)
+{
+    FaceHint result;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_hasResult || _resultVersion != _version) {
+            return false;
+        }
+        result = _result;
+        _hasResult = false;
+    }
+    hint = _valid ? resolveHint(result) : Hint();
+    return true;
+}
+
+HintService::FaceHint HintService::evaluate(const GameSolver::Position& position, uint16_t mainMask,
+                                            uint16_t reserveMask, int budgetMicros)
+{
+    FaceHint hint = { false, GMT_MAIN_TO_BOTTOM, -1, -1, true };
+    int topFace = position.topFace;
+    if (topFace < 0 || mainMask == 0) {
+        return hint;
+    }
+    
+    // 候选：可直接接走的主牌，以及交换后能接走某张主牌的备用牌面值；先试接牌，它不消耗备用牌
+    uint16_t topMask = (uint16_t)(1 << topFace);
+    uint16_t candidates[2] = {
+        (uint16_t)(mainMask & neighbourMask(topMask)),
+        (uint16_t)(reserveMask & ~topMask & neighbourMask(mainMask))
+    };
+    const GameMoveType types[2] = { GMT_MAIN_TO_BOTTOM, GMT_RESERVE_TO_BOTTOM };
+    
+    // 当前局面的最少点击数已知，评分达到 target 的候选必然最优
+    int target = GameSolver::countMinClicks(position);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(budgetMicros);
+    bool evaluated = false;
+    for (int kind = 0; kind < 2 && target > 0; ++kind) {
+        for (int face = 0; face < FACE_COUNT; ++face) {
+            if (!(candidates[kind] & (1 << face))) {
+                continue;
+            }
+            if (evaluated && std::chrono::steady_clock::now() >= deadline) {
+                hint.complete = false;
+                break;
+            }
+            evaluated = true;
+            int clicks = GameSolver::countMinClicks(playMove(position, types[kind], face));
+            if (clicks >= 0 && (hint.score < 0 || clicks + 1 < hint.score)) {
+                hint.valid = true;
+                hint.type = types[kind];
+                hint.face = face;
+                hint.score = clicks + 1;
+                if (hint.score == target) {
+                    return hint;
+                }
+            }
+        }
+        if (!hint.complete) {
+            break;
+        }
+    }
+    if (hint.valid) {
+        return hint;
+    }
+    
+    // 已无法取胜（或预算内没有评估到可胜的候选）：优先接牌，其次让顶部可接张数最多
+    int bestMobility = -1;
+    for (int kind = 0; kind < 2 && !hint.valid; ++kind) {
+        for (int face = 0; face < FACE_COUNT; ++face) {
+            if (!(candidates[kind] & (1 << face))) {
+                continue;
+            }
+            int mobility = countAdjacentMain(playMove(position, types[kind], face), face);
+            if (mobility > bestMobility) {
+                bestMobility = mobility;
+                hint.type = types[kind];
+                hint.face = face;
+            }
+        }
+        hint.valid = bestMobility >= 0;
+    }
+    return hint;
+}
+
+Hint HintService::resolveHint(const FaceHint& faceHint) const
+{
+    Hint hint;
+    if (!faceHint.valid) {
+        hint.complete = faceHint.complete;
+        return hint;
+    }
+    const auto& cardIds = faceHint.type == GMT_MAIN_TO_BOTTOM ? _mainCardIds[faceHint.face]
+                                                              : _reserveCardIds[faceHint.face];
+    if (cardIds.empty()) {
+        return hint;
+    }
+    hint.valid = true;
+    hint.move.type = faceHint.type;
+    hint.move.cardId = cardIds.back();
+    hint.move.face = (CardFaceType)faceHint.face;
+    hint.score = faceHint.score;
+    hint.complete = faceHint.complete;
+    return hint;
+}
+
+void HintService::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this]() { return _hasRequest || _stopping; });
+        if (_stopping) {
+            return;
+        }
+        Request request = _request;
+        _hasRequest = false;
+        
+        lock.unlock();
+        FaceHint result = evaluate(request.position, request.mainMask, request.reserveMask, request.budgetMicros);
+        lock.lock();
+        
+        _result = result;
+        _resultVersion = request.version;
+        _hasResult = true;
+    }
+}
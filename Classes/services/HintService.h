@@ -0,0 +1,182 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __HINT_SERVICE_H__
+#define __HINT_SERVICE_H__
+
+#include "GameSolver.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 提示结果
+ */
+struct Hint
+{
+    bool valid;         ///< 是否有可走的操作
+    GameMove move;      ///< 建议的操作，cardId 对应当前模型中的卡牌
+    int score;          ///< 走这一步后取胜所需的最少点击次数（含这一步），-1表示已无法取胜
+    bool complete;      ///< 是否在时间预算内评估了全部候选；为false时 move 是已评估候选中最好的
+    
+    Hint() : valid(false), score(-1), complete(false)
+    {
+        move.type = GMT_MAIN_TO_BOTTOM;
+        move.cardId = -1;
+        move.face = CFT_NONE;
+    }
+};
+
+/**
+ * 提示服务
+ * 职责：给出当前局面下最好的下一步操作及其评分，可在后台线程计算
+ * 使用场景：玩家停顿时高亮建议点击的卡牌
+ *
+ * 规则与 GameSolver 一致。服务持有一份按面值计数的局面快照，reset 时从模型完整构建一次，
+ * 之后每步操作由 applyMove 增量更新；候选操作直接由主牌与备用牌的面值位掩码生成：
+ * 可接的主牌为 mainMask 中与顶部相邻的面值，值得交换的备用牌为与某张主牌相邻、且不同于顶部的面值。
+ * 每个候选用 GameSolver::countMinClicks 精确评分，评分等于当前局面最少点击数减一的候选即为最优，立即返回。
+ */
+class HintService
+{
+public:
+    static const int DEFAULT_TIME_BUDGET_MICROS = 2000;  ///< 默认时间预算（微秒）
+    
+    /**
+     * 构造函数
+     */
+    HintService();
+    
+    /**
+     * 析构函数，停止并等待后台线程
+     */
+    ~HintService();
+    
+    /**
+     * 从游戏模型完整重建局面快照
+     * 加载、撤销、抽牌、热重载等非逐步变化后调用
+     * @param gameModel 游戏模型
+     * @return 模型能否被表示；不能表示时之后的提示均无效
+     */
+    bool reset(const GameModel* gameModel);
+    
+    /**
+     * 按一步已执行的操作增量更新局面快照
+     * @param move 操作，face 为被点击卡牌的面值
+     * @return 操作与快照是否一致；不一致时快照不变，调用方应改用 reset
+     */
+    bool applyMove(const GameMove& move);
+    
+    /**
+     * 在调用线程上计算提示
+     * 至少评估一个候选，之后每评估一个候选检查一次时间预算
+     * @param budgetMicros 时间预算（微秒）
+     * @return 提示结果
+     */
+    Hint findHint(int budgetMicros = DEFAULT_TIME_BUDGET_MICROS) const;
+    
+    /**
+     * 请求在后台线程计算当前快照的提示，新的请求覆盖尚未开始的旧请求
+     * 需在主线程调用；结果通过 pollHint 取回
+     * @param budgetMicros 时间预算（微秒）
+     */
+    void requestHint(int budgetMicros = DEFAULT_TIME_BUDGET_MICROS);
+    
+    /**
+     * 取回后台计算完成的提示
+     * 需在主线程调用；计算期间快照已变化的结果会被丢弃
+     * @param hint 输出提示
+     * @return 是否取到与当前快照对应的结果
+     */
+    bool pollHint(Hint& hint);
+
+private:
+    /**
+     * 只按面值给出的提示，由 resolveHint 对应到卡牌ID
+     */
+    struct FaceHint
+    {
+        bool valid;             ///< 是否有可走的操作
+        GameMoveType type;      ///< 操作类型
+        int face;               ///< 被点击卡牌的面值
+        int score;              ///< 最少点击次数（含这一步），-1表示已无法取胜
+        bool complete;          ///< 是否评估了全部候选
+    };
+    
+    /**
+     * 后台线程的计算请求
+     */
+    struct Request
+    {
+        GameSolver::Position position;  ///< 请求时的局面
+        uint16_t mainMask;              ///< 请求时的主牌面值位掩码
+        uint16_t reserveMask;           ///< 请求时的备用牌面值位掩码
+        unsigned int version;           ///< 请求时的快照版本
+        int budgetMicros;               ///< 时间预算
+    };
+    
+    /**
+     * 在局面上评估全部候选操作
+     * @param position 局面
+     * @param mainMask 主牌面值位掩码
+     * @param reserveMask 备用牌面值位掩码
+     * @param budgetMicros 时间预算（微秒）
+     * @return 按面值给出的提示
+     */
+    static FaceHint evaluate(const GameSolver::Position& position, uint16_t mainMask, uint16_t reserveMask,
+                             int budgetMicros);
+    
+    /**
+     * 把按面值给出的提示对应到当前快照中的一张卡牌
+     */
+    Hint resolveHint(const FaceHint& faceHint) const;
+    
+    /**
+     * 后台线程循环：等待请求、计算、保存结果
+     */
+    void workerLoop();
+    
+    bool _valid;                                            ///< 快照是否有效
+    GameSolver::Position _position;                         ///< 按面值计数的局面快照
+    uint16_t _mainMask;                                     ///< 主牌堆中存在的面值，第 f 位对应面值 f
+    uint16_t _reserveMask;                                  ///< 备用牌堆中存在的面值
+    std::vector<int> _mainCardIds[LevelSolver::FACE_COUNT];    ///< 主牌堆每种面值的卡牌ID
+    std::vector<int> _reserveCardIds[LevelSolver::FACE_COUNT]; ///< 备用牌堆每种面值的卡牌ID
+    int _topCardId;                                         ///< 底牌顶部卡牌ID，-1表示无
+    unsigned int _version;                                  ///< 快照版本，每次变化加1（只在主线程读写）
+    
+    std::thread _worker;                    ///< 后台线程，首次请求时启动
+    std::mutex _mutex;                      ///< 保护以下成员
+    std::condition_variable _condition;     ///< 唤醒后台线程
+    Request _request;                       ///< 待处理的请求
+    bool _hasRequest;                       ///< 是否有待处理的请求
+    FaceHint _result;                       ///< 最近一次完成的结果
+    unsigned int _resultVersion;            ///< 结果对应的快照版本
+    bool _hasResult;                        ///< 是否有未取回的结果
+    bool _stopping;                         ///< 是否要求后台线程退出
+};
+
+#endif // __HINT_SERVICE_H__
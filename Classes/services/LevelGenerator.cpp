@@ -0,0 +1,248 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LevelGenerator.h"
+#include "../utils/DealRandom.h"
+#include "../utils/ParallelUtils.h"
+#include <algorithm>
+
+namespace {
+
+const int FULL_DECK_SIZE = 52;              ///< 一副牌的张数
+const int LAYOUT_MAX_ROWS = 8;              ///< 主牌堆最多行数
+const int LAYOUT_CENTER_COLUMN = 8;         ///< 半格列坐标的中心列
+const float LAYOUT_COLUMN_STEP = 60.0f;     ///< 半格列间距（卡牌宽度的一半）
+const float LAYOUT_ROW_STEP = 170.0f;       ///< 行间距（略大于卡牌高度，卡牌互不遮挡）
+const float LAYOUT_CENTER_X = 540.0f;       ///< 主牌堆区域中心
+const float LAYOUT_CENTER_Y = 1150.0f;
+const CoreVec2 BOTTOM_PILE_POSITION(540.0f, 200.0f);   ///< 与现有关卡一致的底牌位置
+const float RESERVE_PILE_LEFT = 100.0f;                     ///< 备用牌最左侧位置
+const float RESERVE_PILE_WIDTH = 280.0f;                    ///< 备用牌可用宽度（不与底牌重叠）
+const float RESERVE_PILE_STEP = 125.0f;                     ///< 备用牌最大间距
+const float RESERVE_PILE_Y = 200.0f;
+
+/**
+ * 获取布局某一行占用的半格列坐标（0-16，相邻卡牌相差2列）
+ * @param layout 布局类型
+ * @param row 行号，0为最上方
+ * @param columns 输出列坐标
+ */
+void getRowColumns(LevelLayoutType layout, int row, std::vector<int>& columns)
+{
+    columns.clear();
+    switch (layout) {
+        case LLT_PEAKS:
+            if (row == 0) {
+                // 三座山峰的峰顶
+                for (int peak = 0; peak < 3; ++peak) {
+                    columns.push_back(2 + peak * 6);
+                }
+            } else if (row == 1) {
+                for (int peak = 0; peak < 3; ++peak) {
+                    columns.push_back(1 + peak * 6);
+                    columns.push_back(3 + peak * 6);
+                }
+            } else {
+                for (int column = 0; column <= 16; column += 2) {
+                    columns.push_back(column);
+                }
+            }
+            break;
+        case LLT_PYRAMID:
+            for (int column = LAYOUT_CENTER_COLUMN - row; column <= LAYOUT_CENTER_COLUMN + row; column += 2) {
+                columns.push_back(column);
+            }
+            break;
+        case LLT_GRID:
+            for (int column = 2; column <= 14; column += 2) {
+                columns.push_back(column);
+            }
+            break;
+    }
+}
+
+/**
+ * 获取布局最多可容纳的卡牌数
+ */
+int getLayoutCapacity(LevelLayoutType layout)
+{
+    int capacity = 0;
+    std::vector<int> columns;
+    for (int row = 0; row < LAYOUT_MAX_ROWS; ++row) {
+        getRowColumns(layout, row, columns);
+        capacity += (int)columns.size();
+    }
+    return capacity;
+}
+
+inline int getDeckFace(uint8_t card) { return card % 13; }
+inline int getDeckSuit(uint8_t card) { return (card / 13) % 4; }
+
+} // namespace
+
+LevelConfig* LevelGenerator::generateLevel(const LevelGenerateParams& params, uint64_t seed, uint64_t dealIndex,
+                                          int* attempts)
+{
+    if (attempts) {
+        *attempts = 0;
+    }
+    if (!isValidParams(params)) {
+        return nullptr;
+    }
+    
+    // 牌堆中每张牌以 0-51 编号（多副牌时编号 52 以上取模），发牌顺序为 主牌堆、底牌、备用牌
+    std::vector<uint8_t> deck(params.deckCount * FULL_DECK_SIZE);
+    for (size_t i = 0; i < deck.size(); ++i) {
+        deck[i] = (uint8_t)i;
+    }
+    
+    DealRandom random(seed, dealIndex);
+    const int mainCount = params.mainCardCount;
+    const int reserveCount = params.reserveCardCount;
+    for (int attempt = 1; attempt <= params.maxAttempts; ++attempt) {
+        random.shuffle(deck.begin(), deck.size());
+        
+        LevelSolver::SolverState state = {};
+        state.mainRemaining = mainCount;
+        for (int i = 0; i < mainCount; ++i) {
+            ++state.mainCounts[getDeckFace(deck[i])];
+        }
+        for (int i = mainCount; i <= mainCount + reserveCount; ++i) {
+            ++state.handCounts[getDeckFace(deck[i])];
+        }
+        if (!LevelSolver::isSolvable(state)) {
+            continue;
+        }
+        
+        if (attempts) {
+            *attempts = attempt;
+        }
+        
+        std::vector<CoreVec2> positions;
+        buildLayout(params.layout, mainCount, positions);
+        
+        LevelConfig* levelConfig = new LevelConfig();
+        for (int i = 0; i < mainCount; ++i) {
+            levelConfig->addMainPileCard(LevelConfig::CardConfig(getDeckFace(deck[i]), getDeckSuit(deck[i]), positions[i]));
+        }
+        levelConfig->addBottomPileCard(LevelConfig::CardConfig(getDeckFace(deck[mainCount]), getDeckSuit(deck[mainCount]),
+                                                               BOTTOM_PILE_POSITION));
+        float reserveStep = reserveCount > 1 ? std::min(RESERVE_PILE_STEP, RESERVE_PILE_WIDTH / (reserveCount - 1)) : 0.0f;
+        for (int i = 0; i < reserveCount; ++i) {
+            uint8_t card = deck[mainCount + 1 + i];
+            levelConfig->addReservePileCard(LevelConfig::CardConfig(getDeckFace(card), getDeckSuit(card),
+                CoreVec2(RESERVE_PILE_LEFT + reserveStep * i, RESERVE_PILE_Y)));
+        }
+        return levelConfig;
+    }
+    
+    if (attempts) {
+        *attempts = params.maxAttempts;
+    }
+    return nullptr;
+}
+
+long long LevelGenerator::generateLevels(const LevelGenerateParams& params, uint64_t seed, uint64_t firstDealIndex,
+                                         int count, int threadCount, std::vector<LevelConfig*>& levels)
+{
+    levels.assign(count > 0 ? count : 0, nullptr);
+    if (count <= 0) {
+        return 0;
+    }
+    
+    // 每个下标对应的牌局编号固定，因此输出与线程调度无关
+    std::vector<int> attempts(count, 0);
+    ParallelUtils::parallelFor(count, threadCount, [&](int threadIndex, long long index) {
+        levels[index] = generateLevel(params, seed, firstDealIndex + index, &attempts[index]);
+    });
+    
+    long long totalAttempts = 0;
+    for (int value : attempts) {
+        totalAttempts += value;
+    }
+    return totalAttempts;
+}
+
+void LevelGenerator::buildLayout(LevelLayoutType layout, int cardCount, std::vector<CoreVec2>& positions)
+{
+    positions.clear();
+    
+    // 先确定行数，使整体在主牌区垂直居中
+    std::vector<int> columns;
+    int rowCount = 0;
+    for (int placed = 0; placed < cardCount && rowCount < LAYOUT_MAX_ROWS; ++rowCount) {
+        getRowColumns(layout, rowCount, columns);
+        placed += (int)columns.size();
+    }
+    
+    for (int row = 0; row < rowCount; ++row) {
+        getRowColumns(layout, row, columns);
+        int used = std::min((int)columns.size(), cardCount - (int)positions.size());
+        // 未排满的最后一行整体居中
+        float shift = (columns[columns.size() - 1] - columns[used - 1]) * 0.5f;
+        float y = LAYOUT_CENTER_Y + ((rowCount - 1) * 0.5f - row) * LAYOUT_ROW_STEP;
+        for (int i = 0; i < used; ++i) {
+            float x = LAYOUT_CENTER_X + (columns[i] + shift - LAYOUT_CENTER_COLUMN) * LAYOUT_COLUMN_STEP;
+            positions.push_back(CoreVec2(x, y));
+        }
+    }
+}
+
+bool LevelGenerator::isValidParams(const LevelGenerateParams& params)
+{
+    if (params.mainCardCount < 1 || params.mainCardCount > MAX_MAIN_CARDS ||
+        params.mainCardCount > getLayoutCapacity(params.layout)) {
+        return false;
+    }
+    if (params.reserveCardCount < 0 || params.reserveCardCount > MAX_RESERVE_CARDS) {
+        return false;
+    }
+    if (params.deckCount < 1 || params.deckCount > MAX_DECK_COUNT ||
+        params.mainCardCount + 1 + params.reserveCardCount > params.deckCount * FULL_DECK_SIZE) {
+        return false;
+    }
+    return params.maxAttempts > 0;
+}
+
+const char* LevelGenerator::getLayoutName(LevelLayoutType layout)
+{
+    switch (layout) {
+        case LLT_PEAKS:   return "peaks";
+        case LLT_PYRAMID: return "pyramid";
+        case LLT_GRID:    return "grid";
+    }
+    return "unknown";
+}
+
+bool LevelGenerator::parseLayoutName(const std::string& name, LevelLayoutType& layout)
+{
+    const LevelLayoutType layouts[] = { LLT_PEAKS, LLT_PYRAMID, LLT_GRID };
+    for (LevelLayoutType candidate : layouts) {
+        if (name == getLayoutName(candidate)) {
+            layout = candidate;
+            return true;
+        }
+    }
+    return false;
+}
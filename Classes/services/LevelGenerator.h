@@ -0,0 +1,131 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __LEVEL_GENERATOR_H__
+#define __LEVEL_GENERATOR_H__
+
+#include "../configs/models/LevelConfig.h"
+#include "LevelSolver.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * 主牌堆布局类型
+ */
+enum LevelLayoutType
+{
+    LLT_PEAKS,      ///< 三座山峰
+    LLT_PYRAMID,    ///< 单个金字塔
+    LLT_GRID        ///< 网格
+};
+
+/**
+ * 关卡生成参数
+ */
+struct LevelGenerateParams
+{
+    LevelLayoutType layout;     ///< 主牌堆布局
+    int mainCardCount;          ///< 主牌堆张数
+    int reserveCardCount;       ///< 备用牌堆张数
+    int deckCount;              ///< 使用几副牌（每副52张）
+    int maxAttempts;            ///< 单个关卡最多尝试的发牌次数
+    
+    LevelGenerateParams()
+        : layout(LLT_PEAKS)
+        , mainCardCount(18)
+        , reserveCardCount(3)
+        , deckCount(1)
+        , maxAttempts(1000)
+    {}
+};
+
+/**
+ * 关卡生成服务
+ * 职责：按布局摆放主牌堆，从种子确定的牌堆中发牌，并用求解器校验可解后输出 LevelConfig
+ * 使用场景：离线批量生成关卡、运行时生成每日关卡；输出与 JSON 关卡完全相同的结构，
+ *           可直接交给 GameModelFromLevelGenerator 使用
+ */
+class LevelGenerator
+{
+public:
+    static const int MAX_MAIN_CARDS = 48;       ///< 主牌堆张数上限（布局最多8行）
+    static const int MAX_RESERVE_CARDS = 4;     ///< 备用牌堆张数上限
+    static const int MAX_DECK_COUNT = 3;        ///< 牌副数上限（受求解器面值计数上限约束）
+    
+    /**
+     * 生成单个可解关卡；同一参数、种子与牌局编号总是得到同一关卡
+     * @param params 生成参数
+     * @param seed 随机种子
+     * @param dealIndex 牌局编号，随机序列可直接跳转到第 k 局
+     * @param attempts 可选，输出实际发牌次数
+     * @return 关卡配置（调用方负责释放），参数非法或尝试次数用尽返回nullptr
+     */
+    static LevelConfig* generateLevel(const LevelGenerateParams& params, uint64_t seed, uint64_t dealIndex,
+                                      int* attempts = nullptr);
+    
+    /**
+     * 多线程批量生成关卡，第 i 个关卡为第 firstDealIndex + i 局，结果与线程数无关
+     * @param params 生成参数
+     * @param seed 随机种子
+     * @param firstDealIndex 第一个关卡的牌局编号
+     * @param count 关卡数量
+     * @param threadCount 线程数，<=0 时使用硬件并发数
+     * @param levels 输出关卡列表（长度为 count，生成失败的位置为nullptr）
+     * @return 所有关卡的发牌次数总和
+     */
+    static long long generateLevels(const LevelGenerateParams& params, uint64_t seed, uint64_t firstDealIndex,
+                                    int count, int threadCount, std::vector<LevelConfig*>& levels);
+    
+    /**
+     * 计算主牌堆布局位置，从上到下、从左到右排列
+     * @param layout 布局类型
+     * @param cardCount 张数
+     * @param positions 输出位置
+     */
+    static void buildLayout(LevelLayoutType layout, int cardCount, std::vector<CoreVec2>& positions);
+    
+    /**
+     * 检查生成参数是否合法
+     * @param params 生成参数
+     * @return 是否合法
+     */
+    static bool isValidParams(const LevelGenerateParams& params);
+    
+    /**
+     * 获取布局名称
+     * @param layout 布局类型
+     * @return 名称
+     */
+    static const char* getLayoutName(LevelLayoutType layout);
+    
+    /**
+     * 按名称解析布局类型
+     * @param name 名称（peaks/pyramid/grid）
+     * @param layout 输出布局类型
+     * @return 是否解析成功
+     */
+    static bool parseLayoutName(const std::string& name, LevelLayoutType& layout);
+};
+
+#endif // __LEVEL_GENERATOR_H__
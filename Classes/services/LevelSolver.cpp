@@ -0,0 +1,333 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LevelSolver.h"
+
+namespace {
+
+/**
+ * 动态规划状态：处理到某个面值 f 之前，边 (f-1, f) 上的流量以及所在连通段的情况
+ *
+ * 把每张手牌看作面值轴上的一枚棋子，一步操作即棋子移动到相邻面值并消耗那里的一张主牌。
+ * 各棋子之间只共享主牌数量，与先后顺序无关，因此可解等价于：存在每条边上向右 r、向左 l
+ * 的移动次数，使每个面值被进入的次数恰好等于其主牌数，且每个有移动的连通段里至少有一枚棋子
+ * （由有向欧拉回路可拆成从各棋子出发的路径）。进入 f 的次数为 r(f-1) + l(f)，
+ * 离开 f 的次数为 r(f) + l(f-1)，两者之差由从 f 出发、停在 f 的棋子数吸收。
+ */
+struct FlowState
+{
+    int rightFlow;      ///< r(f-1)
+    int leftFlow;       ///< l(f-1)
+    bool open;          ///< 边 (f-1, f) 上是否有移动
+    bool hasToken;      ///< 所在连通段是否已有棋子
+};
+
+const int FLOW_LIMIT = LevelSolver::MAX_FACE_COUNT + 1;
+
+/**
+ * 可达状态表，按 (r, l, open, hasToken) 索引
+ */
+struct FlowLayer
+{
+    bool reachable[FLOW_LIMIT][FLOW_LIMIT][2][2];
+    
+    /**
+     * 只清空会被用到的区域：r 不超过下一面值的主牌数，l 不超过当前面值的主牌数
+     */
+    void clear(int rightLimit, int leftLimit)
+    {
+        for (int r = 0; r <= rightLimit; ++r) {
+            for (int l = 0; l <= leftLimit; ++l) {
+                reachable[r][l][0][0] = reachable[r][l][0][1] = false;
+                reachable[r][l][1][0] = reachable[r][l][1][1] = false;
+            }
+        }
+    }
+};
+
+/**
+ * 最少交换次数的动态规划层，按 (r, l, 连通段标记) 索引，值为到目前为止的“路径数 - 顶部奖励”
+ *
+ * 一个连通段可拆成 max(1, 段内各面值出发多余次数之和) 条路径：有多余出发次数的面值 f 恰好开始 a(f) 条，
+ * 没有时整段是一条回路，可从段内任意一张手牌出发。路径之间互不影响，可以逐条走完；
+ * 底牌顶部若能开始其中一条路径（a(top) > 0，或 top 位于回路段内）就省下一次交换。
+ */
+struct SwapLayer
+{
+    /**
+     * 连通段标记：SEGMENT_EXCESS 表示段内已有多余出发次数；
+     * 否则为 SEGMENT_BALANCED + 有手牌(1) + 含顶部面值(2)
+     */
+    enum
+    {
+        SEGMENT_EXCESS = 0,
+        SEGMENT_BALANCED = 1,
+        SEGMENT_FLAG_COUNT = 5
+    };
+    
+    static const int UNREACHABLE = 1 << 20;
+    
+    int cost[FLOW_LIMIT][FLOW_LIMIT][SEGMENT_FLAG_COUNT];
+    
+    void clear(int rightLimit, int leftLimit)
+    {
+        for (int r = 0; r <= rightLimit; ++r) {
+            for (int l = 0; l <= leftLimit; ++l) {
+                for (int flag = 0; flag < SEGMENT_FLAG_COUNT; ++flag) {
+                    cost[r][l][flag] = UNREACHABLE;
+                }
+            }
+        }
+    }
+    
+    void relax(int r, int l, int flag, int value)
+    {
+        if (value < cost[r][l][flag]) {
+            cost[r][l][flag] = value;
+        }
+    }
+};
+
+} // namespace
+
+bool LevelSolver::buildState(const LevelConfig* levelConfig, SolverState& state)
+{
+    if (!levelConfig) {
+        return false;
+    }
+    
+    int mainCounts[FACE_COUNT] = { 0 };
+    int handCounts[FACE_COUNT] = { 0 };
+    for (const auto& card : levelConfig->getMainPileCards()) {
+        ++mainCounts[card.cardFace];
+    }
+    // 只有底牌堆顶部可参与匹配，其下方的牌已被压住
+    const auto& bottomCards = levelConfig->getBottomPileCards();
+    if (!bottomCards.empty()) {
+        ++handCounts[bottomCards.back().cardFace];
+        // TestScene 的交换操作要求底牌堆有顶部卡牌，否则备用牌无法进入手牌
+        for (const auto& card : levelConfig->getReservePileCards()) {
+            ++handCounts[card.cardFace];
+        }
+    }
+    
+    state.mainRemaining = (int)levelConfig->getMainPileCards().size();
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        if (mainCounts[face] > MAX_FACE_COUNT || handCounts[face] > MAX_FACE_COUNT) {
+            return false;
+        }
+        state.mainCounts[face] = (uint8_t)mainCounts[face];
+        state.handCounts[face] = (uint8_t)handCounts[face];
+    }
+    return true;
+}
+
+bool LevelSolver::isSolvable(const SolverState& state)
+{
+    FlowLayer layers[2];
+    layers[0].clear(state.mainCounts[0], 0);
+    layers[0].reachable[0][0][0][0] = true;
+    int previousMainCount = 0;
+    
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        const FlowLayer& current = layers[face & 1];
+        FlowLayer& next = layers[(face + 1) & 1];
+        const int mainCount = state.mainCounts[face];
+        const int handCount = state.handCounts[face];
+        // r(f) 不能超过下一个面值的主牌数，否则 l(f+1) 为负；l(f-1) 同理不超过上一面值的主牌数
+        const int nextMainCount = face + 1 < FACE_COUNT ? state.mainCounts[face + 1] : 0;
+        next.clear(nextMainCount, mainCount);
+        bool anyReachable = false;
+        
+        for (int rightIn = 0; rightIn <= mainCount; ++rightIn) {
+            // 进入 f 的次数必须等于主牌数：l(f) = main(f) - r(f-1)
+            const int leftOut = mainCount - rightIn;
+            if (face + 1 == FACE_COUNT && leftOut != 0) {
+                continue;
+            }
+            for (int leftIn = 0; leftIn <= previousMainCount; ++leftIn) {
+                for (int open = 0; open < 2; ++open) {
+                    for (int hasToken = 0; hasToken < 2; ++hasToken) {
+                        if (!current.reachable[rightIn][leftIn][open][hasToken]) {
+                            continue;
+                        }
+                        bool segmentToken = (open && hasToken) || handCount > 0;
+                        // 从 f 出发的棋子数 a = max(0, r(f) + l(f-1) - main(f))，不能超过手牌数
+                        int rightOutLimit = mainCount + handCount - leftIn;
+                        if (rightOutLimit > nextMainCount) {
+                            rightOutLimit = nextMainCount;
+                        }
+                        for (int rightOut = 0; rightOut <= rightOutLimit; ++rightOut) {
+                            bool nextOpen = rightOut + leftOut > 0;
+                            if (!nextOpen && open && !segmentToken) {
+                                // 连通段在 f 处结束却没有任何棋子
+                                continue;
+                            }
+                            next.reachable[rightOut][leftOut][nextOpen][nextOpen && segmentToken] = true;
+                            anyReachable = true;
+                        }
+                    }
+                }
+            }
+        }
+        
+        if (!anyReachable) {
+            return false;
+        }
+        previousMainCount = mainCount;
+    }
+    
+    return layers[FACE_COUNT & 1].reachable[0][0][0][0];
+}
+
+int LevelSolver::countMinSwaps(const SolverState& state, int topFace)
+{
+    // 与 isSolvable 相同的流量模型，把可达性换成最小代价
+    SwapLayer layers[2];
+    layers[0].clear(state.mainCounts[0], 0);
+    layers[0].cost[0][0][SwapLayer::SEGMENT_BALANCED] = 0;
+    int previousMainCount = 0;
+    
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        const SwapLayer& current = layers[face & 1];
+        SwapLayer& next = layers[(face + 1) & 1];
+        const int mainCount = state.mainCounts[face];
+        const int handCount = state.handCounts[face];
+        const int nextMainCount = face + 1 < FACE_COUNT ? state.mainCounts[face + 1] : 0;
+        const int vertexFlags = (handCount > 0 ? 1 : 0) | (face == topFace ? 2 : 0);
+        next.clear(nextMainCount, mainCount);
+        bool anyReachable = false;
+        
+        for (int rightIn = 0; rightIn <= mainCount; ++rightIn) {
+            const int leftOut = mainCount - rightIn;
+            if (face + 1 == FACE_COUNT && leftOut != 0) {
+                continue;
+            }
+            for (int leftIn = 0; leftIn <= previousMainCount; ++leftIn) {
+                const bool open = rightIn + leftIn > 0;
+                for (int flag = 0; flag < SwapLayer::SEGMENT_FLAG_COUNT; ++flag) {
+                    const int cost = current.cost[rightIn][leftIn][flag];
+                    if (cost >= SwapLayer::UNREACHABLE) {
+                        continue;
+                    }
+                    // 没有入边时 f 开始新的连通段
+                    const int segmentFlag = open ? flag : (int)SwapLayer::SEGMENT_BALANCED;
+                    int rightOutLimit = mainCount + handCount - leftIn;
+                    if (rightOutLimit > nextMainCount) {
+                        rightOutLimit = nextMainCount;
+                    }
+                    for (int rightOut = 0; rightOut <= rightOutLimit; ++rightOut) {
+                        // 从 f 出发的路径数
+                        const int starts = rightOut + leftIn > mainCount ? rightOut + leftIn - mainCount : 0;
+                        int nextCost = cost + starts - (starts > 0 && face == topFace ? 1 : 0);
+                        int nextFlag = segmentFlag;
+                        if (starts > 0) {
+                            nextFlag = SwapLayer::SEGMENT_EXCESS;
+                        } else if (nextFlag != SwapLayer::SEGMENT_EXCESS) {
+                            nextFlag = SwapLayer::SEGMENT_BALANCED + ((nextFlag - SwapLayer::SEGMENT_BALANCED) | vertexFlags);
+                        }
+                        
+                        const bool nextOpen = rightOut + leftOut > 0;
+                        if (!nextOpen) {
+                            if (open && nextFlag != SwapLayer::SEGMENT_EXCESS) {
+                                // 回路段结束：需要段内有手牌，从顶部出发则不用交换
+                                const int segmentBits = nextFlag - SwapLayer::SEGMENT_BALANCED;
+                                if (!(segmentBits & 1)) {
+                                    continue;
+                                }
+                                nextCost += (segmentBits & 2) ? 0 : 1;
+                            }
+                            nextFlag = SwapLayer::SEGMENT_BALANCED;
+                        }
+                        next.relax(rightOut, leftOut, nextFlag, nextCost);
+                        anyReachable = true;
+                    }
+                }
+            }
+        }
+        
+        if (!anyReachable) {
+            return -1;
+        }
+        previousMainCount = mainCount;
+    }
+    
+    int trails = layers[FACE_COUNT & 1].cost[0][0][SwapLayer::SEGMENT_BALANCED];
+    return trails >= SwapLayer::UNREACHABLE ? -1 : trails;
+}
+
+bool LevelSolver::solve(const SolverState& state, std::vector<SolverMove>* solution)
+{
+    if (!isSolvable(state)) {
+        return false;
+    }
+    if (!solution) {
+        return true;
+    }
+    
+    // 每一步选择一个仍可解的后继状态，判定是精确的，所以不需要回溯
+    solution->clear();
+    SolverState current = state;
+    while (current.mainRemaining > 0) {
+        bool advanced = false;
+        for (int mainFace = 0; mainFace < FACE_COUNT && !advanced; ++mainFace) {
+            if (current.mainCounts[mainFace] == 0) {
+                continue;
+            }
+            for (int handFace = mainFace - 1; handFace <= mainFace + 1 && !advanced; handFace += 2) {
+                if (handFace < 0 || handFace >= FACE_COUNT || current.handCounts[handFace] == 0) {
+                    continue;
+                }
+                SolverState successor = current;
+                --successor.mainCounts[mainFace];
+                --successor.mainRemaining;
+                --successor.handCounts[handFace];
+                ++successor.handCounts[mainFace];
+                if (isSolvable(successor)) {
+                    SolverMove move = { (int8_t)handFace, (int8_t)mainFace };
+                    solution->push_back(move);
+                    current = successor;
+                    advanced = true;
+                }
+            }
+        }
+        if (!advanced) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LevelSolver::solveLevel(const LevelConfig* levelConfig, std::vector<SolverMove>* solution)
+{
+    if (!levelConfig || !levelConfig->isValid()) {
+        return false;
+    }
+    
+    SolverState state;
+    if (!buildState(levelConfig, state)) {
+        return false;
+    }
+    return solve(state, solution);
+}
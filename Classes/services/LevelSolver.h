@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __LEVEL_SOLVER_H__
+#define __LEVEL_SOLVER_H__
+
+#include "../configs/models/LevelConfig.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * 关卡求解服务
+ * 职责：判断关卡在 TestScene 规则下能否清空主牌堆，并给出一条可行解
+ * 使用场景：关卡生成时校验可解性、离线工具分析关卡
+ *
+ * 规则抽象：主牌堆卡牌全部可点，与底牌顶部面值相差1（不循环）即可替换底牌顶部；
+ * 备用牌可与底牌顶部无条件交换。交换只改变哪张牌在顶部，因此底牌顶部与备用牌
+ * 合并为一个“手牌”多重集合，一步操作即“用手牌中面值 h 的牌接走主牌堆中面值 h±1 的牌”。
+ * 花色与位置不影响可解性，状态只需按面值计数。
+ */
+class LevelSolver
+{
+public:
+    static const int FACE_COUNT = 13;       ///< 面值种类数
+    static const int MAX_FACE_COUNT = 15;   ///< 单一面值的最大张数
+    
+    /**
+     * 紧凑求解状态：按面值计数
+     */
+    struct SolverState
+    {
+        uint8_t mainCounts[FACE_COUNT];     ///< 主牌堆剩余卡牌的面值计数
+        uint8_t handCounts[FACE_COUNT];     ///< 底牌顶部与备用牌的面值计数
+        int mainRemaining;                  ///< 主牌堆剩余张数
+    };
+    
+    /**
+     * 一步操作：用手牌中的 handFace 接走主牌堆中的 mainFace
+     */
+    struct SolverMove
+    {
+        int8_t handFace;    ///< 被替换的手牌面值
+        int8_t mainFace;    ///< 接走的主牌面值
+    };
+    
+    /**
+     * 从关卡配置构建求解状态
+     * @param levelConfig 关卡配置
+     * @param state 输出状态
+     * @return 关卡是否可被求解器表示（面值计数不超过 MAX_FACE_COUNT）
+     */
+    static bool buildState(const LevelConfig* levelConfig, SolverState& state);
+    
+    /**
+     * 判断状态是否可解，耗时与卡牌数量无关（按面值逐个动态规划）
+     * @param state 状态
+     * @return 是否可解
+     */
+    static bool isSolvable(const SolverState& state);
+    
+    /**
+     * 计算清空主牌堆最少需要的交换次数（TestScene 中点击备用牌的次数）
+     * 手牌在面值轴上的移动拆成若干条路径，每条路径由一张手牌连续走完；
+     * 底牌顶部可直接开始一条路径，其余每条路径开始前都要交换一次
+     * @param state 状态，handCounts 含底牌顶部
+     * @param topFace 底牌顶部面值
+     * @return 最少交换次数，不可解返回-1
+     */
+    static int countMinSwaps(const SolverState& state, int topFace);
+    
+    /**
+     * 求解给定状态
+     * @param state 初始状态
+     * @param solution 可选，输出操作序列
+     * @return 是否可解
+     */
+    static bool solve(const SolverState& state, std::vector<SolverMove>* solution);
+    
+    /**
+     * 求解关卡配置
+     * @param levelConfig 关卡配置
+     * @param solution 可选，输出操作序列
+     * @return 是否可解；配置无效或无法表示时返回false
+     */
+    static bool solveLevel(const LevelConfig* levelConfig, std::vector<SolverMove>* solution = nullptr);
+};
+
+#endif // __LEVEL_SOLVER_H__
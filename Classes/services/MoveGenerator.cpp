@@ -0,0 +1,210 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "MoveGenerator.h"
+
+namespace {
+
+/**
+ * 把一张卡牌加入局面
+ * @return 卡牌编号，超出容量返回 MoveGenerator::NO_CARD
+ */
+uint8_t addCard(MoveGenerator::Board& board, const CardModel* card)
+{
+    if (board.cardCount >= MoveGenerator::MAX_CARDS) {
+        return MoveGenerator::NO_CARD;
+    }
+    uint8_t index = board.cardCount++;
+    int face = card->getFace();
+    board.cardIds[index] = card->getCardId();
+    board.faces[index] = (int8_t)(face >= 0 && face < MoveGenerator::FACE_COUNT ? face : -1);
+    board.locked[index] = false;
+    return index;
+}
+
+} // namespace
+
+bool MoveGenerator::buildBoard(const GameModel* gameModel, Board& board)
+{
+    board.mainCount = 0;
+    board.reserveCount = 0;
+    board.top = NO_CARD;
+    board.cardCount = 0;
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        board.mainCounts[face] = 0;
+        board.reserveCounts[face] = 0;
+    }
+    if (!gameModel) {
+        return false;
+    }
+    
+    for (const auto* card : gameModel->getMainPileCards()) {
+        uint8_t index = addCard(board, card);
+        if (index == NO_CARD) {
+            return false;
+        }
+        board.locked[index] = !card->isRevealed() || !card->isClickable();
+        board.mainCards[board.mainCount++] = index;
+        if (board.faces[index] >= 0) {
+            ++board.mainCounts[board.faces[index]];
+        }
+    }
+    for (const auto* card : gameModel->getReservePileCards()) {
+        uint8_t index = addCard(board, card);
+        if (index == NO_CARD) {
+            return false;
+        }
+        board.reserveCards[board.reserveCount++] = index;
+        if (board.faces[index] >= 0) {
+            ++board.reserveCounts[board.faces[index]];
+        }
+    }
+    const CardModel* topCard = gameModel->getBottomPileTopCard();
+    if (topCard) {
+        board.top = addCard(board, topCard);
+        if (board.top == NO_CARD) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int MoveGenerator::generateMoves(const Board& board, MoveList& moves)
+{
+    moves.count = 0;
+    if (board.top == NO_CARD) {
+        return 0;
+    }
+    
+    // 无效面值的顶部不能接牌，但仍可与备用牌交换
+    int topFace = board.faces[board.top];
+    if (topFace >= 0) {
+        for (int slot = 0; slot < board.mainCount; ++slot) {
+            uint8_t card = board.mainCards[slot];
+            int face = board.faces[card];
+            if (face >= 0 && (face == topFace + 1 || face == topFace - 1) && !board.locked[card]) {
+                Move& move = moves.moves[moves.count++];
+                move.type = GMT_MAIN_TO_BOTTOM;
+                move.slot = (uint8_t)slot;
+                move.card = card;
+                move.prevTop = board.top;
+            }
+        }
+    }
+    for (int slot = 0; slot < board.reserveCount; ++slot) {
+        Move& move = moves.moves[moves.count++];
+        move.type = GMT_RESERVE_TO_BOTTOM;
+        move.slot = (uint8_t)slot;
+        move.card = board.reserveCards[slot];
+        move.prevTop = board.top;
+    }
+    return moves.count;
+}
+
+bool MoveGenerator::findMove(const Board& board, int cardId, Move& move)
+{
+    MoveList moves;
+    generateMoves(board, moves);
+    for (int i = 0; i < moves.count; ++i) {
+        if (board.cardIds[moves.moves[i].card] == cardId) {
+            move = moves.moves[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void MoveGenerator::applyMove(Board& board, const Move& move)
+{
+    int face = board.faces[move.card];
+    if (move.type == GMT_MAIN_TO_BOTTOM) {
+        // 最后一张填补空位，原顶部卡牌离开局面
+        board.mainCards[move.slot] = board.mainCards[--board.mainCount];
+        if (face >= 0) {
+            --board.mainCounts[face];
+        }
+    } else {
+        int topFace = board.faces[move.prevTop];
+        board.reserveCards[move.slot] = move.prevTop;
+        if (face >= 0) {
+            --board.reserveCounts[face];
+        }
+        if (topFace >= 0) {
+            ++board.reserveCounts[topFace];
+        }
+    }
+    board.top = move.card;
+}
+
+void MoveGenerator::unapplyMove(Board& board, const Move& move)
+{
+    int face = board.faces[move.card];
+    if (move.type == GMT_MAIN_TO_BOTTOM) {
+        board.mainCards[board.mainCount++] = board.mainCards[move.slot];
+        board.mainCards[move.slot] = move.card;
+        if (face >= 0) {
+            ++board.mainCounts[face];
+        }
+    } else {
+        int topFace = board.faces[move.prevTop];
+        board.reserveCards[move.slot] = move.card;
+        if (face >= 0) {
+            ++board.reserveCounts[face];
+        }
+        if (topFace >= 0) {
+            --board.reserveCounts[topFace];
+        }
+    }
+    board.top = move.prevTop;
+}
+
+uint64_t MoveGenerator::perft(Board& board, int depth)
+{
+    if (depth <= 0) {
+        return 1;
+    }
+    MoveList moves;
+    generateMoves(board, moves);
+    if (depth == 1) {
+        return (uint64_t)moves.count;
+    }
+    
+    uint64_t nodes = 0;
+    for (int i = 0; i < moves.count; ++i) {
+        applyMove(board, moves.moves[i]);
+        nodes += perft(board, depth - 1);
+        unapplyMove(board, moves.moves[i]);
+    }
+    return nodes;
+}
+
+GameMove MoveGenerator::toGameMove(const Board& board, const Move& move)
+{
+    GameMove gameMove;
+    gameMove.type = (GameMoveType)move.type;
+    gameMove.cardId = board.cardIds[move.card];
+    gameMove.face = (CardFaceType)board.faces[move.card];
+    return gameMove;
+}
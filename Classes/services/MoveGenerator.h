@@ -0,0 +1,179 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __MOVE_GENERATOR_H__
+#define __MOVE_GENERATOR_H__
+
+#include "../models/GameModel.h"
+#include <cstdint>
+
+/**
+ * 对局操作类型（TestScene::onCardClicked 中的两种点击）
+ */
+enum GameMoveType
+{
+    GMT_MAIN_TO_BOTTOM,     ///< 主牌接到底牌顶部
+    GMT_RESERVE_TO_BOTTOM   ///< 备用牌与底牌顶部交换
+};
+
+/**
+ * 一步操作
+ */
+struct GameMove
+{
+    GameMoveType type;  ///< 操作类型
+    int cardId;         ///< 被点击的卡牌ID
+    CardFaceType face;  ///< 被点击卡牌的面值
+};
+
+/**
+ * 合法操作生成器
+ * 职责：在紧凑局面上列出全部合法操作，并支持执行与撤销（make/unmake），整个过程不分配堆内存
+ * 使用场景：点击合法性校验、机器人、操作序列回放与搜索
+ *
+ * 规则与 TestScene 一致：底牌顶部存在时，已翻开且可点击、面值与顶部相差1的主牌可以接走，
+ * 原顶部卡牌被移除；任一备用牌可与顶部无条件交换。
+ *
+ * 局面中的卡牌按构建顺序编号为 0..cardCount-1，主牌堆与备用牌堆保存卡牌编号。
+ * 接走主牌时用主牌堆最后一张填补空位，操作中记录了空位下标、被点击卡牌和原顶部卡牌，
+ * 因此 unapplyMove 可以精确还原牌堆顺序。
+ * 操作必须按执行的逆序撤销。
+ */
+class MoveGenerator
+{
+public:
+    static const int FACE_COUNT = CFT_NUM_CARD_FACE_TYPES;  ///< 面值种数
+    static const int MAX_CARDS = 255;                       ///< 局面可容纳的卡牌总数
+    static const int MAX_MOVES = MAX_CARDS;                 ///< 单个局面合法操作数上限
+    static const uint8_t NO_CARD = 0xFF;                    ///< 表示无卡牌的编号
+    
+    /**
+     * 紧凑操作（4字节）
+     */
+    struct Move
+    {
+        uint8_t type;       ///< 操作类型（GameMoveType）
+        uint8_t slot;       ///< 被点击卡牌在主牌堆或备用牌堆中的下标
+        uint8_t card;       ///< 被点击卡牌的编号
+        uint8_t prevTop;    ///< 操作前底牌顶部卡牌的编号
+    };
+    
+    /**
+     * 定长操作列表，可直接放在栈上
+     */
+    struct MoveList
+    {
+        Move moves[MAX_MOVES];  ///< 操作
+        int count;              ///< 操作数
+    };
+    
+    /**
+     * 紧凑局面：卡牌编号、面值和三个牌堆，面值计数随操作增量更新
+     */
+    struct Board
+    {
+        int cardIds[MAX_CARDS];                 ///< 卡牌编号对应的卡牌ID
+        int8_t faces[MAX_CARDS];                ///< 卡牌编号对应的面值，无效面值为-1
+        bool locked[MAX_CARDS];                 ///< 未翻开或不可点击的主牌，不能接走
+        uint8_t mainCards[MAX_CARDS];           ///< 主牌堆（顺序会因接牌改变）
+        uint8_t reserveCards[MAX_CARDS];        ///< 备用牌堆
+        uint8_t mainCounts[FACE_COUNT];         ///< 主牌堆的面值计数
+        uint8_t reserveCounts[FACE_COUNT];      ///< 备用牌堆的面值计数
+        uint8_t mainCount;                      ///< 主牌堆张数
+        uint8_t reserveCount;                   ///< 备用牌堆张数
+        uint8_t top;                            ///< 底牌顶部卡牌编号，NO_CARD表示无
+        uint8_t cardCount;                      ///< 卡牌总数
+    };
+    
+    /**
+     * 从游戏模型构建局面（主牌堆与备用牌堆保持模型中的顺序）
+     * @param gameModel 游戏模型
+     * @param board 输出局面
+     * @return 是否可表示（主牌、备用牌加顶部共不超过 MAX_CARDS 张）
+     */
+    static bool buildBoard(const GameModel* gameModel, Board& board);
+    
+    /**
+     * 列出全部合法操作：先主牌，后备用牌，各自按牌堆顺序
+     * @param board 局面
+     * @param moves 输出操作列表
+     * @return 操作数
+     */
+    static int generateMoves(const Board& board, MoveList& moves);
+    
+    /**
+     * 查找点击某张卡牌对应的合法操作
+     * @param board 局面
+     * @param cardId 卡牌ID
+     * @param move 输出操作
+     * @return 点击是否合法
+     */
+    static bool findMove(const Board& board, int cardId, Move& move);
+    
+    /**
+     * 执行操作（不做合法性检查，操作须由 generateMoves 或 findMove 在当前局面得到）
+     * @param board 局面
+     * @param move 操作
+     */
+    static void applyMove(Board& board, const Move& move);
+    
+    /**
+     * 撤销最近一次执行的操作
+     * @param board 局面
+     * @param move 操作，必须是最近一次 applyMove 的参数
+     */
+    static void unapplyMove(Board& board, const Move& move);
+    
+    /**
+     * 转换为带卡牌ID的操作
+     * @param board 局面
+     * @param move 紧凑操作
+     * @return 操作
+     */
+    static GameMove toGameMove(const Board& board, const Move& move);
+    
+    /**
+     * 统计从局面出发恰好走 depth 步可到达的叶子数（按操作序列计数，不合并相同局面）
+     * 没有合法操作的局面在 depth 之前结束，不计入叶子；获胜后备用牌仍可交换，继续计数。
+     * 最后一层只计操作数，不执行。
+     * @param board 局面，返回时恢复原状
+     * @param depth 步数
+     * @return 叶子数，depth 为0时返回1
+     */
+    static uint64_t perft(Board& board, int depth);
+    
+    /**
+     * 检查是否已获胜（主牌堆清空）
+     * @param board 局面
+     * @return 是否获胜
+     */
+    static bool isWon(const Board& board) { return board.mainCount == 0; }
+
+private:
+    // 禁止实例化
+    MoveGenerator() = delete;
+};
+
+#endif // __MOVE_GENERATOR_H__
@@ -0,0 +1,112 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "PositionEvaluator.h"
+#include <climits>
+#include <cstdlib>
+
+namespace {
+
+const int FACE_COUNT = MoveGenerator::FACE_COUNT;
+const int SCORE_BOUND_WEIGHT = 64;  ///< 下界每差一次点击对应的评分，大于任何可接张数
+
+} // namespace
+
+bool PositionEvaluator::evaluate(const uint8_t* mainCounts, const uint8_t* reserveCounts, int topFace,
+                                 int mainRemaining, PositionEvaluation& evaluation)
+{
+    evaluation.dead = false;
+    evaluation.lowerBound = mainRemaining;
+    evaluation.swapBound = 0;
+    evaluation.segmentCount = 0;
+    evaluation.mobility = 0;
+    if (mainRemaining == 0) {
+        return true;
+    }
+    if (topFace < 0 || topFace >= FACE_COUNT) {
+        evaluation.dead = true;
+        return false;
+    }
+    evaluation.mobility = (topFace > 0 ? mainCounts[topFace - 1] : 0) +
+                          (topFace + 1 < FACE_COUNT ? mainCounts[topFace + 1] : 0);
+    
+    int face = 0;
+    while (face < FACE_COUNT) {
+        if (mainCounts[face] == 0 && reserveCounts[face] == 0 && face != topFace) {
+            ++face;
+            continue;
+        }
+        
+        // 一个连续面值段：偶数面值主牌张数减奇数面值主牌张数
+        int mainCount = 0;
+        int balance = 0;
+        bool hasHand = false;
+        bool hasTop = false;
+        for (; face < FACE_COUNT && (mainCounts[face] > 0 || reserveCounts[face] > 0 || face == topFace); ++face) {
+            mainCount += mainCounts[face];
+            balance += (face & 1) ? -mainCounts[face] : mainCounts[face];
+            hasHand = hasHand || reserveCounts[face] > 0 || face == topFace;
+            hasTop = hasTop || face == topFace;
+        }
+        if (mainCount == 0) {
+            continue;
+        }
+        if (!hasHand) {
+            evaluation.dead = true;
+            return false;
+        }
+        ++evaluation.segmentCount;
+        
+        int rounds = std::abs(balance);
+        if (hasTop) {
+            // 从顶部开始的一轮不需要交换，先接的是与顶部奇偶相反的面值
+            int direction = (topFace & 1) ? 1 : -1;
+            evaluation.swapBound += balance * direction > 0 ? rounds - 1 : rounds;
+        } else {
+            evaluation.swapBound += rounds > 1 ? rounds : 1;
+        }
+    }
+    evaluation.lowerBound = mainRemaining + evaluation.swapBound;
+    return true;
+}
+
+bool PositionEvaluator::evaluate(const MoveGenerator::Board& board, PositionEvaluation& evaluation)
+{
+    int topFace = board.top != MoveGenerator::NO_CARD ? board.faces[board.top] : -1;
+    return evaluate(board.mainCounts, board.reserveCounts, topFace, board.mainCount, evaluation);
+}
+
+bool PositionEvaluator::evaluate(const GameSolver::Position& position, PositionEvaluation& evaluation)
+{
+    return evaluate(position.mainCounts, position.reserveCounts, position.topFace, position.mainRemaining, evaluation);
+}
+
+int PositionEvaluator::score(const PositionEvaluation& evaluation)
+{
+    if (evaluation.dead) {
+        return INT_MIN;
+    }
+    return evaluation.mobility - evaluation.lowerBound * SCORE_BOUND_WEIGHT;
+}
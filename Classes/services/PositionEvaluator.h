@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __POSITION_EVALUATOR_H__
+#define __POSITION_EVALUATOR_H__
+
+#include "GameSolver.h"
+#include "MoveGenerator.h"
+#include <cstdint>
+
+/**
+ * 局面评估结果
+ */
+struct PositionEvaluation
+{
+    bool dead;          ///< 是否已确定无解
+    int lowerBound;     ///< 取胜还需的最少点击次数下界（dead 时无意义）
+    int swapBound;      ///< 其中备用牌交换次数的下界
+    int segmentCount;   ///< 含主牌的连续面值段数
+    int mobility;       ///< 顶部可直接接走的主牌张数
+};
+
+/**
+ * 局面评估服务
+ * 职责：在按面值计数的紧凑局面上给出廉价的剪枝判断与启发式评分
+ * 使用场景：机器人与搜索剪掉必输分支、为候选操作排序
+ *
+ * 规则与 TestScene 一致。把主牌、备用牌与顶部中出现的面值划分为极大的连续面值段：
+ * 主牌只能接在相差1的牌上，卡牌不会新增，因此接牌永远不会跨段。
+ * - 段内有主牌却没有备用牌或顶部卡牌：永远无法进入该段，局面无解
+ * - 每段至少要从一张手牌开始连续接牌一次；不从当前顶部开始的每一轮连续接牌之前都需要一次交换
+ * - 连续接牌时面值奇偶交替，一轮至多让段内偶数面值与奇数面值主牌的张数差改变1，
+ *   因此段内需要的轮数不少于该差值；从顶部开始的第一轮只能朝顶部决定的方向改变
+ * 下界 = 剩余主牌数 + 各段所需交换数之和，不超过 GameSolver::countMinClicks 的精确值。
+ *
+ * 面值计数由 MoveGenerator::applyMove/unapplyMove 增量维护，评估只扫描13个面值，与卡牌数无关。
+ */
+class PositionEvaluator
+{
+public:
+    /**
+     * 按面值计数评估局面
+     * @param mainCounts 主牌堆的面值计数（长度 FACE_COUNT）
+     * @param reserveCounts 备用牌堆的面值计数
+     * @param topFace 底牌顶部面值，-1表示无顶部卡牌
+     * @param mainRemaining 主牌堆剩余张数
+     * @param evaluation 输出评估结果
+     * @return 是否仍可能取胜（!evaluation.dead）
+     */
+    static bool evaluate(const uint8_t* mainCounts, const uint8_t* reserveCounts, int topFace, int mainRemaining,
+                         PositionEvaluation& evaluation);
+    
+    /**
+     * 评估 MoveGenerator 局面
+     * @param board 局面
+     * @param evaluation 输出评估结果
+     * @return 是否仍可能取胜
+     */
+    static bool evaluate(const MoveGenerator::Board& board, PositionEvaluation& evaluation);
+    
+    /**
+     * 评估求解器局面
+     * @param position 局面
+     * @param evaluation 输出评估结果
+     * @return 是否仍可能取胜
+     */
+    static bool evaluate(const GameSolver::Position& position, PositionEvaluation& evaluation);
+    
+    /**
+     * 启发式评分：下界越小越好，同下界时顶部可接张数越多越好
+     * @param evaluation 评估结果
+     * @return 评分，越大越好；无解局面低于任何可能取胜的局面
+     */
+    static int score(const PositionEvaluation& evaluation);
+
+private:
+    // 禁止实例化
+    PositionEvaluator() = delete;
+};
+
+#endif // __POSITION_EVALUATOR_H__
@@ -38,10 +38,14 @@ UndoModel::UndoRecord UndoService::createHandSwapRecord(const GameModel* gameMod
         CardModel* toCard = gameModel->findBottomPileCard(toCardId);
         
         if (fromCard) {
-            record.sourcePosition = fromCard->getPosition();
+            record.setSourcePosition(fromCard->getPosition());
+            record.sourceFace = (int8_t)fromCard->getFace();
+            record.sourceSuit = (int8_t)fromCard->getSuit();
         }
         if (toCard) {
-            record.targetPosition = toCard->getPosition();
+            record.setTargetPosition(toCard->getPosition());
+            record.targetFace = (int8_t)toCard->getFace();
+            record.targetSuit = (int8_t)toCard->getSuit();
         }
         
         record.handTopIndex = gameModel->getBottomPileTopIndex();
@@ -64,10 +68,14 @@ UndoModel::UndoRecord UndoService::createPlayfieldToHandRecord(const GameModel*
         CardModel* stackCard = gameModel->findBottomPileCard(stackCardId);
         
         if (playfieldCard) {
-            record.sourcePosition = playfieldCard->getPosition();
+            record.setSourcePosition(playfieldCard->getPosition());
+            record.sourceFace = (int8_t)playfieldCard->getFace();
+            record.sourceSuit = (int8_t)playfieldCard->getSuit();
         }
         if (stackCard) {
-            record.targetPosition = stackCard->getPosition();
+            record.setTargetPosition(stackCard->getPosition());
+            record.targetFace = (int8_t)stackCard->getFace();
+            record.targetSuit = (int8_t)stackCard->getSuit();
         }
         
         record.handTopIndex = gameModel->getBottomPileTopIndex();
@@ -109,8 +117,8 @@ bool UndoService::executeUndo(GameModel* gameModel, const UndoModel::UndoRecord&
             
             if (sourceCard && targetCard) {
                 // 交换位置
-                sourceCard->setPosition(record.sourcePosition);
-                targetCard->setPosition(record.targetPosition);
+                sourceCard->setPosition(record.getSourcePosition());
+                targetCard->setPosition(record.getTargetPosition());
                 
                 // 恢复手牌区顶部索引
                 gameModel->setBottomPileTopIndex(record.handTopIndex);
@@ -124,9 +132,13 @@ bool UndoService::executeUndo(GameModel* gameModel, const UndoModel::UndoRecord&
             CardModel* stackCard = gameModel->findBottomPileCard(record.targetCardId);
             
             if (playfieldCard && stackCard) {
-                // 恢复位置
-                playfieldCard->setPosition(record.sourcePosition);
-                stackCard->setPosition(record.targetPosition);
+                // 移动时交换了面值、花色和位置，需全部恢复
+                playfieldCard->setFace((CardFaceType)record.sourceFace);
+                playfieldCard->setSuit((CardSuitType)record.sourceSuit);
+                playfieldCard->setPosition(record.getSourcePosition());
+                stackCard->setFace((CardFaceType)record.targetFace);
+                stackCard->setSuit((CardSuitType)record.targetSuit);
+                stackCard->setPosition(record.getTargetPosition());
                 
                 // 恢复手牌区顶部索引
                 gameModel->setBottomPileTopIndex(record.handTopIndex);
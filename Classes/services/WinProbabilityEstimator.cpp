@@ -0,0 +1,364 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "WinProbabilityEstimator.h"
+#include "GameSolver.h"
+#include "../utils/DealRandom.h"
+#include "../utils/ParallelUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+const int FACE_COUNT = CFT_NUM_CARD_FACE_TYPES;
+const int SUIT_COUNT = CST_NUM_CARD_SUIT_TYPES;
+
+/**
+ * 候选集合中的一张未知卡牌
+ */
+struct PoolCard
+{
+    int8_t face;    ///< 面值
+    int8_t suit;    ///< 花色
+};
+
+/**
+ * 可反复重置的游戏模型副本
+ * 副本持有全部卡牌；模拟中被替换掉的底牌只从牌堆中移出，不释放，重置时按初始顺序放回
+ */
+class PlayoutClone
+{
+public:
+    explicit PlayoutClone(const GameModel* source)
+        : _bottomTopIndex(source->getBottomPileTopIndex())
+    {
+        cloneCards(source->getMainPileCards(), _mainCards);
+        cloneCards(source->getBottomPileCards(), _bottomCards);
+        cloneCards(source->getReservePileCards(), _reserveCards);
+        for (auto* card : _reserveCards) {
+            if (!card->isRevealed()) {
+                _hiddenCards.push_back(card);
+            }
+        }
+    }
+    
+    ~PlayoutClone()
+    {
+        // 卡牌由副本统一释放，先清空模型中的列表避免重复释放
+        _model.getMainPileCards().clear();
+        _model.getBottomPileCards().clear();
+        _model.getReservePileCards().clear();
+        for (auto* card : _cards) {
+            delete card;
+        }
+    }
+    
+    /**
+     * 恢复初始牌堆，并把未知卡牌依次设为补全中的卡牌
+     * @param sample 补全，长度为未知卡牌张数
+     */
+    void reset(const PoolCard* sample)
+    {
+        // 列表容量在第一次重置后即固定，assign 不再分配内存
+        _model.getMainPileCards().assign(_mainCards.begin(), _mainCards.end());
+        _model.getBottomPileCards().assign(_bottomCards.begin(), _bottomCards.end());
+        _model.getReservePileCards().assign(_reserveCards.begin(), _reserveCards.end());
+        _model.setBottomPileTopIndex(_bottomTopIndex);
+        for (size_t i = 0; i < _hiddenCards.size(); ++i) {
+            _hiddenCards[i]->setFace((CardFaceType)sample[i].face);
+            _hiddenCards[i]->setSuit((CardSuitType)sample[i].suit);
+            _hiddenCards[i]->setRevealed(false);
+        }
+    }
+    
+    GameModel& getModel() { return _model; }
+
+private:
+    PlayoutClone(const PlayoutClone&);
+    PlayoutClone& operator=(const PlayoutClone&);
+    
+    void cloneCards(const std::vector<CardModel*>& source, std::vector<CardModel*>& target)
+    {
+        for (const auto* card : source) {
+            CardModel* copy = new CardModel(card->getFace(), card->getSuit(), card->getPosition());
+            copy->setCardId(card->getCardId());
+            copy->setRevealed(card->isRevealed());
+            copy->setClickable(card->isClickable());
+            target.push_back(copy);
+            _cards.push_back(copy);
+        }
+    }
+    
+    GameModel _model;                       ///< 模拟用的模型
+    std::vector<CardModel*> _cards;         ///< 副本持有的全部卡牌
+    std::vector<CardModel*> _mainCards;     ///< 初始主牌堆
+    std::vector<CardModel*> _bottomCards;   ///< 初始底牌堆
+    std::vector<CardModel*> _reserveCards;  ///< 初始备用牌堆
+    std::vector<CardModel*> _hiddenCards;   ///< 未翻开的备用牌，与补全一一对应
+    int _bottomTopIndex;                    ///< 初始底牌堆顶部索引
+};
+
+/**
+ * 主牌堆中与 face 相邻的已翻开卡牌张数
+ */
+int countAdjacentMain(const int* mainCounts, int face)
+{
+    return (face > 0 ? mainCounts[face - 1] : 0) + (face + 1 < FACE_COUNT ? mainCounts[face + 1] : 0);
+}
+
+/**
+ * 只依据已翻开的卡牌走完一局
+ * 交换不会丢牌，底牌顶部与已翻开的备用牌合起来就是可用的手牌；每次接牌用掉一张手牌。
+ * 每步在所有（手牌, 可接主牌）组合中选收益最大的：接来的主牌能接的张数减去用掉的手牌能接的张数，
+ * 同分时优先直接用底牌顶部。没有可接的组合时翻开一张未知备用牌。
+ * 每步要么接走一张主牌，要么减少一张未知牌，因此必然结束。
+ * @return 是否清空主牌堆
+ */
+bool playGreedy(GameModel& model)
+{
+    auto& mainCards = model.getMainPileCards();
+    auto& reserveCards = model.getReservePileCards();
+    auto& bottomCards = model.getBottomPileCards();
+    const int topIndex = model.getBottomPileTopIndex();
+    int mainCounts[FACE_COUNT];
+    
+    while (!mainCards.empty()) {
+        std::fill(mainCounts, mainCounts + FACE_COUNT, 0);
+        for (const auto* card : mainCards) {
+            ++mainCounts[card->getFace()];
+        }
+        
+        // handIndex 为-1表示底牌顶部，否则为备用牌下标
+        int bestHand = -2;
+        int bestMain = -1;
+        int bestGain = 0;
+        int hiddenIndex = -1;
+        for (int hand = -1; hand < (int)reserveCards.size(); ++hand) {
+            const CardModel* handCard = hand < 0 ? bottomCards[topIndex] : reserveCards[hand];
+            if (!handCard->isRevealed()) {
+                hiddenIndex = hiddenIndex < 0 ? hand : hiddenIndex;
+                continue;
+            }
+            for (size_t i = 0; i < mainCards.size(); ++i) {
+                if (!mainCards[i]->isAdjacentTo(*handCard)) {
+                    continue;
+                }
+                --mainCounts[mainCards[i]->getFace()];
+                int gain = countAdjacentMain(mainCounts, mainCards[i]->getFace()) -
+                           countAdjacentMain(mainCounts, handCard->getFace());
+                ++mainCounts[mainCards[i]->getFace()];
+                if (bestHand < -1 || gain > bestGain) {
+                    bestHand = hand;
+                    bestMain = (int)i;
+                    bestGain = gain;
+                }
+            }
+        }
+        
+        if (bestHand < -1) {
+            if (hiddenIndex < 0) {
+                return false;
+            }
+            std::swap(reserveCards[hiddenIndex], bottomCards[topIndex]);
+            bottomCards[topIndex]->setRevealed(true);
+            continue;
+        }
+        if (bestHand >= 0) {
+            std::swap(reserveCards[bestHand], bottomCards[topIndex]);
+        }
+        bottomCards[topIndex] = mainCards[bestMain];
+        mainCards.erase(mainCards.begin() + bestMain);
+    }
+    return true;
+}
+
+/**
+ * 在补全后的对局上按策略走完一局
+ * @return 是否获胜
+ */
+bool playOut(GameModel& model, WinPlayoutPolicy policy)
+{
+    if (policy == WPP_OPTIMAL) {
+        GameSolver::Position position;
+        return GameSolver::buildPosition(&model, position) && GameSolver::countMinClicks(position) >= 0;
+    }
+    return playGreedy(model);
+}
+
+/**
+ * 计算未知卡牌的候选集合：deckCount 副牌减去所有已翻开的卡牌
+ * @return 已翻开的卡牌与牌副数一致、候选足够且主牌堆全部翻开时返回true
+ */
+bool buildUnknownPool(const GameModel* gameModel, int deckCount, std::vector<PoolCard>& pool, int& hiddenCount)
+{
+    int remaining[FACE_COUNT][SUIT_COUNT];
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        std::fill(remaining[face], remaining[face] + SUIT_COUNT, deckCount);
+    }
+    hiddenCount = 0;
+    for (const auto* cardList : { &gameModel->getMainPileCards(), &gameModel->getBottomPileCards(),
+                                  &gameModel->getReservePileCards() }) {
+        for (const auto* card : *cardList) {
+            if (!card->isRevealed()) {
+                if (cardList != &gameModel->getReservePileCards()) {
+                    return false;
+                }
+                ++hiddenCount;
+                continue;
+            }
+            int face = card->getFace();
+            int suit = card->getSuit();
+            if (face < 0 || face >= FACE_COUNT || suit < 0 || suit >= SUIT_COUNT || --remaining[face][suit] < 0) {
+                return false;
+            }
+        }
+    }
+    
+    pool.clear();
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        for (int suit = 0; suit < SUIT_COUNT; ++suit) {
+            for (int i = 0; i < remaining[face][suit]; ++i) {
+                PoolCard card = { (int8_t)face, (int8_t)suit };
+                pool.push_back(card);
+            }
+        }
+    }
+    return (int)pool.size() >= hiddenCount;
+}
+
+} // namespace
+
+bool WinProbabilityEstimator::estimate(const GameModel* gameModel, const WinEstimateParams& params,
+                                       WinEstimate& estimate)
+{
+    auto start = std::chrono::steady_clock::now();
+    estimate = WinEstimate();
+    std::vector<PoolCard> pool;
+    int hiddenCount = 0;
+    if (!gameModel || !gameModel->getBottomPileTopCard() || params.deckCount <= 0 ||
+        !buildUnknownPool(gameModel, params.deckCount, pool, hiddenCount)) {
+        return false;
+    }
+    estimate.status = WES_OK;
+    estimate.hiddenCount = hiddenCount;
+    
+    // 没有未知卡牌时结果是确定的
+    long long maxPlayouts = hiddenCount == 0 ? std::min(params.maxPlayouts, 1LL) : params.maxPlayouts;
+    int batchSize = std::max(1, params.batchSize);
+    long long batchCount = (maxPlayouts + batchSize - 1) / batchSize;
+    int threadCount = ParallelUtils::resolveThreadCount(params.threadCount, batchCount);
+    
+    // 每个线程的工作区：副本与候选集合在线程第一次领取时分配，之后每局只做重置
+    struct Workspace
+    {
+        std::vector<PlayoutClone*> clones;  ///< 模型副本，每批每局一份
+        std::vector<PoolCard> shuffled;     ///< 洗牌用的候选序列
+        std::vector<PoolCard> samples;      ///< 每局抽到的未知卡牌
+        long long playouts = 0;             ///< 已模拟局数
+        long long wins = 0;                 ///< 其中获胜局数
+    };
+    std::vector<Workspace> workspaces(threadCount);
+    
+    bool timed = params.timeBudgetMicros > 0;
+    auto deadline = start + std::chrono::microseconds(timed ? params.timeBudgetMicros : 0);
+    std::atomic<bool> timeUp(false);
+    ParallelUtils::parallelFor(batchCount, threadCount, [&](int threadIndex, long long batchIndex) {
+        if (timed && std::chrono::steady_clock::now() >= deadline) {
+            timeUp = true;
+            return;
+        }
+        Workspace& workspace = workspaces[threadIndex];
+        if (workspace.clones.empty()) {
+            for (int i = 0; i < batchSize; ++i) {
+                workspace.clones.push_back(new PlayoutClone(gameModel));
+            }
+            workspace.shuffled.resize(pool.size());
+            workspace.samples.resize((size_t)batchSize * std::max(1, hiddenCount));
+        }
+        long long first = batchIndex * batchSize;
+        int count = (int)std::min((long long)batchSize, maxPlayouts - first);
+        
+        // 第 k 局的补全只取决于 (seed, k)：每局从同一初始候选序列做部分洗牌
+        for (int i = 0; i < count; ++i) {
+            DealRandom random(params.seed, (uint64_t)(first + i));
+            std::copy(pool.begin(), pool.end(), workspace.shuffled.begin());
+            PoolCard* sample = &workspace.samples[(size_t)i * std::max(1, hiddenCount)];
+            for (int j = 0; j < hiddenCount; ++j) {
+                size_t pick = j + random.nextBounded((uint32_t)(workspace.shuffled.size() - j));
+                std::swap(workspace.shuffled[j], workspace.shuffled[pick]);
+                sample[j] = workspace.shuffled[j];
+            }
+            workspace.clones[i]->reset(sample);
+        }
+        for (int i = 0; i < count; ++i) {
+            workspace.wins += playOut(workspace.clones[i]->getModel(), params.policy) ? 1 : 0;
+        }
+        workspace.playouts += count;
+    }, &timeUp);
+    
+    long long playoutCount = 0;
+    long long winCount = 0;
+    for (const auto& workspace : workspaces) {
+        playoutCount += workspace.playouts;
+        winCount += workspace.wins;
+        for (auto* clone : workspace.clones) {
+            delete clone;
+        }
+    }
+    
+    estimate.playouts = playoutCount;
+    estimate.wins = winCount;
+    if (estimate.playouts > 0) {
+        estimate.probability = (double)estimate.wins / estimate.playouts;
+    }
+    if (hiddenCount == 0) {
+        estimate.lower = estimate.probability;
+        estimate.upper = estimate.probability;
+    } else {
+        computeWilsonInterval(estimate.wins, estimate.playouts, params.confidenceZ, estimate.lower, estimate.upper);
+    }
+    estimate.elapsedMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void WinProbabilityEstimator::computeWilsonInterval(long long wins, long long playouts, double z,
+                                                    double& lower, double& upper)
+{
+    if (playouts <= 0) {
+        lower = 0.0;
+        upper = 1.0;
+        return;
+    }
+    double n = (double)playouts;
+    double p = (double)wins / n;
+    double z2 = z * z;
+    double denominator = 1.0 + z2 / n;
+    double center = (p + z2 / (2.0 * n)) / denominator;
+    double halfWidth = z * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / denominator;
+    lower = std::max(0.0, center - halfWidth);
+    upper = std::min(1.0, center + halfWidth);
+}
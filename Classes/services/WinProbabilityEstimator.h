@@ -0,0 +1,133 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __WIN_PROBABILITY_ESTIMATOR_H__
+#define __WIN_PROBABILITY_ESTIMATOR_H__
+
+#include "../models/GameModel.h"
+#include <cstdint>
+
+/**
+ * 模拟对局使用的走法策略
+ */
+enum WinPlayoutPolicy
+{
+    WPP_GREEDY,         ///< 只看已翻开的卡牌贪心接牌，卡住时才翻开一张未知备用牌，模拟普通玩家
+    WPP_OPTIMAL         ///< 先翻开全部未知备用牌再走最优解（GameSolver::countMinClicks），即完美玩家
+};
+
+/**
+ * 估计结果状态
+ */
+enum WinEstimateStatus
+{
+    WES_OK,             ///< 估计完成
+    WES_UNSUPPORTED     ///< 对局无法估计：无底牌顶部、主牌堆有未翻开的卡牌，或已翻开的卡牌与牌副数矛盾
+};
+
+/**
+ * 胜率估计参数
+ */
+struct WinEstimateParams
+{
+    int timeBudgetMicros;       ///< 时间预算（微秒），<=0 表示只受 maxPlayouts 限制
+    long long maxPlayouts;      ///< 模拟局数上限
+    int threadCount;            ///< 线程数，<=0 时使用硬件并发数
+    int batchSize;              ///< 每个线程预先分配的模型副本数，也是每次领取的模拟局数
+    int deckCount;              ///< 使用几副牌，用于推算未知卡牌的候选集合
+    WinPlayoutPolicy policy;    ///< 走法策略
+    uint64_t seed;              ///< 随机种子，第 k 局的补全只由 (seed, k) 决定
+    double confidenceZ;         ///< 置信区间的 z 值（1.96 对应 95%）
+    
+    WinEstimateParams()
+        : timeBudgetMicros(20000)
+        , maxPlayouts(1000000)
+        , threadCount(0)
+        , batchSize(32)
+        , deckCount(1)
+        , policy(WPP_GREEDY)
+        , seed(1)
+        , confidenceZ(1.96)
+    {}
+};
+
+/**
+ * 胜率估计结果
+ */
+struct WinEstimate
+{
+    WinEstimateStatus status;   ///< 结果状态
+    int hiddenCount;            ///< 未翻开的卡牌张数
+    long long playouts;         ///< 完成的模拟局数
+    long long wins;             ///< 获胜局数
+    double probability;         ///< 胜率点估计
+    double lower;               ///< 置信区间下限（Wilson 区间）
+    double upper;               ///< 置信区间上限
+    double elapsedMicros;       ///< 实际耗时（微秒）
+    
+    WinEstimate()
+        : status(WES_UNSUPPORTED), hiddenCount(0), playouts(0), wins(0)
+        , probability(0), lower(0), upper(0), elapsedMicros(0)
+    {}
+};
+
+/**
+ * 胜率估计服务
+ * 职责：备用牌未翻开时，估计当前局面按给定策略取胜的概率及置信区间
+ * 使用场景：关卡平衡、难度评级、对局中展示胜率
+ *
+ * 未知卡牌的候选集合为 deckCount 副完整的牌减去所有已翻开的卡牌，每局模拟从中无放回地
+ * 抽取一组补全（与已见卡牌一致），再按 TestScene 规则走完。每个线程开始时一次性克隆
+ * batchSize 份游戏模型，之后每局只重置牌堆中的卡牌指针并改写未知卡牌的面值与花色，
+ * 不再分配内存；线程按下标成批领取模拟局，每批结束检查一次时间预算。
+ * 规则同 GameSolver：主牌堆在本游戏中总是翻开的，未知卡牌只出现在备用牌堆。
+ * 交换不会丢牌，完美玩家可以先把未知备用牌逐张换上来看清，之后信息完全，
+ * 所以 WPP_OPTIMAL 的胜率就是补全后可解的比例，也是任何策略胜率的上限。
+ */
+class WinProbabilityEstimator
+{
+public:
+    /**
+     * 估计胜率
+     * 无未知卡牌时局面是确定的，只模拟一局，区间退化为该点
+     * @param gameModel 游戏模型（只读）
+     * @param params 估计参数
+     * @param estimate 输出结果
+     * @return 是否估计完成（estimate.status == WES_OK）
+     */
+    static bool estimate(const GameModel* gameModel, const WinEstimateParams& params, WinEstimate& estimate);
+    
+    /**
+     * 计算 Wilson 置信区间
+     * @param wins 获胜局数
+     * @param playouts 模拟局数
+     * @param z 置信水平对应的 z 值
+     * @param lower 输出下限
+     * @param upper 输出上限
+     */
+    static void computeWilsonInterval(long long wins, long long playouts, double z, double& lower, double& upper);
+};
+
+#endif // __WIN_PROBABILITY_ESTIMATOR_H__
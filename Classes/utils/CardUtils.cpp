@@ -54,17 +54,17 @@ std::string CardUtils::getCardText(CardFaceType face, CardSuitType suit)
     return getFaceText(face) + getSuitText(suit);
 }
 
-cocos2d::Color3B CardUtils::getCardColor(CardSuitType suit)
+CoreColor3B CardUtils::getCardColor(CardSuitType suit)
 {
     switch (suit) {
         case CST_HEARTS:
         case CST_DIAMONDS:
-            return cocos2d::Color3B::RED;
+            return CoreColor3B(255, 0, 0);
         case CST_CLUBS:
         case CST_SPADES:
-            return cocos2d::Color3B::BLACK;
+            return CoreColor3B(0, 0, 0);
         default:
-            return cocos2d::Color3B::BLACK;
+            return CoreColor3B(0, 0, 0);
     }
 }
 
@@ -78,12 +78,12 @@ bool CardUtils::areFacesAdjacent(CardFaceType face1, CardFaceType face2)
     return diff == 1;
 }
 
-cocos2d::Size CardUtils::getCardSize()
+CoreSize CardUtils::getCardSize()
 {
-    return cocos2d::Size(120, 160);
+    return CoreSize(120, 160);
 }
 
-cocos2d::Vec2 CardUtils::calculateFanPosition(const cocos2d::Vec2& center, int index, int total, float radius)
+CoreVec2 CardUtils::calculateFanPosition(const CoreVec2& center, int index, int total, float radius)
 {
     if (total <= 1) {
         return center;
@@ -93,7 +93,7 @@ cocos2d::Vec2 CardUtils::calculateFanPosition(const cocos2d::Vec2& center, int i
     float x = center.x + radius * std::cos(angle);
     float y = center.y + radius * std::sin(angle);
     
-    return cocos2d::Vec2(x, y);
+    return CoreVec2(x, y);
 }
 
 bool CardUtils::isValidCard(CardFaceType face, CardSuitType suit)
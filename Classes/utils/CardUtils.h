@@ -26,7 +26,7 @@
 #define __CARD_UTILS_H__
 
 #include "../models/CardModel.h"
-#include "cocos2d.h"
+#include "../core/CoreTypes.h"
 
 /**
  * 卡牌工具类
@@ -63,7 +63,7 @@ public:
      * @param suit 卡牌花色
      * @return 卡牌颜色
      */
-    static cocos2d::Color3B getCardColor(CardSuitType suit);
+    static CoreColor3B getCardColor(CardSuitType suit);
     
     /**
      * 检查两张卡牌是否相邻
@@ -77,7 +77,7 @@ public:
      * 获取卡牌尺寸
      * @return 卡牌尺寸
      */
-    static cocos2d::Size getCardSize();
+    static CoreSize getCardSize();
     
     /**
      * 计算扇形位置
@@ -87,7 +87,7 @@ public:
      * @param radius 半径
      * @return 计算后的位置
      */
-    static cocos2d::Vec2 calculateFanPosition(const cocos2d::Vec2& center, int index, int total, float radius);
+    static CoreVec2 calculateFanPosition(const CoreVec2& center, int index, int total, float radius);
     
     /**
      * 验证卡牌数据是否有效
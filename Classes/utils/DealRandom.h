@@ -0,0 +1,131 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __DEAL_RANDOM_H__
+#define __DEAL_RANDOM_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+/**
+ * 发牌随机数生成器（基于计数器）
+ * 职责：由 (种子, 牌局编号, 计数器) 直接计算出随机数，结果与平台和标准库实现无关
+ * 使用场景：可复现的洗牌与关卡生成；多个工作线程可直接定位到第 k 局或第 n 个随机数，
+ *           无需依次生成前面的序列
+ *
+ * 第 n 个输出为 mix(key + n * GOLDEN_GAMMA)，其中 key 由种子和牌局编号混合得到，
+ * mix 为 SplitMix64 的终结函数，因此跳转只需改写计数器。
+ */
+class DealRandom
+{
+public:
+    /**
+     * 构造函数
+     * @param seed 种子
+     * @param dealIndex 牌局编号，同一种子下每局使用独立序列
+     */
+    explicit DealRandom(uint64_t seed, uint64_t dealIndex = 0);
+    
+    /**
+     * 生成64位随机数
+     * @return 随机数
+     */
+    uint64_t nextUInt64()
+    {
+        return mix(_key + (_counter++) * GOLDEN_GAMMA);
+    }
+    
+    /**
+     * 生成32位随机数
+     * @return 随机数
+     */
+    uint32_t nextUInt32()
+    {
+        return (uint32_t)(nextUInt64() >> 32);
+    }
+    
+    /**
+     * 生成 [0, bound) 内均匀分布的随机数（无取模偏差）
+     * @param bound 上界，必须大于0
+     * @return 随机数
+     */
+    uint32_t nextBounded(uint32_t bound);
+    
+    /**
+     * 跳转到序列中的任意位置
+     * @param position 下一次输出在序列中的序号
+     */
+    void seek(uint64_t position) { _counter = position; }
+    
+    /**
+     * 跳过若干个输出
+     * @param count 跳过个数
+     */
+    void discard(uint64_t count) { _counter += count; }
+    
+    /**
+     * 获取当前位置
+     * @return 下一次输出在序列中的序号
+     */
+    uint64_t tell() const { return _counter; }
+    
+    /**
+     * Fisher-Yates 洗牌
+     * @param first 首元素迭代器
+     * @param count 元素个数
+     */
+    template <typename Iterator>
+    void shuffle(Iterator first, size_t count)
+    {
+        for (size_t i = count; i > 1; --i) {
+            size_t j = nextBounded((uint32_t)i);
+            std::swap(first[i - 1], first[j]);
+        }
+    }
+    
+    /**
+     * 从系统熵源生成新种子，用于调用方未指定种子的场景
+     * @return 种子
+     */
+    static uint64_t makeSeed();
+
+private:
+    static const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+    
+    /**
+     * SplitMix64 终结函数
+     */
+    static uint64_t mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+    
+    uint64_t _key;      ///< 由种子和牌局编号得到的序列键
+    uint64_t _counter;  ///< 计数器
+};
+
+#endif // __DEAL_RANDOM_H__
@@ -0,0 +1,85 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __PARALLEL_UTILS_H__
+#define __PARALLEL_UTILS_H__
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * 并行工具类
+ * 职责：把一组互相独立的任务分给多个线程执行
+ * 使用场景：批量求解、关卡生成、机器人对局、胜率模拟等按下标划分的离线计算
+ *
+ * 线程按下标逐个领取任务，空闲线程随时领取下一个，耗时不均的任务也不会让线程空等；
+ * 调用线程作为第0个线程参与执行。任务的结果应只取决于下标，这样输出与线程数和调度顺序无关。
+ */
+class ParallelUtils
+{
+public:
+    /**
+     * 计算实际使用的线程数
+     * @param threadCount 期望的线程数，<=0 时使用硬件并发数
+     * @param taskCount 任务数，线程数不超过任务数
+     * @return 线程数，至少为1
+     */
+    static int resolveThreadCount(int threadCount, long long taskCount);
+    
+    /**
+     * 并行执行 fn(threadIndex, index)，index 取遍 [0, count)
+     * 需要每线程独立状态（求解器、会话等）时，先用 resolveThreadCount 确定线程数并按 threadIndex 分配
+     * @param count 任务数
+     * @param threadCount 线程数，含义同 resolveThreadCount
+     * @param fn 任务函数，threadIndex 在 [0, resolveThreadCount(threadCount, count)) 内
+     * @param stop 可选的停止标志，置位后各线程不再领取新任务（已领取的任务照常完成）
+     */
+    template <typename Fn>
+    static void parallelFor(long long count, int threadCount, Fn fn, const std::atomic<bool>* stop = nullptr)
+    {
+        if (count <= 0) {
+            return;
+        }
+        threadCount = resolveThreadCount(threadCount, count);
+        std::atomic<long long> nextIndex(0);
+        auto worker = [&](int threadIndex) {
+            for (long long index = nextIndex++; index < count && !(stop && *stop); index = nextIndex++) {
+                fn(threadIndex, index);
+            }
+        };
+        
+        std::vector<std::thread> threads;
+        for (int i = 1; i < threadCount; ++i) {
+            threads.push_back(std::thread(worker, i));
+        }
+        worker(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+};
+
+#endif // __PARALLEL_UTILS_H__
@@ -166,3 +166,55 @@ int BottomPileView::removeTopCard()
     }
     return -1;
 }
+
+CardView* BottomPileView::getCardView(int cardId) const
+{
+    if (_topCardView && _topCardView->getCardId() == cardId) {
+        return _topCardView;
+    }
+    return nullptr;
+}
+
+void BottomPileView::detachStaleCardViews(CardView::DetachedViewMap& detachedViews)
+{
+    // 底牌区只显示顶部卡牌
+    const CardModel* topCard = _gameModel ? _gameModel->getBottomPileTopCard() : nullptr;
+    if (_topCardView && _topCardView->getCardModel() != topCard) {
+        _topCardView->retain();
+        _topCardView->removeFromParent();
+        detachedViews[_topCardView->getCardModel()] = _topCardView;
+        _topCardView = nullptr;
+    }
+}
+
+void BottomPileView::attachMissingCardViews(CardView::DetachedViewMap& detachedViews)
+{
+    CardModel* topCard = _gameModel ? _gameModel->getBottomPileTopCard() : nullptr;
+    if (!topCard) {
+        return;
+    }
+    
+    if (!_topCardView) {
+        auto detached = detachedViews.find(topCard);
+        if (detached != detachedViews.end()) {
+            _topCardView = detached->second;
+            detachedViews.erase(detached);
+            _topCardView->setClickCallback([this](int cardId) {
+                if (_cardClickCallback) {
+                    _cardClickCallback(cardId);
+                }
+            });
+            addChild(_topCardView);
+            _topCardView->release();
+        } else {
+            _topCardView = createCardView(topCard);
+            if (_topCardView) {
+                addChild(_topCardView);
+            }
+        }
+    }
+    
+    if (_topCardView) {
+        _topCardView->syncWithModel();
+    }
+}
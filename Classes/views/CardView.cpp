@@ -11,6 +11,8 @@ CardView::CardView()
     , _cardLabel(nullptr)
     , _isClickable(true)
     , _isRevealed(false)
+    , _displayedFace(-1)
+    , _displayedSuit(-1)
 {
 }
 
@@ -61,6 +63,32 @@ int CardView::getCardId() const
     return _cardModel ? _cardModel->getCardId() : -1;
 }
 
+const CardModel* CardView::getCardModel() const
+{
+    return _cardModel;
+}
+
+void CardView::syncWithModel()
+{
+    if (!_cardModel) return;
+
+    // 面值或花色变化时只重建卡面，节点本身和位置保持不变
+    if (_displayedFace != _cardModel->getFace() || _displayedSuit != _cardModel->getSuit()) {
+        removeAllChildren();
+        _cardSprite = nullptr;
+        _cardLabel = nullptr;
+        createCardSprite(_cardModel);
+    }
+
+    setClickable(_cardModel->isClickable());
+    setRevealed(_cardModel->isRevealed());
+}
+
+void CardView::setClickCallback(CardClickCallback clickCallback)
+{
+    _clickCallback = clickCallback;
+}
+
 void CardView::updateCard(const CardModel* cardModel)
 {
     _cardModel = cardModel;
@@ -117,6 +145,9 @@ void CardView::createCardSprite(const CardModel* cardModel)
 {
     if (!cardModel) return;
 
+    _displayedFace = cardModel->getFace();
+    _displayedSuit = cardModel->getSuit();
+
     // 使用卡牌背景
     _cardSprite = cocos2d::Sprite::create("card_general.png");
     if (_cardSprite) {
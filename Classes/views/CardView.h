@@ -3,6 +3,7 @@
 
 #include "cocos2d.h"
 #include <functional>
+#include <map>
 
 // Forward declaration to avoid include issues
 class CardModel;
@@ -11,6 +12,7 @@ class CardView : public cocos2d::Node
 {
 public:
     typedef std::function<void(int cardId)> CardClickCallback;
+    typedef std::map<const CardModel*, CardView*> DetachedViewMap;
     
     CardView();
     virtual ~CardView();
@@ -20,7 +22,10 @@ public:
     bool init(const CardModel* cardModel, CardClickCallback clickCallback = nullptr);
     
     int getCardId() const;
+    const CardModel* getCardModel() const;
     void updateCard(const CardModel* cardModel);
+    void syncWithModel();
+    void setClickCallback(CardClickCallback clickCallback);
     void playMoveAnimation(const cocos2d::Vec2& targetPosition, float duration, std::function<void()> callback = nullptr);
     void playMatchAnimation(std::function<void()> callback = nullptr);
     void playUndoAnimation(const cocos2d::Vec2& targetPosition, float duration, std::function<void()> callback = nullptr);
@@ -44,6 +49,8 @@ private:
     cocos2d::Label* _cardLabel;
     bool _isClickable;
     bool _isRevealed;
+    int _displayedFace;
+    int _displayedSuit;
 };
 
 #endif // __CARD_VIEW_H__
\ No newline at end of file
@@ -58,6 +58,8 @@ bool GameView::init(const GameModel* gameModel, UndoButtonCallback undoCallback)
     _undoButton = nullptr;
     _cardClickCallback = nullptr;
     _drawCardCallback = nullptr;
+    _loadingLabel = nullptr;
+    _hintCardId = -1;
     
     setupLayout();
     createUndoButton();
@@ -72,6 +74,15 @@ bool GameView::init(const GameModel* gameModel, UndoButtonCallback undoCallback)
 void GameView::updateGame(const GameModel* gameModel)
 {
     _gameModel = gameModel;
+    if (_mainPileView) {
+        _mainPileView->setGameModel(gameModel);
+    }
+    if (_bottomPileView) {
+        _bottomPileView->setGameModel(gameModel);
+    }
+    if (_reservePileView) {
+        _reservePileView->setGameModel(gameModel);
+    }
     updateDisplay();
 }
 
@@ -125,6 +136,37 @@ void GameView::updateDisplay()
     }
 }
 
+void GameView::syncCardViews()
+{
+    // 先从所有牌堆摘下不属于该牌堆的视图，再统一挂到新牌堆，
+    // 这样在牌堆之间移动的卡牌沿用原节点，动画从屏幕上的当前位置开始
+    CardView::DetachedViewMap detachedViews;
+    if (_mainPileView) {
+        _mainPileView->detachStaleCardViews(detachedViews);
+    }
+    if (_bottomPileView) {
+        _bottomPileView->detachStaleCardViews(detachedViews);
+    }
+    if (_reservePileView) {
+        _reservePileView->detachStaleCardViews(detachedViews);
+    }
+    
+    if (_mainPileView) {
+        _mainPileView->attachMissingCardViews(detachedViews);
+    }
+    if (_bottomPileView) {
+        _bottomPileView->attachMissingCardViews(detachedViews);
+    }
+    if (_reservePileView) {
+        _reservePileView->attachMissingCardViews(detachedViews);
+    }
+    
+    // 剩下的视图对应的卡牌已不再显示
+    for (auto& entry : detachedViews) {
+        entry.second->release();
+    }
+}
+
 void GameView::playMatchAnimation(int cardId, const cocos2d::Vec2& targetPosition, float duration, std::function<void()> callback)
 {
     cocos2d::log("GameView::playMatchAnimation - CardId: %d, target: (%.1f, %.1f)", 
@@ -151,6 +193,58 @@ void GameView::playMatchAnimation(int cardId, const cocos2d::Vec2& targetPositio
     }
 }
 
+void GameView::playUndoAnimation(int cardId, const cocos2d::Vec2& targetPosition, 
+                                 std::function<void()> callback)
+{
+    CardView* cardView = getCardView(cardId);
+    if (cardView) {
+        cardView->playUndoAnimation(targetPosition, 0.25f, callback);
+    } else if (callback) {
+        callback();
+    }
+}
+
+CardView* GameView::getCardView(int cardId) const
+{
+    CardView* cardView = nullptr;
+    if (_mainPileView) {
+        cardView = _mainPileView->getCardView(cardId);
+    }
+    if (!cardView && _bottomPileView) {
+        cardView = _bottomPileView->getCardView(cardId);
+    }
+    if (!cardView && _reservePileView) {
+        cardView = _reservePileView->getCardView(cardId);
+    }
+    return cardView;
+}
+
+void GameView::showHint(int cardId)
+{
+    clearHint();
+    CardView* cardView = getCardView(cardId);
+    if (!cardView) {
+        return;
+    }
+    auto scaleUp = cocos2d::ScaleTo::create(0.4f, 1.1f);
+    auto scaleDown = cocos2d::ScaleTo::create(0.4f, 1.0f);
+    auto pulse = cocos2d::RepeatForever::create(cocos2d::Sequence::create(scaleUp, scaleDown, nullptr));
+    pulse->setTag(HINT_ACTION_TAG);
+    cardView->runAction(pulse);
+    _hintCardId = cardId;
+}
+
+void GameView::clearHint()
+{
+    // 视图重建后原卡牌视图可能已不存在，动作随之销毁
+    CardView* cardView = _hintCardId >= 0 ? getCardView(_hintCardId) : nullptr;
+    if (cardView) {
+        cardView->stopActionByTag(HINT_ACTION_TAG);
+        cardView->setScale(1.0f);
+    }
+    _hintCardId = -1;
+}
+
 CardModel* GameView::drawTopCard()
 {
     if (_reservePileView) {
@@ -166,6 +260,35 @@ void GameView::setUndoButtonEnabled(bool enabled)
     }
 }
 
+void GameView::setLoading(bool loading)
+{
+    if (loading && !_loadingLabel) {
+        auto visibleSize = cocos2d::Director::getInstance()->getVisibleSize();
+        cocos2d::Vec2 origin = cocos2d::Director::getInstance()->getVisibleOrigin();
+        _loadingLabel = cocos2d::Label::createWithTTF("Loading...", "fonts/Marker Felt.ttf", 48);
+        if (_loadingLabel) {
+            _loadingLabel->setPosition(origin + cocos2d::Vec2(visibleSize.width / 2, visibleSize.height / 2));
+            addChild(_loadingLabel, 20);
+        }
+    }
+    if (_loadingLabel) {
+        _loadingLabel->setVisible(loading);
+    }
+    
+    if (_mainPileView) {
+        _mainPileView->setVisible(!loading);
+    }
+    if (_bottomPileView) {
+        _bottomPileView->setVisible(!loading);
+    }
+    if (_reservePileView) {
+        _reservePileView->setVisible(!loading);
+    }
+    if (loading) {
+        setUndoButtonEnabled(false);
+    }
+}
+
 void GameView::playEnterAnimation(std::function<void()> callback)
 {
     setScale(0.0f);
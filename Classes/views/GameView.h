@@ -103,6 +103,13 @@ public:
      */
     void updateDisplay();
     
+    /**
+     * 增量同步卡牌视图
+     * 只处理换了牌堆、新出现或已消失的卡牌，其余视图原地保留（包括位置），
+     * 用于撤销后配合 playUndoAnimation 播放过渡，代替 updateDisplay 的整体重建
+     */
+    void syncCardViews();
+    
     /**
      * 播放匹配动画
      * @param cardId 卡牌ID
@@ -158,12 +165,43 @@ public:
     void playUndoAnimation(int cardId, const cocos2d::Vec2& targetPosition, 
                           std::function<void()> callback = nullptr);
     
+    /**
+     * 在所有牌堆中查找卡牌视图
+     * @param cardId 卡牌ID
+     * @return 卡牌视图，未找到返回nullptr
+     */
+    CardView* getCardView(int cardId) const;
+    
+    /**
+     * 高亮提示的卡牌（循环缩放），同时取消之前的提示
+     * @param cardId 卡牌ID
+     */
+    void showHint(int cardId);
+    
+    /**
+     * 取消提示高亮
+     */
+    void clearHint();
+    
     /**
      * 设置撤销按钮是否可用
      * @param enabled 是否可用
      */
     void setUndoButtonEnabled(bool enabled);
     
+    /**
+     * 设置加载状态
+     * 加载中隐藏牌堆、显示加载提示并禁用撤销按钮
+     * @param loading 是否加载中
+     */
+    void setLoading(bool loading);
+    
+    /**
+     * 是否处于加载状态
+     * @return 是否加载中
+     */
+    bool isLoading() const { return _loadingLabel != nullptr && _loadingLabel->isVisible(); }
+    
     /**
      * 播放入场动画
      * @param callback 动画完成回调
@@ -177,6 +215,8 @@ public:
     void playExitAnimation(std::function<void()> callback = nullptr);
 
 private:
+    static const int HINT_ACTION_TAG = 7001;    ///< 提示高亮动作的标签
+    
     const GameModel* _gameModel;        ///< 游戏数据模型（只读）
     MainPileView* _mainPileView;        ///< 主牌堆视图
     BottomPileView* _bottomPileView;    ///< 底牌堆视图
@@ -185,6 +225,8 @@ private:
     UndoButtonCallback _undoCallback;   ///< 撤销按钮回调函数
     CardClickCallback _cardClickCallback; ///< 卡牌点击回调函数
     DrawCardCallback _drawCardCallback;   ///< 抽取卡牌回调函数
+    cocos2d::Label* _loadingLabel;      ///< 加载提示，首次进入加载状态时创建
+    int _hintCardId;                    ///< 当前高亮提示的卡牌ID，-1表示无
     
     /**
      * 创建撤销按钮
@@ -24,6 +24,7 @@
 
 #include "MainPileView.h"
 #include "../utils/CardUtils.h"
+#include <algorithm>
 
 USING_NS_CC;
 
@@ -176,6 +177,16 @@ void MainPileView::playCardFlipAnimation(int cardId, std::function<void()> callb
     }
 }
 
+CardView* MainPileView::getCardView(int cardId) const
+{
+    for (auto* cardView : _cardViews) {
+        if (cardView && cardView->getCardId() == cardId) {
+            return cardView;
+        }
+    }
+    return nullptr;
+}
+
 void MainPileView::removeCard(int cardId)
 {
     for (auto it = _cardViews.begin(); it != _cardViews.end(); ++it) {
@@ -198,3 +209,73 @@ void MainPileView::addCard(CardModel* card)
         }
     }
 }
+
+void MainPileView::detachStaleCardViews(CardView::DetachedViewMap& detachedViews)
+{
+    if (!_gameModel) {
+        return;
+    }
+    
+    const auto& cards = _gameModel->getMainPileCards();
+    for (auto it = _cardViews.begin(); it != _cardViews.end();) {
+        CardView* cardView = *it;
+        if (cardView && std::find(cards.begin(), cards.end(), cardView->getCardModel()) == cards.end()) {
+            cardView->retain();
+            cardView->removeFromParent();
+            detachedViews[cardView->getCardModel()] = cardView;
+            it = _cardViews.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MainPileView::attachMissingCardViews(CardView::DetachedViewMap& detachedViews)
+{
+    if (!_gameModel) {
+        return;
+    }
+    
+    // 按模型顺序重新排列视图，保证遮挡关系与模型一致
+    const auto& cards = _gameModel->getMainPileCards();
+    std::vector<CardView*> orderedViews;
+    orderedViews.reserve(cards.size());
+    for (auto* card : cards) {
+        if (!card) {
+            continue;
+        }
+        
+        CardView* cardView = nullptr;
+        for (auto* existingView : _cardViews) {
+            if (existingView && existingView->getCardModel() == card) {
+                cardView = existingView;
+                break;
+            }
+        }
+        
+        if (!cardView) {
+            auto detached = detachedViews.find(card);
+            if (detached != detachedViews.end()) {
+                cardView = detached->second;
+                detachedViews.erase(detached);
+                cardView->setClickCallback([this](int cardId) {
+                    onCardClicked(cardId);
+                });
+                addChild(cardView);
+                cardView->release();
+            } else {
+                cardView = createCardView(card);
+                if (cardView) {
+                    addChild(cardView);
+                }
+            }
+        }
+        
+        if (cardView) {
+            cardView->syncWithModel();
+            cardView->setLocalZOrder((int)orderedViews.size());
+            orderedViews.push_back(cardView);
+        }
+    }
+    _cardViews.swap(orderedViews);
+}
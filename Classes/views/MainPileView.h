@@ -61,6 +61,12 @@ public:
      */
     bool init(const GameModel* gameModel, CardClickCallback cardClickCallback);
     
+    /**
+     * 设置游戏模型（更换对局时调用，之后需调用 updateDisplay）
+     * @param gameModel 游戏模型
+     */
+    void setGameModel(const GameModel* gameModel) { _gameModel = gameModel; }
+    
     /**
      * 更新显示
      */
@@ -93,6 +99,27 @@ public:
      * @param card 卡牌模型
      */
     void addCard(CardModel* card);
+    
+    /**
+     * 根据卡牌ID获取卡牌视图
+     * @param cardId 卡牌ID
+     * @return 卡牌视图，未找到返回nullptr
+     */
+    CardView* getCardView(int cardId) const;
+    
+    /**
+     * 摘下不再属于本牌堆的卡牌视图
+     * 摘下的视图保留引用，供其他牌堆在 attachMissingCardViews 中复用
+     * @param detachedViews 输出摘下的视图，按卡牌模型索引
+     */
+    void detachStaleCardViews(CardView::DetachedViewMap& detachedViews);
+    
+    /**
+     * 为本牌堆中还没有视图的卡牌挂上视图，优先复用已摘下的视图
+     * 已有视图只同步状态，不重建
+     * @param detachedViews 可复用的视图，被复用的条目会移除
+     */
+    void attachMissingCardViews(CardView::DetachedViewMap& detachedViews);
 
 private:
     /**
@@ -24,6 +24,7 @@
 
 #include "ReservePileView.h"
 #include "../utils/CardUtils.h"
+#include <algorithm>
 #include "ui/CocosGUI.h"
 
 USING_NS_CC;
@@ -237,3 +238,90 @@ CardModel* ReservePileView::drawTopCard()
     
     return topCard;
 }
+
+CardView* ReservePileView::getCardView(int cardId) const
+{
+    for (auto* cardView : _cardViews) {
+        if (cardView && cardView->getCardId() == cardId) {
+            return cardView;
+        }
+    }
+    return nullptr;
+}
+
+void ReservePileView::detachStaleCardViews(CardView::DetachedViewMap& detachedViews)
+{
+    if (!_gameModel) {
+        return;
+    }
+    
+    const auto& cards = _gameModel->getReservePileCards();
+    for (auto it = _cardViews.begin(); it != _cardViews.end();) {
+        CardView* cardView = *it;
+        if (cardView && std::find(cards.begin(), cards.end(), cardView->getCardModel()) == cards.end()) {
+            cardView->retain();
+            cardView->removeFromParent();
+            detachedViews[cardView->getCardModel()] = cardView;
+            it = _cardViews.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ReservePileView::attachMissingCardViews(CardView::DetachedViewMap& detachedViews)
+{
+    if (!_gameModel) {
+        return;
+    }
+    
+    // 按模型顺序重新排列视图，保证遮挡关系与模型一致
+    const auto& cards = _gameModel->getReservePileCards();
+    std::vector<CardView*> orderedViews;
+    orderedViews.reserve(cards.size());
+    for (auto* card : cards) {
+        if (!card) {
+            continue;
+        }
+        
+        CardView* cardView = nullptr;
+        for (auto* existingView : _cardViews) {
+            if (existingView && existingView->getCardModel() == card) {
+                cardView = existingView;
+                break;
+            }
+        }
+        
+        if (!cardView) {
+            auto detached = detachedViews.find(card);
+            if (detached != detachedViews.end()) {
+                cardView = detached->second;
+                detachedViews.erase(detached);
+                cardView->setClickCallback([this](int cardId) {
+                    if (_cardClickCallback) {
+                        _cardClickCallback(cardId);
+                    }
+                });
+                addChild(cardView);
+                cardView->release();
+            } else {
+                cardView = createCardView(card);
+                if (cardView) {
+                    addChild(cardView);
+                }
+            }
+        }
+        
+        if (cardView) {
+            cardView->syncWithModel();
+            cardView->setLocalZOrder((int)orderedViews.size());
+            orderedViews.push_back(cardView);
+        }
+    }
+    _cardViews.swap(orderedViews);
+    
+    // 更新按钮状态
+    if (_drawCardButton) {
+        _drawCardButton->setEnabled(!cards.empty());
+    }
+}
@@ -0,0 +1,226 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "Commands.h"
+#if !defined(POKERGAME_CORE_HEADLESS)
+#include "configs/loaders/LevelConfigLoader.h"
+#endif
+#include "services/BotPlayer.h"
+#include "services/LevelGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+/**
+ * 一行统计输出
+ */
+struct BotReportRow
+{
+    std::string level;          ///< 关卡名（文件路径、生成编号或 total）
+    BotPolicyType policy;       ///< 策略
+    BotStats stats;             ///< 统计
+};
+
+void writeCsv(std::FILE* file, const std::vector<BotReportRow>& rows)
+{
+    std::fprintf(file, "level,policy,games,wins,win_rate,avg_moves,avg_win_moves,avg_undos,undo_game_rate\n");
+    for (const auto& row : rows) {
+        const BotStats& stats = row.stats;
+        double games = stats.games > 0 ? (double)stats.games : 1.0;
+        std::fprintf(file, "%s,%s,%lld,%lld,%.4f,%.2f,%.2f,%.3f,%.4f\n", row.level.c_str(),
+                     BotPlayer::getPolicyName(row.policy), stats.games, stats.wins, stats.wins / games,
+                     stats.moves / games, stats.wins > 0 ? (double)stats.winMoves / stats.wins : 0.0,
+                     stats.undos / games, stats.gamesWithUndo / games);
+    }
+}
+
+void writeJson(std::FILE* file, const std::vector<BotReportRow>& rows)
+{
+    std::fprintf(file, "[\n");
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const BotStats& stats = rows[i].stats;
+        double games = stats.games > 0 ? (double)stats.games : 1.0;
+        std::fprintf(file, "  {\"level\": \"%s\", \"policy\": \"%s\", \"games\": %lld, \"wins\": %lld, "
+                     "\"winRate\": %.4f, \"avgMoves\": %.2f, \"avgWinMoves\": %.2f, \"avgUndos\": %.3f, "
+                     "\"undoGameRate\": %.4f}%s\n", rows[i].level.c_str(), BotPlayer::getPolicyName(rows[i].policy),
+                     stats.games, stats.wins, stats.wins / games, stats.moves / games,
+                     stats.wins > 0 ? (double)stats.winMoves / stats.wins : 0.0, stats.undos / games,
+                     stats.gamesWithUndo / games, i + 1 < rows.size() ? "," : "");
+    }
+    std::fprintf(file, "]\n");
+}
+
+/**
+ * 加载指定的关卡文件与目录
+ * @param files 命令行给出的关卡文件，追加 --dir 目录中的文件后按关卡ID排序
+ * @param levels 输出关卡配置，加载失败的文件对应nullptr
+ * @param levelNames 输出关卡名称
+ * @return 布局模板加载失败，或无引擎构建（加载器依赖引擎）时返回false
+ */
+bool loadLevels(const CommandArgs& args, std::vector<std::string>& files, std::vector<LevelConfig*>& levels,
+                std::vector<std::string>& levelNames)
+{
+#if defined(POKERGAME_CORE_HEADLESS)
+    std::printf("Level files are not supported in the headless build\n");
+    return false;
+#else
+    if (args.has("dir")) {
+        listLevelFiles(args.getString("dir", "."), files);
+    }
+    if (!loadLayoutTemplates(args)) {
+        return false;
+    }
+    std::sort(files.begin(), files.end(), [](const std::string& a, const std::string& b) {
+        int idA = parseLevelId(a);
+        int idB = parseLevelId(b);
+        return idA != idB ? idA < idB : a < b;
+    });
+    for (const auto& file : files) {
+        LevelConfigLoader::LoadError error;
+        levels.push_back(LevelConfigLoader::loadLevelConfigFromFile(file, &error));
+        levelNames.push_back(file);
+        if (!levels.back()) {
+            std::printf("%s:%d:%d: %s\n", file.c_str(), error.line, error.column, error.message.c_str());
+        }
+    }
+    return true;
+#endif
+}
+
+} // namespace
+
+int runBotCommand(const CommandArgs& args)
+{
+    const char* usage =
+        "Usage: bot [--policy random|greedy|solver|all] [--games N] [--threads T] [--seed S] [--max-moves N]\n"
+        "           [--max-undos N] [--format csv|json] [--out <file>] [--totals-only]\n"
+        "           [--dir <directory>] [--layouts <layouts.json>] [file.json ...]\n"
+        "           [--count N] [--layout peaks|pyramid|grid] [--main N] [--reserve N] [--decks N]\n";
+    
+    std::vector<BotPolicyType> policies;
+    std::string policyName = args.getString("policy", "all");
+    BotPolicyType policy = BPT_RANDOM;
+    if (policyName == "all") {
+        policies.push_back(BPT_RANDOM);
+        policies.push_back(BPT_GREEDY);
+        policies.push_back(BPT_SOLVER);
+    } else if (BotPlayer::parsePolicyName(policyName, policy)) {
+        policies.push_back(policy);
+    } else {
+        std::printf("Unknown policy: %s\n%s", policyName.c_str(), usage);
+        return 1;
+    }
+    std::string format = args.getString("format", "csv");
+    if (format != "csv" && format != "json") {
+        std::printf("Unknown format: %s\n%s", format.c_str(), usage);
+        return 1;
+    }
+    
+    // 关卡来源：指定的关卡文件，否则按参数生成
+    std::vector<std::string> files = args.getPositionals();
+    std::vector<LevelConfig*> levels;
+    std::vector<std::string> levelNames;
+    if (args.has("dir") || !files.empty()) {
+        if (!loadLevels(args, files, levels, levelNames)) {
+            std::printf("%s", usage);
+            return 1;
+        }
+    } else {
+        LevelGenerateParams params;
+        std::string layoutName = args.getString("layout", LevelGenerator::getLayoutName(params.layout));
+        params.mainCardCount = (int)args.getInt("main", params.mainCardCount);
+        params.reserveCardCount = (int)args.getInt("reserve", params.reserveCardCount);
+        params.deckCount = (int)args.getInt("decks", params.deckCount);
+        if (!LevelGenerator::parseLayoutName(layoutName, params.layout) || !LevelGenerator::isValidParams(params)) {
+            std::printf("%s", usage);
+            return 1;
+        }
+        int count = (int)args.getInt("count", 20);
+        LevelGenerator::generateLevels(params, (uint64_t)args.getInt("seed", 1), 0, count,
+                                       (int)args.getInt("threads", 0), levels);
+        for (int i = 0; i < count; ++i) {
+            levelNames.push_back("generated#" + std::to_string(i));
+        }
+    }
+    
+    int gamesPerLevel = (int)args.getInt("games", 100);
+    int threadCount = (int)args.getInt("threads", 0);
+    BotParams params;
+    params.seed = (uint64_t)args.getInt("seed", (long long)params.seed);
+    params.maxMoves = (int)args.getInt("max-moves", params.maxMoves);
+    params.maxUndos = (int)args.getInt("max-undos", params.maxUndos);
+
+#if defined(POKERGAME_CORE_HEADLESS)
+    // 每步操作都会保存状态快照并输出日志，批量对局时关闭
+    coreLogEnabled() = false;
+#endif
+
+    std::vector<const LevelConfig*> levelInputs(levels.begin(), levels.end());
+    std::vector<BotReportRow> rows;
+    long long totalGames = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (BotPolicyType type : policies) {
+        std::vector<BotStats> levelStats;
+        BotPlayer::playLevels(levelInputs, gamesPerLevel, [type]() { return BotPlayer::createPolicy(type); },
+                              params, threadCount, levelStats);
+        BotReportRow total = { "total", type, BotStats() };
+        for (size_t i = 0; i < levelStats.size(); ++i) {
+            if (!args.has("totals-only")) {
+                BotReportRow row = { levelNames[i], type, levelStats[i] };
+                rows.push_back(row);
+            }
+            total.stats.merge(levelStats[i]);
+        }
+        rows.push_back(total);
+        totalGames += total.stats.games;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    int failures = 0;
+    for (auto* level : levels) {
+        failures += level ? 0 : 1;
+        delete level;
+    }
+    
+    std::string outPath = args.getString("out", "");
+    std::FILE* file = outPath.empty() ? stdout : std::fopen(outPath.c_str(), "w");
+    if (!file) {
+        std::printf("Cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    if (format == "json") {
+        writeJson(file, rows);
+    } else {
+        writeCsv(file, rows);
+    }
+    if (file != stdout) {
+        std::fclose(file);
+        std::printf("Played %lld games on %zu levels in %.3f s (%.0f games/s), wrote %s\n", totalGames,
+                    levels.size(), seconds, seconds > 0 ? totalGames / seconds : 0.0, outPath.c_str());
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __TOOLS_COMMANDS_H__
+#define __TOOLS_COMMANDS_H__
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+/**
+ * 命令行参数
+ * 职责：解析 "--key value" 形式的参数，供各个子命令读取
+ * 使用场景：离线工具（校验、打包、批量生成等）的参数读取
+ */
+class CommandArgs
+{
+public:
+    /**
+     * 构造函数
+     * @param args 子命令名之后的参数列表
+     */
+    explicit CommandArgs(const std::vector<std::string>& args) : _args(args) {}
+    
+    /**
+     * 是否包含指定开关
+     * @param name 参数名（不含"--"）
+     * @return 是否包含
+     */
+    bool has(const std::string& name) const
+    {
+        return find(name) >= 0;
+    }
+    
+    /**
+     * 读取字符串参数
+     * @param name 参数名（不含"--"）
+     * @param defaultValue 默认值
+     * @return 参数值
+     */
+    std::string getString(const std::string& name, const std::string& defaultValue) const
+    {
+        int index = find(name);
+        if (index < 0 || index + 1 >= (int)_args.size()) {
+            return defaultValue;
+        }
+        return _args[index + 1];
+    }
+    
+    /**
+     * 读取整数参数
+     * @param name 参数名（不含"--"）
+     * @param defaultValue 默认值
+     * @return 参数值
+     */
+    long long getInt(const std::string& name, long long defaultValue) const
+    {
+        std::string value = getString(name, "");
+        return value.empty() ? defaultValue : std::strtoll(value.c_str(), nullptr, 10);
+    }
+    
+    /**
+     * 获取不带"--"前缀的位置参数
+     * @return 位置参数列表
+     */
+    std::vector<std::string> getPositionals() const
+    {
+        std::vector<std::string> result;
+        for (size_t i = 0; i < _args.size(); ++i) {
+            if (_args[i].compare(0, 2, "--") == 0) {
+                // 跳过开关及其取值
+                if (i + 1 < _args.size() && _args[i + 1].compare(0, 2, "--") != 0) {
+                    ++i;
+                }
+                continue;
+            }
+            result.push_back(_args[i]);
+        }
+        return result;
+    }
+
+private:
+    int find(const std::string& name) const
+    {
+        std::string key = "--" + name;
+        for (size_t i = 0; i < _args.size(); ++i) {
+            if (_args[i] == key) {
+                return (int)i;
+            }
+        }
+        return -1;
+    }
+    
+    std::vector<std::string> _args; ///< 原始参数
+};
+
+/**
+ * 从文件名解析关卡ID，文件名格式为 levelN.json
+ * @param fileName 文件名（可带路径）
+ * @return 关卡ID，格式不符返回-1
+ */
+int parseLevelId(const std::string& fileName);
+
+/**
+ * 列出目录下的关卡文件（levelN.json）
+ * @param directory 目录
+ * @param files 输出文件路径，追加到末尾
+ */
+void listLevelFiles(const std::string& directory, std::vector<std::string>& files);
+
+/**
+ * 加载关卡文件引用的布局模板
+ * 指定 --layouts 时加载该文件，否则加载 --dir 目录下的 layouts.json（存在时）
+ * @param args 命令行参数
+ * @return 指定的文件加载失败时返回false
+ */
+bool loadLayoutTemplates(const CommandArgs& args);
+
+/**
+ * 子命令入口函数类型
+ * @param args 命令行参数
+ * @return 进程退出码
+ */
+typedef int (*CommandFunc)(const CommandArgs& args);
+
+/**
+ * 撤销可逆性模糊测试：随机对局上执行随机合法操作序列，验证全部撤销后状态哈希一致
+ */
+int runUndoFuzzCommand(const CommandArgs& args);
+
+/**
+ * 关卡配置解析模糊测试：变异关卡JSON，验证加载器要么返回满足模式的配置，要么给出带行列号的错误
+ */
+int runLevelFuzzCommand(const CommandArgs& args);
+
+/**
+ * 撤销记录与状态快照的吞吐量基准测试
+ */
+int runUndoBenchCommand(const CommandArgs& args);
+
+/**
+ * 将 levelN.json 关卡文件编译为二进制关卡包
+ */
+int runLevelPackCommand(const CommandArgs& args);
+
+/**
+ * 批量生成可解关卡，输出吞吐量并可写出 levelN.json
+ */
+int runLevelGenerateCommand(const CommandArgs& args);
+
+/**
+ * 校验关卡并分析可解性、最少步数、随机对局胜率、分支数与致死操作比例
+ */
+int runLevelAnalyzeCommand(const CommandArgs& args);
+
+/**
+ * 用 GameSolver 多线程求解生成的对局，校验最短操作序列并统计吞吐量与单局耗时
+ */
+int runGameSolveCommand(const CommandArgs& args);
+
+/**
+ * 隐藏生成对局的备用牌，用蒙特卡洛模拟估计胜率与置信区间
+ */
+int runWinEstimateCommand(const CommandArgs& args);
+
+/**
+ * 机器人批量对局：用随机、贪心或求解器策略游玩关卡，输出胜率、步数与撤销统计（CSV/JSON）
+ */
+int runBotCommand(const CommandArgs& args);
+
+/**
+ * 批量生成每日挑战牌局：多线程求解并按难度区间筛选，按牌局编号顺序写出二进制记录，支持从检查点续跑
+ */
+int runDailyDealCommand(const CommandArgs& args);
+
+/**
+ * 统计合法操作树的叶子数（perft），可按第一步拆分、与参照实现比对，并运行已知局面测试集
+ */
+int runPerftCommand(const CommandArgs& args);
+
+#endif // __TOOLS_COMMANDS_H__
@@ -0,0 +1,318 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "Commands.h"
+#include "configs/loaders/DailyDealFormat.h"
+#include "services/GameModelFromLevelGenerator.h"
+#include "services/GameSolver.h"
+#include "services/LevelGenerator.h"
+#include "utils/ParallelUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/**
+ * 单局的处理结果
+ */
+enum DealVerdict
+{
+    DV_ACCEPTED,        ///< 可解且难度在区间内，已写出记录
+    DV_NOT_DEALT,       ///< 生成器在尝试次数内没有发出可解的牌
+    DV_UNVERIFIED,      ///< 求解器未能在节点上限内给出最短解
+    DV_OUT_OF_BAND      ///< 难度不在区间内
+};
+
+/**
+ * 生成、求解并按难度筛选一局
+ * @param solver 当前线程的求解器
+ * @param params 生成参数
+ * @param header 输出文件头（种子与难度区间）
+ * @param dealIndex 牌局编号
+ * @param nodeLimit 求解节点上限
+ * @param record 输出记录（header.recordSize 字节），仅 DV_ACCEPTED 时写入
+ * @param swapCount 输出最优解中的交换次数，已求解时有效
+ * @return 处理结果
+ */
+DealVerdict evaluateDeal(GameSolver& solver, const LevelGenerateParams& params, const DailyDealHeader& header,
+                         uint64_t dealIndex, long long nodeLimit, uint8_t* record, int& swapCount)
+{
+    LevelConfig* level = LevelGenerator::generateLevel(params, header.seed, dealIndex);
+    if (!level) {
+        return DV_NOT_DEALT;
+    }
+    GameModel* gameModel = GameModelFromLevelGenerator::generateSeededGameModel(level, header.seed, dealIndex);
+    delete level;
+    
+    GameSolveResult result;
+    if (!gameModel || !solver.solve(gameModel, result, nodeLimit)) {
+        delete gameModel;
+        return DV_UNVERIFIED;
+    }
+    swapCount = 0;
+    for (const auto& move : result.line) {
+        swapCount += move.type == GMT_RESERVE_TO_BOTTOM ? 1 : 0;
+    }
+    if (swapCount < header.minSwaps || swapCount > header.maxSwaps) {
+        delete gameModel;
+        return DV_OUT_OF_BAND;
+    }
+    
+    // 记录头之后按主牌堆、底牌、备用牌顺序写卡牌字节，其余补零
+    std::memset(record, 0, header.recordSize);
+    DailyDealRecord recordHeader = { (uint32_t)dealIndex, (uint8_t)result.line.size(), (uint8_t)swapCount, 0 };
+    std::memcpy(record, &recordHeader, sizeof(recordHeader));
+    uint8_t* card = record + sizeof(recordHeader);
+    for (const auto* cardList : { &gameModel->getMainPileCards(), &gameModel->getBottomPileCards(),
+                                  &gameModel->getReservePileCards() }) {
+        for (const auto* model : *cardList) {
+            *card++ = (uint8_t)(model->getFace() | (model->getSuit() << 4));
+        }
+    }
+    delete gameModel;
+    return DV_ACCEPTED;
+}
+
+/**
+ * 读取检查点
+ * @return 文件存在且格式正确
+ */
+bool readCheckpoint(const std::string& path, DailyDealCheckpoint& checkpoint)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fread(&checkpoint, sizeof(checkpoint), 1, file) == 1 &&
+              std::memcmp(checkpoint.magic, DAILY_DEAL_CHECKPOINT_MAGIC, 4) == 0 &&
+              checkpoint.version == DAILY_DEAL_VERSION;
+    std::fclose(file);
+    return ok;
+}
+
+/**
+ * 写入检查点：先写临时文件再替换，中断时旧检查点保持完整
+ * @return 是否成功
+ */
+bool writeCheckpoint(const std::string& path, const DailyDealCheckpoint& checkpoint)
+{
+    std::string tempPath = path + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(&checkpoint, sizeof(checkpoint), 1, file) == 1;
+    ok = std::fclose(file) == 0 && ok;
+    if (ok && std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        // 部分平台不允许覆盖已有文件
+        std::remove(path.c_str());
+        ok = std::rename(tempPath.c_str(), path.c_str()) == 0;
+    }
+    return ok;
+}
+
+/**
+ * 打开输出文件准备续写：丢弃检查点之后未确认的内容
+ * @param path 输出文件路径
+ * @param header 期望的文件头
+ * @param outputBytes 已确认的字节数
+ * @return 文件指针（位于末尾），文件头不一致或内容不足时返回nullptr
+ */
+std::FILE* reopenOutput(const std::string& path, const DailyDealHeader& header, uint64_t outputBytes)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return nullptr;
+    }
+    std::string data((size_t)outputBytes, '\0');
+    bool ok = outputBytes >= sizeof(header) && std::fread(&data[0], 1, data.size(), file) == data.size() &&
+              std::memcmp(data.data(), &header, sizeof(header)) == 0;
+    bool longer = ok && std::fgetc(file) != EOF;
+    std::fclose(file);
+    if (!ok) {
+        return nullptr;
+    }
+    if (!longer) {
+        return std::fopen(path.c_str(), "ab");
+    }
+    
+    // 标准库无法截断文件，重写已确认的部分
+    file = std::fopen(path.c_str(), "wb");
+    if (file && std::fwrite(data.data(), 1, data.size(), file) != data.size()) {
+        std::fclose(file);
+        return nullptr;
+    }
+    return file;
+}
+
+} // namespace
+
+int runDailyDealCommand(const CommandArgs& args)
+{
+    LevelGenerateParams params;
+    params.mainCardCount = 40;
+    std::string layoutName = args.getString("layout", LevelGenerator::getLayoutName(params.layout));
+    if (!LevelGenerator::parseLayoutName(layoutName, params.layout)) {
+        std::printf("Unknown layout: %s (expected peaks, pyramid or grid)\n", layoutName.c_str());
+        return 1;
+    }
+    params.mainCardCount = (int)args.getInt("main", params.mainCardCount);
+    params.reserveCardCount = (int)args.getInt("reserve", params.reserveCardCount);
+    params.deckCount = (int)args.getInt("decks", params.deckCount);
+    params.maxAttempts = (int)args.getInt("attempts", params.maxAttempts);
+    long long count = args.getInt("count", 1000);
+    int minSwaps = (int)args.getInt("min-swaps", 0);
+    int maxSwaps = (int)args.getInt("max-swaps", 255);
+    int batchSize = (int)args.getInt("batch", 1024);
+    if (!LevelGenerator::isValidParams(params) || count <= 0 || batchSize <= 0 ||
+        minSwaps < 0 || maxSwaps > 255 || minSwaps > maxSwaps) {
+        std::printf("Usage: daily [--count N] [--seed S] [--first-deal K] [--max-deals N] [--threads T] [--batch N]\n"
+                    "             [--min-swaps N] [--max-swaps N] [--nodes N] [--out <file>] [--checkpoint <file>] [--resume]\n"
+                    "             [--layout peaks|pyramid|grid] [--main N] [--reserve N] [--decks N] [--attempts N]\n");
+        return 1;
+    }
+    uint64_t firstDeal = (uint64_t)args.getInt("first-deal", 0);
+    uint64_t maxDeals = (uint64_t)args.getInt("max-deals", count * 1000);
+    uint64_t endDeal = std::min(firstDeal + maxDeals, (uint64_t)UINT32_MAX + 1);
+    int threadCount = ParallelUtils::resolveThreadCount((int)args.getInt("threads", 0), batchSize);
+    long long nodeLimit = args.getInt("nodes", GameSolver::DEFAULT_NODE_LIMIT);
+    std::string outputPath = args.getString("out", "daily.deals");
+    std::string checkpointPath = args.getString("checkpoint", outputPath + ".ckpt");
+    
+    DailyDealHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, DAILY_DEAL_MAGIC, 4);
+    header.version = DAILY_DEAL_VERSION;
+    header.byteOrderMark = DAILY_DEAL_BYTE_ORDER_MARK;
+    header.recordSize = getDailyDealRecordSize(params.mainCardCount + 1 + params.reserveCardCount);
+    header.seed = (uint64_t)args.getInt("seed", 1);
+    header.layout = (uint8_t)params.layout;
+    header.mainCount = (uint8_t)params.mainCardCount;
+    header.reserveCount = (uint8_t)params.reserveCardCount;
+    header.deckCount = (uint8_t)params.deckCount;
+    header.minSwaps = (uint8_t)minSwaps;
+    header.maxSwaps = (uint8_t)maxSwaps;
+    
+    // 续跑时检查点中的文件头必须与本次参数一致；生成尝试次数影响发牌结果，但不写入文件头，需调用方保持一致
+    DailyDealCheckpoint checkpoint;
+    std::memset(&checkpoint, 0, sizeof(checkpoint));
+    std::FILE* output = nullptr;
+    if (args.has("resume") && readCheckpoint(checkpointPath, checkpoint)) {
+        if (std::memcmp(&checkpoint.header, &header, sizeof(header)) != 0) {
+            std::printf("Checkpoint %s was written with different parameters\n", checkpointPath.c_str());
+            return 1;
+        }
+        output = reopenOutput(outputPath, header, checkpoint.outputBytes);
+        if (!output) {
+            std::printf("Cannot resume: %s does not match checkpoint %s\n", outputPath.c_str(), checkpointPath.c_str());
+            return 1;
+        }
+        std::printf("Resuming at deal %llu with %llu deals accepted\n",
+                    (unsigned long long)checkpoint.nextDealIndex, (unsigned long long)checkpoint.acceptedCount);
+    } else {
+        std::memcpy(checkpoint.magic, DAILY_DEAL_CHECKPOINT_MAGIC, 4);
+        checkpoint.version = DAILY_DEAL_VERSION;
+        checkpoint.header = header;
+        checkpoint.nextDealIndex = firstDeal;
+        checkpoint.outputBytes = sizeof(header);
+        output = std::fopen(outputPath.c_str(), "wb");
+        if (!output || std::fwrite(&header, sizeof(header), 1, output) != 1) {
+            std::printf("Failed to write %s\n", outputPath.c_str());
+            if (output) {
+                std::fclose(output);
+            }
+            return 1;
+        }
+    }
+    
+    // 每个线程持有独立的求解器；批内按下标领取牌局，批末按牌局编号顺序写出，输出与线程数无关
+    std::vector<GameSolver*> solvers;
+    for (int i = 0; i < threadCount; ++i) {
+        solvers.push_back(new GameSolver());
+    }
+    std::vector<uint8_t> records((size_t)batchSize * header.recordSize);
+    std::vector<uint8_t> verdicts(batchSize);
+    std::vector<uint8_t> swapCounts(batchSize);
+    long long verdictCounts[4] = { 0, 0, 0, 0 };
+    std::vector<long long> swapHistogram(256, 0);
+    uint64_t processedCount = 0;
+    bool written = true;
+    
+    auto start = std::chrono::steady_clock::now();
+    while ((long long)checkpoint.acceptedCount < count && checkpoint.nextDealIndex < endDeal && written) {
+        const uint64_t batchFirst = checkpoint.nextDealIndex;
+        const int batchCount = (int)std::min((uint64_t)batchSize, endDeal - batchFirst);
+        ParallelUtils::parallelFor(batchCount, threadCount, [&](int threadIndex, long long index) {
+            int swapCount = 0;
+            verdicts[index] = (uint8_t)evaluateDeal(*solvers[threadIndex], params, header, batchFirst + index,
+                                                    nodeLimit, &records[(size_t)index * header.recordSize], swapCount);
+            swapCounts[index] = (uint8_t)std::min(swapCount, 255);
+        });
+        
+        // 达到目标数后，检查点停在最后一条写出记录之后的牌局
+        int committed = 0;
+        while (committed < batchCount && (long long)checkpoint.acceptedCount < count) {
+            int index = committed++;
+            ++verdictCounts[verdicts[index]];
+            if (verdicts[index] == DV_ACCEPTED || verdicts[index] == DV_OUT_OF_BAND) {
+                ++swapHistogram[swapCounts[index]];
+            }
+            if (verdicts[index] != DV_ACCEPTED) {
+                continue;
+            }
+            written = written && std::fwrite(&records[(size_t)index * header.recordSize], header.recordSize, 1, output) == 1;
+            ++checkpoint.acceptedCount;
+            checkpoint.outputBytes += header.recordSize;
+        }
+        processedCount += committed;
+        checkpoint.nextDealIndex = batchFirst + committed;
+        written = written && std::fflush(output) == 0 && writeCheckpoint(checkpointPath, checkpoint);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    written = std::fclose(output) == 0 && written;
+    for (auto* solver : solvers) {
+        delete solver;
+    }
+    
+    long long accepted = verdictCounts[DV_ACCEPTED];
+    std::printf("Accepted %llu/%lld %s deals (main %d, reserve %d, swaps %d-%d) in %.3f s with %d threads\n",
+                (unsigned long long)checkpoint.acceptedCount, count, layoutName.c_str(), params.mainCardCount,
+                params.reserveCardCount, minSwaps, maxSwaps, seconds, threadCount);
+    std::printf("  this run: %llu deals, %lld accepted, %lld out of band, %lld unverified, %lld not dealt, %.0f deals/s\n",
+                (unsigned long long)processedCount, accepted, verdictCounts[DV_OUT_OF_BAND], verdictCounts[DV_UNVERIFIED],
+                verdictCounts[DV_NOT_DEALT], seconds > 0 ? processedCount / seconds : 0.0);
+    // 所有求解成功的牌局按交换次数分布，用于调整难度区间
+    for (int swaps = 0; swaps < 256; ++swaps) {
+        if (swapHistogram[swaps] > 0) {
+            std::printf("  solved with %d swaps: %lld%s\n", swaps, swapHistogram[swaps],
+                        swaps >= minSwaps && swaps <= maxSwaps ? " (in band)" : "");
+        }
+    }
+    std::printf(written ? "Wrote %s (next deal %llu)\n" : "Failed to write %s (next deal %llu)\n",
+                outputPath.c_str(), (unsigned long long)checkpoint.nextDealIndex);
+    return written && (long long)checkpoint.acceptedCount >= count ? 0 : 1;
+}
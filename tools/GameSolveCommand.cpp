@@ -0,0 +1,148 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include "services/GameModelFromLevelGenerator.h"
+#include "services/GameSolver.h"
+#include "services/MoveGenerator.h"
+#include "services/LevelGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+/**
+ * 按 TestScene 规则在紧凑局面上回放操作序列
+ * @return 每一步点击的卡牌都在对应牌堆中且合法，最终清空主牌堆
+ */
+bool playLine(const GameModel* gameModel, const std::vector<GameMove>& line)
+{
+    MoveGenerator::Board board;
+    if (!MoveGenerator::buildBoard(gameModel, board)) {
+        return false;
+    }
+    for (const auto& gameMove : line) {
+        MoveGenerator::Move move;
+        if (!MoveGenerator::findMove(board, gameMove.cardId, move) || move.type != gameMove.type ||
+            board.faces[move.card] != gameMove.face) {
+            return false;
+        }
+        MoveGenerator::applyMove(board, move);
+    }
+    return MoveGenerator::isWon(board);
+}
+
+} // namespace
+
+int runGameSolveCommand(const CommandArgs& args)
+{
+    LevelGenerateParams params;
+    params.mainCardCount = 40;
+    std::string layoutName = args.getString("layout", LevelGenerator::getLayoutName(params.layout));
+    if (!LevelGenerator::parseLayoutName(layoutName, params.layout)) {
+        std::printf("Unknown layout: %s (expected peaks, pyramid or grid)\n", layoutName.c_str());
+        return 1;
+    }
+    params.mainCardCount = (int)args.getInt("main", params.mainCardCount);
+    params.reserveCardCount = (int)args.getInt("reserve", params.reserveCardCount);
+    params.deckCount = (int)args.getInt("decks", params.deckCount);
+    if (!LevelGenerator::isValidParams(params)) {
+        std::printf("Usage: solve [--count N] [--seed S] [--threads T] [--layout peaks|pyramid|grid] [--main N] [--reserve N]\n"
+                    "             [--decks N] [--nodes N] [--compare]\n");
+        return 1;
+    }
+    int count = (int)args.getInt("count", 1000);
+    uint64_t seed = (uint64_t)args.getInt("seed", 1);
+    int threadCount = (int)args.getInt("threads", 0);
+    long long nodeLimit = args.getInt("nodes", GameSolver::DEFAULT_NODE_LIMIT);
+    
+    // 生成的关卡都经过 LevelSolver 校验，每一局都应求解成功
+    std::vector<LevelConfig*> levels;
+    LevelGenerator::generateLevels(params, seed, 0, count, threadCount, levels);
+    std::vector<GameModel*> gameModels;
+    std::vector<const GameModel*> solveInputs;
+    for (auto* level : levels) {
+        GameModel* gameModel = level ? GameModelFromLevelGenerator::generateGameModel(level) : nullptr;
+        gameModels.push_back(gameModel);
+        solveInputs.push_back(gameModel);
+        delete level;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    std::vector<GameSolveResult> results;
+    GameSolver::solveAll(solveInputs, threadCount, results, nodeLimit);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    int mismatches = 0;
+    if (args.has("compare")) {
+        // 单线程逐局求解，统计单局耗时，并确认多线程结果与之完全一致
+        GameSolver solver;
+        std::vector<double> micros;
+        for (size_t i = 0; i < solveInputs.size(); ++i) {
+            GameSolveResult result;
+            auto solveStart = std::chrono::steady_clock::now();
+            solver.solve(solveInputs[i], result, nodeLimit);
+            micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - solveStart).count());
+            bool same = result.status == results[i].status && result.line.size() == results[i].line.size();
+            for (size_t j = 0; same && j < result.line.size(); ++j) {
+                same = result.line[j].cardId == results[i].line[j].cardId;
+            }
+            mismatches += same ? 0 : 1;
+        }
+        std::sort(micros.begin(), micros.end());
+        double total = 0;
+        for (double value : micros) {
+            total += value;
+        }
+        if (!micros.empty()) {
+            size_t timedCount = micros.size();
+            std::printf("Single thread: mean %.1f us, median %.1f us, p99 %.1f us, max %.1f us, speedup %.2fx\n",
+                        total / timedCount, micros[timedCount / 2], micros[timedCount * 99 / 100], micros.back(),
+                        seconds > 0 ? total / 1e6 / seconds : 0.0);
+        }
+    }
+    
+    int solvedCount = 0;
+    int failures = 0;
+    long long totalNodes = 0;
+    long long totalMoves = 0;
+    for (size_t i = 0; i < gameModels.size(); ++i) {
+        totalNodes += results[i].nodes;
+        totalMoves += (long long)results[i].line.size();
+        if (gameModels[i] && results[i].status == GSS_SOLVED && playLine(gameModels[i], results[i].line)) {
+            ++solvedCount;
+        } else {
+            ++failures;
+        }
+        delete gameModels[i];
+    }
+    
+    std::printf("Solved %d/%d %s deals (main %d, reserve %d), %d failures, %d mismatches\n", solvedCount, count,
+                layoutName.c_str(), params.mainCardCount, params.reserveCardCount, failures, mismatches);
+    std::printf("  %.3f s, %.0f deals/s, mean nodes %.1f, mean line length %.1f clicks\n",
+                seconds, seconds > 0 ? count / seconds : 0.0,
+                count > 0 ? (double)totalNodes / count : 0.0, count > 0 ? (double)totalMoves / count : 0.0);
+    return failures == 0 && mismatches == 0 ? 0 : 1;
+}
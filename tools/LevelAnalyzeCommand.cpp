@@ -0,0 +1,315 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include "configs/loaders/LevelConfigLoader.h"
+#include "services/GameSolver.h"
+#include "services/LevelSolver.h"
+#include "utils/CardUtils.h"
+#include "utils/DealRandom.h"
+#include "utils/ParallelUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const float DESIGN_WIDTH = 1080.0f;     ///< 设计分辨率，与 AppDelegate 一致
+const float DESIGN_HEIGHT = 2080.0f;
+
+/**
+ * 单个关卡的分析结果
+ */
+struct LevelReport
+{
+    std::string file;           ///< 关卡文件
+    bool loaded;                ///< 是否通过加载校验（面值、花色、坐标范围）
+    std::string loadError;      ///< 加载失败的位置与原因（"行:列: 原因"）
+    int mainCount;              ///< 主牌堆张数
+    int bottomCount;            ///< 底牌堆张数
+    int reserveCount;           ///< 备用牌堆张数
+    int overlapCount;           ///< 相互重叠的卡牌对数（底牌堆内部除外）
+    int offscreenCount;         ///< 超出设计分辨率的卡牌数
+    bool supported;             ///< 求解器能否表示该关卡
+    bool solvable;              ///< 是否可解
+    int minMoves;               ///< 最少点击次数（含备用牌交换），未知为-1
+    int playouts;               ///< 随机对局次数
+    int wins;                   ///< 随机对局获胜次数
+    double branching;           ///< 平均可选操作数
+    double deadEndRate;         ///< 可解局面下导致无解的操作比例
+    
+    LevelReport()
+        : loaded(false), mainCount(0), bottomCount(0), reserveCount(0), overlapCount(0), offscreenCount(0)
+        , supported(false), solvable(false), minMoves(-1), playouts(0), wins(0), branching(0), deadEndRate(0)
+    {}
+};
+
+/**
+ * 统计卡牌重叠与越界；底牌堆中的牌按设计叠放，内部不计重叠
+ * 主牌堆全部位于模板卡位上时，主牌堆内部的重叠直接取模板预计算的结果
+ */
+void checkGeometry(const LevelConfig* levelConfig, LevelReport& report)
+{
+    struct PlacedCard
+    {
+        cocos2d::Vec2 position;
+        bool bottom;
+    };
+    std::vector<PlacedCard> cards;
+    for (const auto& card : levelConfig->getMainPileCards()) {
+        PlacedCard placed = { card.position, false };
+        cards.push_back(placed);
+    }
+    for (const auto& card : levelConfig->getBottomPileCards()) {
+        PlacedCard placed = { card.position, true };
+        cards.push_back(placed);
+    }
+    for (const auto& card : levelConfig->getReservePileCards()) {
+        PlacedCard placed = { card.position, false };
+        cards.push_back(placed);
+    }
+    
+    size_t templatedCount = 0;
+    if (levelConfig->isFullySlotted()) {
+        uint64_t occupiedSlots = 0;
+        for (const auto& card : levelConfig->getMainPileCards()) {
+            occupiedSlots |= uint64_t(1) << card.slot;
+        }
+        report.overlapCount += levelConfig->getLayout()->countOverlapPairs(occupiedSlots);
+        templatedCount = levelConfig->getMainPileCards().size();
+    }
+    
+    cocos2d::Size cardSize = CardUtils::getCardSize();
+    float halfWidth = cardSize.width * 0.5f;
+    float halfHeight = cardSize.height * 0.5f;
+    for (size_t i = 0; i < cards.size(); ++i) {
+        const cocos2d::Vec2& a = cards[i].position;
+        if (a.x - halfWidth < 0 || a.x + halfWidth > DESIGN_WIDTH ||
+            a.y - halfHeight < 0 || a.y + halfHeight > DESIGN_HEIGHT) {
+            ++report.offscreenCount;
+        }
+        for (size_t j = std::max(i + 1, templatedCount); j < cards.size(); ++j) {
+            if (cards[i].bottom && cards[j].bottom) {
+                continue;
+            }
+            const cocos2d::Vec2& b = cards[j].position;
+            if (std::fabs(a.x - b.x) < cardSize.width && std::fabs(a.y - b.y) < cardSize.height) {
+                ++report.overlapCount;
+            }
+        }
+    }
+}
+
+/**
+ * 按实际点击计算最少步数：接走主牌与交换备用牌各算一步
+ * @param solver 当前线程的求解器
+ * @return 最少步数，无解返回-1
+ */
+int findMinMoves(GameSolver& solver, const LevelSolver::SolverState& initial, int topFace)
+{
+    GameSolver::Position position;
+    for (int face = 0; face < LevelSolver::FACE_COUNT; ++face) {
+        position.mainCounts[face] = initial.mainCounts[face];
+        position.reserveCounts[face] = initial.handCounts[face];
+    }
+    // 求解状态的手牌包含底牌顶部
+    --position.reserveCounts[topFace];
+    position.topFace = (int8_t)topFace;
+    position.mainRemaining = (uint8_t)initial.mainRemaining;
+    
+    GameSolveResult result;
+    return solver.solvePosition(position, result) ? (int)result.line.size() : -1;
+}
+
+/**
+ * 随机对局：每步在所有合法的“手牌接主牌”操作中均匀选择，统计胜率、分支数与致死操作比例
+ */
+void runPlayouts(const LevelSolver::SolverState& initial, int playouts, DealRandom& random, LevelReport& report)
+{
+    long long decisions = 0;
+    long long branchTotal = 0;
+    long long movesFromSolvable = 0;
+    long long deadEndMoves = 0;
+    LevelSolver::SolverMove moves[LevelSolver::FACE_COUNT * 2];
+    
+    for (int playout = 0; playout < playouts; ++playout) {
+        LevelSolver::SolverState state = initial;
+        while (state.mainRemaining > 0) {
+            int moveCount = 0;
+            for (int mainFace = 0; mainFace < LevelSolver::FACE_COUNT; ++mainFace) {
+                if (state.mainCounts[mainFace] == 0) {
+                    continue;
+                }
+                for (int handFace = mainFace - 1; handFace <= mainFace + 1; handFace += 2) {
+                    if (handFace >= 0 && handFace < LevelSolver::FACE_COUNT && state.handCounts[handFace] > 0) {
+                        LevelSolver::SolverMove move = { (int8_t)handFace, (int8_t)mainFace };
+                        moves[moveCount++] = move;
+                    }
+                }
+            }
+            if (moveCount == 0) {
+                break;
+            }
+            
+            ++decisions;
+            branchTotal += moveCount;
+            bool solvable = LevelSolver::isSolvable(state);
+            for (int i = 0; i < moveCount && solvable; ++i) {
+                LevelSolver::SolverState next = state;
+                --next.mainCounts[moves[i].mainFace];
+                --next.mainRemaining;
+                --next.handCounts[moves[i].handFace];
+                ++next.handCounts[moves[i].mainFace];
+                ++movesFromSolvable;
+                deadEndMoves += LevelSolver::isSolvable(next) ? 0 : 1;
+            }
+            
+            const LevelSolver::SolverMove& move = moves[random.nextBounded(moveCount)];
+            --state.mainCounts[move.mainFace];
+            --state.mainRemaining;
+            --state.handCounts[move.handFace];
+            ++state.handCounts[move.mainFace];
+        }
+        report.wins += state.mainRemaining == 0 ? 1 : 0;
+    }
+    
+    report.playouts = playouts;
+    report.branching = decisions > 0 ? (double)branchTotal / decisions : 0.0;
+    report.deadEndRate = movesFromSolvable > 0 ? (double)deadEndMoves / movesFromSolvable : 0.0;
+}
+
+void analyzeLevel(GameSolver& solver, const std::string& file, int playouts, uint64_t seed, uint64_t levelIndex,
+                  LevelReport& report)
+{
+    report.file = file;
+    LevelConfigLoader::LoadError error;
+    LevelConfig* levelConfig = LevelConfigLoader::loadLevelConfigFromFile(file, &error);
+    if (!levelConfig) {
+        char location[32];
+        std::snprintf(location, sizeof(location), "%d:%d: ", error.line, error.column);
+        report.loadError = location + error.message;
+        return;
+    }
+    report.loaded = true;
+    report.mainCount = (int)levelConfig->getMainPileCards().size();
+    report.bottomCount = (int)levelConfig->getBottomPileCards().size();
+    report.reserveCount = (int)levelConfig->getReservePileCards().size();
+    checkGeometry(levelConfig, report);
+    
+    LevelSolver::SolverState state;
+    report.supported = LevelSolver::buildState(levelConfig, state);
+    if (report.supported) {
+        report.solvable = LevelSolver::isSolvable(state);
+        // 主牌堆为空时无需操作；没有底牌时无法确定顶部，不给出最少步数
+        const auto& bottomCards = levelConfig->getBottomPileCards();
+        if (report.solvable && state.mainRemaining == 0) {
+            report.minMoves = 0;
+        } else if (report.solvable && !bottomCards.empty()) {
+            report.minMoves = findMinMoves(solver, state, bottomCards.back().cardFace);
+        }
+        DealRandom random(seed, levelIndex);
+        runPlayouts(state, playouts, random, report);
+    }
+    delete levelConfig;
+}
+
+void printReport(const LevelReport& report, bool csv)
+{
+    char minMoves[16] = "-";
+    if (report.minMoves >= 0) {
+        std::snprintf(minMoves, sizeof(minMoves), "%d", report.minMoves);
+    }
+    const char* status = !report.loaded ? "invalid" : !report.supported ? "unsupported"
+                       : report.solvable ? "solvable" : "unsolvable";
+    double winRate = report.playouts > 0 ? 100.0 * report.wins / report.playouts : 0.0;
+    
+    if (csv) {
+        std::printf("%s,%s,%d,%d,%d,%d,%d,%s,%.2f,%.3f,%.2f,\"%s\"\n", report.file.c_str(), status,
+                    report.mainCount, report.bottomCount, report.reserveCount, report.overlapCount,
+                    report.offscreenCount, minMoves, winRate, report.branching, 100.0 * report.deadEndRate,
+                    report.loadError.c_str());
+    } else {
+        std::printf("%-28s %-11s %4d/%d/%d %8d %9d %9s %7.2f %9.3f %8.2f\n", report.file.c_str(), status,
+                    report.mainCount, report.bottomCount, report.reserveCount, report.overlapCount,
+                    report.offscreenCount, minMoves, winRate, report.branching, 100.0 * report.deadEndRate);
+        if (!report.loadError.empty()) {
+            std::printf("    %s:%s\n", report.file.c_str(), report.loadError.c_str());
+        }
+    }
+}
+
+} // namespace
+
+int runLevelAnalyzeCommand(const CommandArgs& args)
+{
+    std::vector<std::string> files = args.getPositionals();
+    if (args.has("dir")) {
+        listLevelFiles(args.getString("dir", "."), files);
+    }
+    if (files.empty()) {
+        std::printf("Usage: analyze [--dir <directory>] [--layouts <layouts.json>] [--playouts N] [--seed S] [--threads T] "
+                    "[--csv] [file.json ...]\n");
+        return 1;
+    }
+    if (!loadLayoutTemplates(args)) {
+        return 1;
+    }
+    
+    std::sort(files.begin(), files.end(), [](const std::string& a, const std::string& b) {
+        int idA = parseLevelId(a);
+        int idB = parseLevelId(b);
+        return idA != idB ? idA < idB : a < b;
+    });
+    
+    int playouts = (int)args.getInt("playouts", 1000);
+    uint64_t seed = (uint64_t)args.getInt("seed", 1);
+    int threadCount = ParallelUtils::resolveThreadCount((int)args.getInt("threads", 0), (long long)files.size());
+    bool csv = args.has("csv");
+    
+    // 关卡按下标领取，随机对局使用 (种子, 下标) 序列，结果与线程数无关
+    auto start = std::chrono::steady_clock::now();
+    std::vector<LevelReport> reports(files.size());
+    std::vector<GameSolver> solvers(threadCount);
+    ParallelUtils::parallelFor((long long)files.size(), threadCount, [&](int threadIndex, long long index) {
+        analyzeLevel(solvers[threadIndex], files[index], playouts, seed, (uint64_t)index, reports[index]);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    if (csv) {
+        std::printf("file,status,main,bottom,reserve,overlaps,offscreen,min_moves,win_rate,branching,dead_end_rate,error\n");
+    } else {
+        std::printf("%-28s %-11s %10s %8s %9s %9s %7s %9s %8s\n", "level", "status", "cards", "overlaps",
+                    "offscreen", "min-moves", "win%", "branching", "dead-end%");
+    }
+    int failures = 0;
+    for (const auto& report : reports) {
+        printReport(report, csv);
+        failures += report.loaded && report.solvable && report.overlapCount == 0 && report.offscreenCount == 0 ? 0 : 1;
+    }
+    if (!csv) {
+        std::printf("%zu levels analyzed in %.3f s, %d with problems\n", reports.size(), seconds, failures);
+    }
+    return failures == 0 ? 0 : 1;
+}
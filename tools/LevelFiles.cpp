@@ -0,0 +1,85 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include "configs/loaders/LayoutTemplateRegistry.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <dirent.h>
+
+int parseLevelId(const std::string& fileName)
+{
+    size_t slash = fileName.find_last_of("/\\");
+    std::string baseName = slash == std::string::npos ? fileName : fileName.substr(slash + 1);
+    const std::string prefix = "level";
+    const std::string suffix = ".json";
+    if (baseName.size() <= prefix.size() + suffix.size() ||
+        baseName.compare(0, prefix.size(), prefix) != 0 ||
+        baseName.compare(baseName.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        return -1;
+    }
+    
+    std::string digits = baseName.substr(prefix.size(), baseName.size() - prefix.size() - suffix.size());
+    if (digits.size() > 9 || digits.find_first_not_of("0123456789") != std::string::npos) {
+        return -1;
+    }
+    return std::atoi(digits.c_str());
+}
+
+void listLevelFiles(const std::string& directory, std::vector<std::string>& files)
+{
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return;
+    }
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (parseLevelId(name) >= 0) {
+            files.push_back(directory + "/" + name);
+        }
+    }
+    closedir(dir);
+}
+
+bool loadLayoutTemplates(const CommandArgs& args)
+{
+    LayoutTemplateRegistry* registry = LayoutTemplateRegistry::getInstance();
+    registry->loadDefaultTemplates();
+    if (args.has("layouts")) {
+        std::string path = args.getString("layouts", "");
+        if (!registry->loadTemplatesFromFile(path)) {
+            std::printf("Failed to load layout templates from %s\n", path.c_str());
+            return false;
+        }
+        return true;
+    }
+    if (args.has("dir")) {
+        std::string path = args.getString("dir", ".") + "/" + LayoutTemplateRegistry::DEFAULT_FILE_NAME;
+        if (std::ifstream(path.c_str()).good()) {
+            return registry->loadTemplatesFromFile(path);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,304 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include "configs/loaders/LevelConfigLoader.h"
+#include "configs/loaders/LayoutTemplateRegistry.h"
+#include "models/CardModel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+
+namespace {
+
+/**
+ * 内置种子：覆盖全部字段（含布局模板引用），未指定语料时使用
+ */
+const char* const BUILTIN_SEEDS[] = {
+    "{\n"
+    "    \"MainPile\": [\n"
+    "        {\"CardFace\": 12, \"CardSuit\": 0, \"Position\": {\"x\": 250, \"y\": 1000}},\n"
+    "        {\"CardFace\": 2, \"CardSuit\": 3, \"Position\": {\"x\": 300.5, \"y\": -800}}\n"
+    "    ],\n"
+    "    \"BottomPile\": [{\"CardFace\": 1, \"CardSuit\": 1, \"Position\": {\"x\": 540, \"y\": 200}}],\n"
+    "    \"ReservePile\": [{\"CardFace\": 0, \"CardSuit\": 2, \"Position\": {\"x\": 100, \"y\": 200}}],\n"
+    "    \"Extra\": {\"nested\": [1, 2.5, \"text\", true, null]}\n"
+    "}\n",
+    "{\"Layout\": \"fuzz-4\", \"MainPile\": [{\"CardFace\": 3, \"CardSuit\": 0}, {\"CardFace\": 4, \"CardSuit\": 1, \"Slot\": 3},"
+    " {\"CardFace\": 5, \"CardSuit\": 2, \"Position\": {\"x\": 1, \"y\": 2}}], \"BottomPile\": []}",
+};
+
+/**
+ * 内置布局模板，供种子中的 "Layout" 引用
+ */
+const char* const FUZZ_LAYOUTS =
+    "{\"Layouts\": [{\"Id\": \"fuzz-4\", \"Slots\": [{\"x\": 100, \"y\": 900}, {\"x\": 220, \"y\": 900},"
+    " {\"x\": 340, \"y\": 900}, {\"x\": 460, \"y\": 900}]}]}";
+
+/**
+ * 插入用的JSON片段
+ */
+const char* const DICTIONARY[] = {
+    "{", "}", "[", "]", ",", ":", "\"", "null", "true", "false", "-1", "13", "4", "64", "0.5", "-0", "1e400",
+    "99999999999999999999", "100001", "\"CardFace\"", "\"CardSuit\"", "\"Position\"", "\"Slot\"", "\"Layout\"",
+    "\"MainPile\"", "\"BottomPile\"", "\"ReservePile\"", "\"x\"", "\"y\"", "\"fuzz-4\"", "\\u0000", "[[[[[[[[",
+};
+
+const size_t MAX_INPUT_SIZE = 64 * 1024;   ///< 变异后输入长度上限
+const size_t MAX_CORPUS_SIZE = 512;        ///< 语料库容量
+
+/**
+ * 对输入做一次随机变异
+ */
+void mutate(std::string& input, const std::vector<std::string>& corpus, std::mt19937& rng)
+{
+    auto randomIndex = [&rng](size_t size) { return size == 0 ? 0 : (size_t)(rng() % size); };
+    
+    switch (rng() % 7) {
+        case 0:
+            if (!input.empty()) {
+                input[randomIndex(input.size())] ^= (char)(1 << (rng() % 8));
+            }
+            break;
+        case 1: {
+            static const char STRUCTURAL[] = "{}[]:,\"-.0123456789eE \n\\";
+            if (!input.empty()) {
+                input[randomIndex(input.size())] = STRUCTURAL[randomIndex(sizeof(STRUCTURAL) - 1)];
+            }
+            break;
+        }
+        case 2:
+            input.insert(randomIndex(input.size() + 1),
+                         DICTIONARY[randomIndex(sizeof(DICTIONARY) / sizeof(DICTIONARY[0]))]);
+            break;
+        case 3:
+            if (!input.empty()) {
+                size_t begin = randomIndex(input.size());
+                input.erase(begin, 1 + randomIndex(std::min<size_t>(16, input.size() - begin)));
+            }
+            break;
+        case 4:
+            if (!input.empty()) {
+                size_t begin = randomIndex(input.size());
+                std::string chunk = input.substr(begin, 1 + randomIndex(std::min<size_t>(64, input.size() - begin)));
+                input.insert(randomIndex(input.size() + 1), chunk);
+            }
+            break;
+        case 5:
+            input.resize(randomIndex(input.size() + 1));
+            break;
+        default: {
+            const std::string& other = corpus[randomIndex(corpus.size())];
+            size_t cut = randomIndex(input.size() + 1);
+            input = input.substr(0, cut) + other.substr(randomIndex(other.size() + 1));
+            break;
+        }
+    }
+    if (input.size() > MAX_INPUT_SIZE) {
+        input.resize(MAX_INPUT_SIZE);
+    }
+}
+
+/**
+ * 检查加载成功的关卡满足模式约束
+ */
+bool checkLevel(const LevelConfig* config)
+{
+    if (!config->isValid()) {
+        return false;
+    }
+    const std::vector<LevelConfig::CardConfig>* piles[] = {
+        &config->getMainPileCards(), &config->getBottomPileCards(), &config->getReservePileCards()
+    };
+    for (const auto* pile : piles) {
+        for (const auto& card : *pile) {
+            if (card.cardFace < CFT_ACE || card.cardFace > CFT_KING || card.cardSuit < CST_CLUBS ||
+                card.cardSuit > CST_SPADES || !std::isfinite(card.position.x) || !std::isfinite(card.position.y) ||
+                std::fabs(card.position.x) > 100000 || std::fabs(card.position.y) > 100000) {
+                return false;
+            }
+            if (card.slot >= 0 && (pile != piles[0] || !config->getLayout() ||
+                                   card.position != config->getLayout()->getSlotPosition(card.slot))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * 加载一份输入并检查结果：成功时满足模式约束，失败时给出原因和有效位置，两次加载结果一致
+ * 输入复制到恰好等长的缓冲区，越界读取可被 AddressSanitizer 发现
+ * @param data 输入数据
+ * @param size 输入长度
+ * @param accepted 输出是否加载成功
+ * @param message 输出失败原因
+ * @return 检查是否通过
+ */
+bool checkInput(const char* data, size_t size, bool& accepted, std::string& message)
+{
+    std::vector<char> buffer(data, data + size);
+    const char* bytes = buffer.empty() ? nullptr : buffer.data();
+    
+    LevelConfigLoader::LoadError error;
+    LevelConfig* config = LevelConfigLoader::loadLevelConfigFromMemory(bytes, size, &error);
+    accepted = config != nullptr;
+    message = error.message;
+    
+    bool passed = config ? checkLevel(config) && error.message.empty()
+                         : !error.message.empty() && error.offset <= size && error.line >= 1 && error.column >= 1;
+    delete config;
+    
+    LevelConfigLoader::LoadError again;
+    LevelConfig* reloaded = LevelConfigLoader::loadLevelConfigFromMemory(bytes, size, &again);
+    passed = passed && (reloaded != nullptr) == accepted && again.message == error.message && again.offset == error.offset;
+    delete reloaded;
+    return passed;
+}
+
+/**
+ * 首次使用时注册内置布局模板
+ */
+void registerFuzzLayouts()
+{
+    static bool registered = LayoutTemplateRegistry::getInstance()->loadTemplatesFromMemory(
+        FUZZ_LAYOUTS, std::strlen(FUZZ_LAYOUTS));
+    (void)registered;
+}
+
+} // namespace
+
+#if defined(LEVEL_CONFIG_LIBFUZZER)
+/**
+ * libFuzzer 入口：以 -DLEVEL_CONFIG_LIBFUZZER -fsanitize=fuzzer,address 编译 tools（不含 main.cpp）与 Classes 源码
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    registerFuzzLayouts();
+    bool accepted = false;
+    std::string message;
+    if (!checkInput(reinterpret_cast<const char*>(data), size, accepted, message)) {
+        std::abort();
+    }
+    return 0;
+}
+#endif
+
+int runLevelFuzzCommand(const CommandArgs& args)
+{
+    unsigned int seed = (unsigned int)args.getInt("seed", 1);
+    long long iterations = args.getInt("iterations", 200000);
+    std::string saveDir = args.getString("save", "");
+    bool verbose = args.has("verbose");
+    registerFuzzLayouts();
+    
+    std::vector<std::string> files = args.getPositionals();
+    if (args.has("dir")) {
+        listLevelFiles(args.getString("dir", "."), files);
+    }
+    std::vector<std::string> corpus;
+    for (const auto& file : files) {
+        std::ifstream input(file.c_str(), std::ios::binary);
+        std::stringstream content;
+        content << input.rdbuf();
+        if (!input) {
+            std::printf("Failed to read %s\n", file.c_str());
+            return 1;
+        }
+        corpus.push_back(content.str());
+    }
+    for (const char* builtin : BUILTIN_SEEDS) {
+        corpus.push_back(builtin);
+    }
+    
+    // 种子本身必须通过检查
+    long long failureCount = 0;
+    for (const auto& input : corpus) {
+        bool accepted = false;
+        std::string message;
+        if (!checkInput(input.data(), input.size(), accepted, message)) {
+            std::printf("FAIL seed input does not pass the checks\n");
+            ++failureCount;
+        }
+    }
+    
+    std::mt19937 rng(seed);
+    std::map<std::string, long long> errorCounts;
+    long long acceptedCount = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    
+    for (long long i = 0; i < iterations; ++i) {
+        std::string input = corpus[rng() % corpus.size()];
+        int mutations = 1 + (int)(rng() % 4);
+        for (int m = 0; m < mutations; ++m) {
+            mutate(input, corpus, rng);
+        }
+        
+        bool accepted = false;
+        std::string message;
+        if (!checkInput(input.data(), input.size(), accepted, message)) {
+            if (failureCount < 10) {
+                std::printf("FAIL iteration=%lld size=%zu\n", i, input.size());
+            }
+            if (!saveDir.empty()) {
+                char path[64];
+                std::snprintf(path, sizeof(path), "/fuzz-level-%lld.json", i);
+                std::ofstream output((saveDir + path).c_str(), std::ios::binary);
+                output.write(input.data(), input.size());
+            }
+            ++failureCount;
+        }
+        
+        if (accepted) {
+            // 变异后仍有效的输入加入语料，后续变异从更多样的合法结构出发
+            ++acceptedCount;
+            if (corpus.size() < MAX_CORPUS_SIZE) {
+                corpus.push_back(input);
+            } else {
+                corpus[rng() % corpus.size()] = input;
+            }
+        } else {
+            ++errorCounts[message];
+        }
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::printf("inputs=%lld accepted=%lld rejected=%lld distinct_errors=%zu failures=%lld time=%.3fs (%.0f inputs/s)\n",
+                iterations, acceptedCount, iterations - acceptedCount, errorCounts.size(), failureCount, seconds,
+                seconds > 0 ? iterations / seconds : 0.0);
+    if (verbose) {
+        for (const auto& entry : errorCounts) {
+            std::printf("%10lld  %s\n", entry.second, entry.first.c_str());
+        }
+    }
+    
+    return failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include "services/LevelGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+/**
+ * 写出一个牌堆的 JSON 数组，格式与 Resources/levelN.json 一致
+ */
+void writePileJson(std::ofstream& output, const char* name,
+                   const std::vector<LevelConfig::CardConfig>& cards, bool last)
+{
+    output << "    \"" << name << "\": [";
+    for (size_t i = 0; i < cards.size(); ++i) {
+        char buffer[160];
+        std::snprintf(buffer, sizeof(buffer),
+                      "%s\n        {\n            \"CardFace\": %d,\n            \"CardSuit\": %d,\n"
+                      "            \"Position\": {\"x\": %g, \"y\": %g}\n        }",
+                      i == 0 ? "" : ",", cards[i].cardFace, cards[i].cardSuit,
+                      cards[i].position.x, cards[i].position.y);
+        output << buffer;
+    }
+    output << (cards.empty() ? "]" : "\n    ]") << (last ? "\n" : ",\n");
+}
+
+/**
+ * 将关卡配置写为 levelN.json
+ * @return 是否写入成功
+ */
+bool writeLevelJson(const std::string& path, const LevelConfig* levelConfig)
+{
+    std::ofstream output(path.c_str());
+    output << "{\n";
+    writePileJson(output, "MainPile", levelConfig->getMainPileCards(), false);
+    writePileJson(output, "BottomPile", levelConfig->getBottomPileCards(), false);
+    writePileJson(output, "ReservePile", levelConfig->getReservePileCards(), true);
+    output << "}\n";
+    return output.good();
+}
+
+} // namespace
+
+int runLevelGenerateCommand(const CommandArgs& args)
+{
+    LevelGenerateParams params;
+    std::string layoutName = args.getString("layout", LevelGenerator::getLayoutName(params.layout));
+    if (!LevelGenerator::parseLayoutName(layoutName, params.layout)) {
+        std::printf("Unknown layout: %s (expected peaks, pyramid or grid)\n", layoutName.c_str());
+        return 1;
+    }
+    params.mainCardCount = (int)args.getInt("main", params.mainCardCount);
+    params.reserveCardCount = (int)args.getInt("reserve", params.reserveCardCount);
+    params.deckCount = (int)args.getInt("decks", params.deckCount);
+    params.maxAttempts = (int)args.getInt("attempts", params.maxAttempts);
+    if (!LevelGenerator::isValidParams(params)) {
+        std::printf("Usage: generate [--count N] [--seed S] [--first-deal K] [--threads T]\n"
+                    "                [--layout peaks|pyramid|grid] [--main N] [--reserve N] [--decks N] [--attempts N]\n"
+                    "                [--out-dir <directory> [--first-id N]]\n"
+                    "Limits: main <= %d (and layout capacity), reserve <= %d, decks <= %d\n",
+                    LevelGenerator::MAX_MAIN_CARDS, LevelGenerator::MAX_RESERVE_CARDS, LevelGenerator::MAX_DECK_COUNT);
+        return 1;
+    }
+    
+    int count = (int)args.getInt("count", 1000);
+    uint64_t seed = (uint64_t)args.getInt("seed", 1);
+    uint64_t firstDeal = (uint64_t)args.getInt("first-deal", 0);
+    int threadCount = (int)args.getInt("threads", 0);
+    
+    auto start = std::chrono::steady_clock::now();
+    std::vector<LevelConfig*> levels;
+    long long attempts = LevelGenerator::generateLevels(params, seed, firstDeal, count, threadCount, levels);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    int generated = 0;
+    for (auto* level : levels) {
+        generated += level ? 1 : 0;
+    }
+    std::printf("Generated %d/%d %s levels (main %d, reserve %d) in %.3f s\n",
+                generated, count, layoutName.c_str(), params.mainCardCount, params.reserveCardCount, seconds);
+    std::printf("  %lld candidates, %.1f%% solvable, %.0f candidates/s, %.0f levels/s\n",
+                attempts, attempts > 0 ? 100.0 * generated / attempts : 0.0,
+                seconds > 0 ? attempts / seconds : 0.0, seconds > 0 ? generated / seconds : 0.0);
+    
+    bool written = true;
+    if (args.has("out-dir")) {
+        std::string directory = args.getString("out-dir", ".");
+        int firstId = (int)args.getInt("first-id", 1);
+        for (size_t i = 0; i < levels.size() && written; ++i) {
+            if (!levels[i]) {
+                continue;
+            }
+            char fileName[32];
+            std::snprintf(fileName, sizeof(fileName), "/level%d.json", firstId + (int)i);
+            written = writeLevelJson(directory + fileName, levels[i]);
+        }
+        std::printf(written ? "Wrote levels to %s\n" : "Failed to write levels to %s\n", directory.c_str());
+    }
+    
+    for (auto* level : levels) {
+        delete level;
+    }
+    return written && generated == count ? 0 : 1;
+}
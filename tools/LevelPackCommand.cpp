@@ -0,0 +1,141 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include "configs/loaders/LevelConfigLoader.h"
+#include "configs/loaders/LevelPackLoader.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+/**
+ * 比较两份关卡配置的卡牌列表
+ */
+bool sameCards(const std::vector<LevelConfig::CardConfig>& a, const std::vector<LevelConfig::CardConfig>& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].cardFace != b[i].cardFace || a[i].cardSuit != b[i].cardSuit || a[i].position != b[i].position) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int runLevelPackCommand(const CommandArgs& args)
+{
+    std::string outputPath = args.getString("out", "levels.pack");
+    std::vector<std::string> files = args.getPositionals();
+    if (args.has("dir")) {
+        listLevelFiles(args.getString("dir", "."), files);
+    }
+    if (files.empty()) {
+        std::printf("Usage: pack --out <file> [--dir <directory>] [--layouts <layouts.json>] [levelN.json ...]\n");
+        return 1;
+    }
+    if (!loadLayoutTemplates(args)) {
+        return 1;
+    }
+    
+    // 按关卡ID排序并解析
+    std::vector<std::pair<int, const LevelConfig*>> levels;
+    for (const auto& file : files) {
+        int levelId = parseLevelId(file);
+        if (levelId < 0) {
+            std::printf("Skipping %s: file name is not levelN.json\n", file.c_str());
+            continue;
+        }
+        LevelConfig* config = LevelConfigLoader::loadLevelConfigFromFile(file);
+        if (!config) {
+            std::printf("Failed to load %s\n", file.c_str());
+            for (auto& level : levels) {
+                delete level.second;
+            }
+            return 1;
+        }
+        levels.push_back(std::make_pair(levelId, config));
+    }
+    std::sort(levels.begin(), levels.end(),
+              [](const std::pair<int, const LevelConfig*>& a, const std::pair<int, const LevelConfig*>& b) {
+                  return a.first < b.first;
+              });
+    
+    std::string pack;
+    bool built = LevelPackLoader::buildPack(levels, pack);
+    if (built) {
+        std::ofstream output(outputPath.c_str(), std::ios::binary);
+        output.write(pack.data(), pack.size());
+        built = output.good();
+    }
+    
+    // 重新打开写出的包，逐关与JSON解析结果比对
+    int mismatches = 0;
+    int layoutCount = 0;
+    if (built) {
+        LevelPackLoader loader;
+        built = loader.open(outputPath);
+        layoutCount = loader.getLayoutCount();
+        for (size_t i = 0; built && i < levels.size(); ++i) {
+            LevelConfig* packed = loader.loadLevelConfig(levels[i].first);
+            const LevelConfig* source = levels[i].second;
+            if (!packed ||
+                !sameCards(packed->getMainPileCards(), source->getMainPileCards()) ||
+                !sameCards(packed->getBottomPileCards(), source->getBottomPileCards()) ||
+                !sameCards(packed->getReservePileCards(), source->getReservePileCards())) {
+                std::printf("Level %d does not round-trip\n", levels[i].first);
+                ++mismatches;
+            }
+            delete packed;
+        }
+    }
+    
+    // 不共用布局模板时（每张卡牌都带坐标）的大小，用于对比
+    size_t flatSize = sizeof(LevelPackHeader);
+    if (!levels.empty()) {
+        flatSize += (levels.back().first - levels.front().first + 1) * sizeof(LevelPackIndexEntry);
+    }
+    for (const auto& level : levels) {
+        flatSize += (level.second->getMainPileCards().size() + level.second->getBottomPileCards().size() +
+                     level.second->getReservePileCards().size()) * sizeof(LevelPackCardRecord);
+    }
+    
+    for (auto& level : levels) {
+        delete level.second;
+    }
+    
+    if (!built || mismatches > 0) {
+        std::printf("Failed to build %s\n", outputPath.c_str());
+        return 1;
+    }
+    std::printf("Wrote %s: %zu levels, %d layouts, %zu bytes (%zu bytes without shared layouts, %.1f%% smaller)\n",
+                outputPath.c_str(), levels.size(), layoutCount, pack.size(), flatSize,
+                flatSize > 0 ? 100.0 * ((double)flatSize - (double)pack.size()) / (double)flatSize : 0.0);
+    return 0;
+}
@@ -0,0 +1,374 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "Commands.h"
+#include "controllers/GameSession.h"
+#include "services/GameModelFromLevelGenerator.h"
+#include "services/LevelGenerator.h"
+#include "services/MoveGenerator.h"
+#include "utils/CardUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+const int MAX_SUITE_DEPTH = 8;  ///< 测试集每个局面最多记录的深度
+const char* FACE_NAMES[CFT_NUM_CARD_FACE_TYPES] = { "A", "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K" };
+
+/**
+ * 测试集局面：手写局面给出各牌堆的面值；main 为nullptr时为生成的对局
+ */
+struct PerftPosition
+{
+    const char* name;               ///< 名称
+    const char* main;               ///< 主牌堆面值，空格分隔，"*"后缀表示未翻开
+    const char* top;                ///< 底牌顶部面值，空串表示无顶部卡牌
+    const char* reserve;            ///< 备用牌堆面值
+    LevelLayoutType layout;         ///< 生成对局的布局
+    int mainCount;                  ///< 生成对局的主牌堆张数
+    int reserveCount;               ///< 生成对局的备用牌堆张数
+    int deckCount;                  ///< 生成对局的牌副数
+    uint64_t seed;                  ///< 生成对局的种子
+    uint64_t dealIndex;             ///< 生成对局的牌局编号
+    int depth;                      ///< 检查到的最大深度
+    uint64_t expected[MAX_SUITE_DEPTH]; ///< 深度 1..depth 的叶子数
+};
+
+const PerftPosition SUITE[] = {
+    { "no-top", "5 7", "", "K", LLT_PEAKS, 0, 0, 0, 0, 0, 1, { 0 } },
+    { "chain", "A 2 3 4 5", "6", "", LLT_PEAKS, 0, 0, 0, 0, 0, 6, { 1, 1, 1, 1, 1, 0 } },
+    { "face-down", "4 4* 6", "5", "", LLT_PEAKS, 0, 0, 0, 0, 0, 2, { 2, 0 } },
+    { "swap-only", "K", "A", "J Q", LLT_PEAKS, 0, 0, 0, 0, 0, 8, { 2, 5, 11, 25, 55, 121, 263, 569 } },
+    { "peaks-40-3", nullptr, nullptr, nullptr, LLT_PEAKS, 40, 3, 1, 1, 0, 8, { 8, 61, 489, 3817, 30154, 232139, 1770013, 13266761 } },
+    { "pyramid-28-1", nullptr, nullptr, nullptr, LLT_PYRAMID, 28, 1, 1, 7, 3, 8,
+      { 5, 18, 84, 397, 1949, 9502, 44368, 200085 } },
+    { "grid-48-4-2", nullptr, nullptr, nullptr, LLT_GRID, 48, 4, 2, 42, 17, 7, { 8, 87, 836, 8392, 80474, 777838, 7371558 } },
+};
+
+/**
+ * 按面值名称解析
+ * @return 面值，无法识别返回 CFT_NONE
+ */
+CardFaceType parseFace(const std::string& text)
+{
+    for (int face = 0; face < CFT_NUM_CARD_FACE_TYPES; ++face) {
+        if (text == FACE_NAMES[face]) {
+            return (CardFaceType)face;
+        }
+    }
+    return CFT_NONE;
+}
+
+/**
+ * 把面值列表加入牌堆
+ * @return 全部面值都能识别
+ */
+bool addCards(GameModel* gameModel, const char* faces, int pile)
+{
+    std::istringstream input(faces);
+    std::string token;
+    while (input >> token) {
+        bool faceDown = token.back() == '*';
+        CardFaceType face = parseFace(faceDown ? token.substr(0, token.size() - 1) : token);
+        if (face == CFT_NONE) {
+            return false;
+        }
+        CardModel* card = new CardModel(face, CST_SPADES, CoreVec2());
+        card->setRevealed(!faceDown);
+        card->setClickable(!faceDown);
+        if (pile == 0) {
+            gameModel->addMainPileCard(card);
+        } else if (pile == 1) {
+            gameModel->addBottomPileCard(card);
+        } else {
+            gameModel->addReservePileCard(card);
+        }
+    }
+    return true;
+}
+
+/**
+ * 构建测试集局面的游戏模型
+ * @return 游戏模型（调用方释放），失败返回nullptr
+ */
+GameModel* buildPosition(const PerftPosition& position)
+{
+    if (!position.main) {
+        LevelGenerateParams params;
+        params.layout = position.layout;
+        params.mainCardCount = position.mainCount;
+        params.reserveCardCount = position.reserveCount;
+        params.deckCount = position.deckCount;
+        LevelConfig* level = LevelGenerator::generateLevel(params, position.seed, position.dealIndex);
+        GameModel* gameModel = level ? GameModelFromLevelGenerator::generateSeededGameModel(level, position.seed,
+                                                                                            position.dealIndex) : nullptr;
+        delete level;
+        return gameModel;
+    }
+    
+    GameModel* gameModel = new GameModel();
+    if (!addCards(gameModel, position.main, 0) || !addCards(gameModel, position.top, 1) ||
+        !addCards(gameModel, position.reserve, 2)) {
+        delete gameModel;
+        return nullptr;
+    }
+    return gameModel;
+}
+
+/**
+ * 参照实现的可点击卡牌：按 TestScene 原有的判断（CardUtils）列出，不经 MoveGenerator
+ * @param cardIds 输出卡牌ID（先主牌、后备用牌），无底牌顶部时为空
+ */
+void referenceClicks(const GameModel* gameModel, std::vector<int>& cardIds)
+{
+    cardIds.clear();
+    const CardModel* topCard = gameModel->getBottomPileTopCard();
+    if (!topCard) {
+        return;
+    }
+    for (const auto* card : gameModel->getMainPileCards()) {
+        if (CardUtils::canMatchWithBottomPile(card, topCard)) {
+            cardIds.push_back(card->getCardId());
+        }
+    }
+    for (const auto* card : gameModel->getReservePileCards()) {
+        cardIds.push_back(card->getCardId());
+    }
+}
+
+/**
+ * 参照实现：按 referenceClicks 枚举点击，经 GameSession 修改模型并用状态快照撤销
+ * GameSession 仍由 MoveGenerator 判断点击是否合法，参照允许而被拒绝的点击计入 rejected，
+ * 因此生成器漏掉的走法表现为不一致，而不会让两边的叶子数一起变少
+ * @param rejected 累加被拒绝的点击数
+ */
+uint64_t referencePerft(GameSession& session, int depth, uint64_t& rejected)
+{
+    if (depth <= 0) {
+        return 1;
+    }
+    std::vector<int> cardIds;
+    referenceClicks(session.getGameModel(), cardIds);
+    
+    uint64_t nodes = 0;
+    for (int cardId : cardIds) {
+        if (!session.handleCardClick(cardId)) {
+            ++rejected;
+            continue;
+        }
+        nodes += referencePerft(session, depth - 1, rejected);
+        session.handleUndo();
+    }
+    return nodes;
+}
+
+/**
+ * 输出参照实现的比对结果
+ * @return 是否一致
+ */
+bool printReference(uint64_t nodes, uint64_t expected, uint64_t rejected)
+{
+    if (expected == nodes && rejected == 0) {
+        std::printf("  ok");
+        return true;
+    }
+    std::printf("  MISMATCH (reference %llu", (unsigned long long)expected);
+    if (rejected > 0) {
+        std::printf(", %llu clicks rejected", (unsigned long long)rejected);
+    }
+    std::printf(")");
+    return false;
+}
+
+/**
+ * 计时统计叶子数
+ * @param seconds 输出耗时
+ */
+uint64_t timedPerft(MoveGenerator::Board& board, int depth, double& seconds)
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = MoveGenerator::perft(board, depth);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return nodes;
+}
+
+/**
+ * 运行测试集
+ * @return 全部一致返回0
+ */
+int runSuite(bool reference)
+{
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+    for (const auto& position : SUITE) {
+        GameModel* gameModel = buildPosition(position);
+        MoveGenerator::Board board;
+        GameSession session;
+        if (!gameModel || !MoveGenerator::buildBoard(gameModel, board) || !session.start(gameModel)) {
+            std::printf("%-14s failed to build position\n", position.name);
+            delete gameModel;
+            ++failures;
+            continue;
+        }
+        for (int depth = 1; depth <= position.depth; ++depth) {
+            double seconds = 0;
+            uint64_t nodes = timedPerft(board, depth, seconds);
+            totalNodes += nodes;
+            totalSeconds += seconds;
+            uint64_t rejected = 0;
+            uint64_t expected = reference ? referencePerft(session, depth, rejected) : position.expected[depth - 1];
+            bool referenceOk = nodes == expected && rejected == 0;
+            bool ok = referenceOk && nodes == position.expected[depth - 1];
+            failures += ok ? 0 : 1;
+            std::printf("%-14s depth %d %12llu", position.name, depth, (unsigned long long)nodes);
+            if (ok) {
+                std::printf("  ok\n");
+            } else {
+                std::printf("  MISMATCH (expected %llu%s)\n", (unsigned long long)position.expected[depth - 1],
+                            referenceOk ? "" : ", reference differs");
+            }
+        }
+        delete gameModel;
+    }
+    std::printf("%d mismatches, %llu nodes in %.3f s, %.1f Mnodes/s\n", failures, (unsigned long long)totalNodes,
+                totalSeconds, totalSeconds > 0 ? totalNodes / totalSeconds / 1e6 : 0.0);
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int runPerftCommand(const CommandArgs& args)
+{
+    bool reference = args.has("reference");
+#if defined(POKERGAME_CORE_HEADLESS)
+    // 参照实现每步都经 GameSession 保存快照并输出日志
+    coreLogEnabled() = false;
+#endif
+    if (args.has("suite")) {
+        return runSuite(reference);
+    }
+    
+    LevelGenerateParams params;
+    params.mainCardCount = 40;
+    std::string layoutName = args.getString("layout", LevelGenerator::getLayoutName(params.layout));
+    if (!LevelGenerator::parseLayoutName(layoutName, params.layout)) {
+        std::printf("Unknown layout: %s (expected peaks, pyramid or grid)\n", layoutName.c_str());
+        return 1;
+    }
+    params.mainCardCount = (int)args.getInt("main", params.mainCardCount);
+    params.reserveCardCount = (int)args.getInt("reserve", params.reserveCardCount);
+    params.deckCount = (int)args.getInt("decks", params.deckCount);
+    int maxDepth = (int)args.getInt("depth", 6);
+    if (!LevelGenerator::isValidParams(params) || maxDepth < 1) {
+        std::printf("Usage: perft --suite [--reference]\n"
+                    "       perft [--depth N] [--divide] [--reference] [--seed S] [--deal K]\n"
+                    "             [--layout peaks|pyramid|grid] [--main N] [--reserve N] [--decks N]\n");
+        return 1;
+    }
+    
+    PerftPosition position = { "deal", nullptr, nullptr, nullptr, params.layout, params.mainCardCount,
+                               params.reserveCardCount, params.deckCount, (uint64_t)args.getInt("seed", 1),
+                               (uint64_t)args.getInt("deal", 0), 0, { 0 } };
+    GameModel* gameModel = buildPosition(position);
+    MoveGenerator::Board board;
+    GameSession session;
+    if (!gameModel || !MoveGenerator::buildBoard(gameModel, board) || !session.start(gameModel)) {
+        std::printf("Failed to generate the deal\n");
+        delete gameModel;
+        return 1;
+    }
+    
+    int mismatches = 0;
+    if (args.has("divide")) {
+        // 按第一步拆分，便于与参照实现逐个比对；两边的第一步列表也互相比对，找出只有一边有的走法
+        MoveGenerator::MoveList moves;
+        MoveGenerator::generateMoves(board, moves);
+        std::vector<int> referenceIds;
+        if (reference) {
+            referenceClicks(gameModel, referenceIds);
+        }
+        uint64_t total = 0;
+        for (int i = 0; i < moves.count; ++i) {
+            GameMove move = MoveGenerator::toGameMove(board, moves.moves[i]);
+            MoveGenerator::applyMove(board, moves.moves[i]);
+            uint64_t nodes = MoveGenerator::perft(board, maxDepth - 1);
+            MoveGenerator::unapplyMove(board, moves.moves[i]);
+            total += nodes;
+            std::printf("%-7s %-2s #%-5d %12llu", move.type == GMT_MAIN_TO_BOTTOM ? "main" : "reserve",
+                        move.face >= 0 ? FACE_NAMES[move.face] : "?", move.cardId, (unsigned long long)nodes);
+            if (reference) {
+                auto found = std::find(referenceIds.begin(), referenceIds.end(), move.cardId);
+                if (found == referenceIds.end()) {
+                    ++mismatches;
+                    std::printf("  MISMATCH (not a reference click)");
+                } else {
+                    referenceIds.erase(found);
+                    uint64_t expected = 0;
+                    uint64_t rejected = 0;
+                    if (session.handleCardClick(move.cardId)) {
+                        expected = referencePerft(session, maxDepth - 1, rejected);
+                        session.handleUndo();
+                    } else {
+                        ++rejected;
+                    }
+                    mismatches += printReference(nodes, expected, rejected) ? 0 : 1;
+                }
+            }
+            std::printf("\n");
+        }
+        // 剩下的是参照实现允许而生成器没有给出的第一步
+        for (int cardId : referenceIds) {
+            const CardModel* card = gameModel->findMainPileCard(cardId);
+            bool isMain = card != nullptr;
+            if (!isMain) {
+                card = gameModel->findReservePileCard(cardId);
+            }
+            int face = card ? card->getFace() : CFT_NONE;
+            ++mismatches;
+            std::printf("%-7s %-2s #%-5d %12s  MISMATCH (missing from generator)\n", isMain ? "main" : "reserve",
+                        face >= 0 ? FACE_NAMES[face] : "?", cardId, "-");
+        }
+        std::printf("%d moves, %llu nodes at depth %d\n", moves.count, (unsigned long long)total, maxDepth);
+    } else {
+        for (int depth = 1; depth <= maxDepth; ++depth) {
+            double seconds = 0;
+            uint64_t nodes = timedPerft(board, depth, seconds);
+            std::printf("depth %2d %14llu  %.3f s  %.1f Mnodes/s", depth, (unsigned long long)nodes, seconds,
+                        seconds > 0 ? nodes / seconds / 1e6 : 0.0);
+            if (reference) {
+                uint64_t rejected = 0;
+                uint64_t expected = referencePerft(session, depth, rejected);
+                mismatches += printReference(nodes, expected, rejected) ? 0 : 1;
+            }
+            std::printf("\n");
+        }
+    }
+    delete gameModel;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include "models/GameModel.h"
+#include "models/UndoModel.h"
+#include "services/UndoService.h"
+#include "managers/GameStateManager.h"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+/**
+ * 构建基准测试用的对局：主牌堆20张，底牌堆与备用牌堆各3张
+ * @param gameModel 游戏模型
+ */
+void setupBenchModel(GameModel& gameModel)
+{
+    for (int i = 0; i < 20; ++i) {
+        gameModel.addMainPileCard(new CardModel((CardFaceType)(i % 13), (CardSuitType)(i % 4),
+                                                CoreVec2((float)i, (float)i)));
+    }
+    for (int i = 0; i < 3; ++i) {
+        gameModel.addBottomPileCard(new CardModel((CardFaceType)i, CST_CLUBS, CoreVec2()));
+        gameModel.addReservePileCard(new CardModel((CardFaceType)i, CST_HEARTS, CoreVec2()));
+    }
+}
+
+/**
+ * 计算自某时刻起经过的秒数
+ * @param start 起始时刻
+ * @return 秒数
+ */
+double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int runUndoBenchCommand(const CommandArgs& args)
+{
+    const long long recordIterations = args.getInt("records", 2000000);
+    const long long snapshotIterations = args.getInt("snapshots", 200000);
+
+#if defined(POKERGAME_CORE_HEADLESS)
+    // 每次保存状态快照都会输出日志，计时期间关闭
+    coreLogEnabled() = false;
+#endif
+
+    GameModel gameModel;
+    setupBenchModel(gameModel);
+    int mainCardId = gameModel.getMainPileCards()[0]->getCardId();
+    int bottomCardId = gameModel.getBottomPileTopCard()->getCardId();
+    
+    // 撤销记录：创建并写入记录池，每512条清空一次，模拟一局内的操作量
+    UndoModel undoModel;
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < recordIterations; ++i) {
+        if (i % 512 == 0) {
+            undoModel.clearAllRecords();
+        }
+        undoModel.addUndoRecord(UndoService::createPlayfieldToHandRecord(&gameModel, mainCardId, bottomCardId));
+    }
+    double recordSeconds = secondsSince(start);
+    
+    // 状态快照：连续保存，超过容量后覆盖最早的快照
+    GameStateManager stateManager;
+    start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < snapshotIterations; ++i) {
+        stateManager.saveState(&gameModel, GAT_MAIN_TO_BOTTOM, mainCardId, bottomCardId);
+    }
+    double snapshotSeconds = secondsSince(start);
+    
+    std::printf("undo records: %.0f/s (%lld in %.3fs, %zu bytes each)\n",
+                recordIterations / recordSeconds, recordIterations, recordSeconds, sizeof(UndoModel::UndoRecord));
+    std::printf("snapshots:    %.0f/s (%lld in %.3fs, %zu bytes each)\n",
+                snapshotIterations / snapshotSeconds, snapshotIterations, snapshotSeconds,
+                sizeof(GameStateManager::GameStateSnapshot));
+    return 0;
+}
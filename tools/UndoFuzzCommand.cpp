@@ -0,0 +1,175 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include "models/GameModel.h"
+#include "configs/models/LevelConfig.h"
+#include "services/GameModelFromLevelGenerator.h"
+#include "managers/UndoManager.h"
+#include "controllers/PlayFieldController.h"
+#include "controllers/StackController.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+/**
+ * 生成随机对局配置
+ * @param rng 随机数发生器
+ * @return 关卡配置
+ */
+LevelConfig* createRandomDeal(std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> faceDist(CFT_ACE, CFT_KING);
+    std::uniform_int_distribution<int> suitDist(CST_CLUBS, CST_SPADES);
+    std::uniform_int_distribution<int> mainCountDist(1, 24);
+    std::uniform_int_distribution<int> bottomCountDist(1, 4);
+    
+    LevelConfig* config = new LevelConfig();
+    
+    int mainCount = mainCountDist(rng);
+    for (int i = 0; i < mainCount; ++i) {
+        config->addMainPileCard(LevelConfig::CardConfig(faceDist(rng), suitDist(rng),
+            CoreVec2(100.0f + (i % 8) * 120.0f, 1000.0f - (i / 8) * 150.0f)));
+    }
+    
+    int bottomCount = bottomCountDist(rng);
+    for (int i = 0; i < bottomCount; ++i) {
+        config->addBottomPileCard(LevelConfig::CardConfig(faceDist(rng), suitDist(rng),
+            CoreVec2(540.0f + i * 60.0f, 200.0f)));
+    }
+    
+    return config;
+}
+
+/**
+ * 在一个随机对局上执行随机合法操作，然后撤销全部操作并校验状态
+ * @param seed 随机种子
+ * @param maxMoves 最大操作数
+ * @param movesPlayed 输出实际执行的操作数
+ * @return 撤销后每一步的状态哈希是否都与操作前一致
+ */
+bool verifySequence(unsigned int seed, int maxMoves, int& movesPlayed)
+{
+    std::mt19937 rng(seed);
+    
+    LevelConfig* config = createRandomDeal(rng);
+    GameModel* gameModel = GameModelFromLevelGenerator::generateGameModel(config);
+    delete config;
+    if (!gameModel) {
+        movesPlayed = 0;
+        return false;
+    }
+    
+    UndoManager undoManager;
+    undoManager.init(gameModel);
+    PlayFieldController playFieldController;
+    playFieldController.init(gameModel, &undoManager);
+    StackController stackController;
+    stackController.init(gameModel, &undoManager);
+    
+    // hashes[i] 为第 i 步操作之前的状态
+    std::vector<uint64_t> hashes;
+    hashes.reserve(maxMoves + 1);
+    hashes.push_back(gameModel->computeStateHash());
+    
+    std::vector<int> candidates;
+    for (int move = 0; move < maxMoves; ++move) {
+        candidates.clear();
+        for (const auto* card : gameModel->getMainPileCards()) {
+            candidates.push_back(card->getCardId());
+        }
+        for (const auto* card : gameModel->getBottomPileCards()) {
+            candidates.push_back(card->getCardId());
+        }
+        std::shuffle(candidates.begin(), candidates.end(), rng);
+        
+        // 按随机顺序尝试，第一个被控制器接受的操作即为本步的随机合法操作
+        bool moved = false;
+        for (int cardId : candidates) {
+            if (gameModel->findMainPileCard(cardId)) {
+                moved = playFieldController.handleCardClick(cardId);
+            } else {
+                moved = stackController.handleCardClick(cardId);
+            }
+            if (moved) {
+                break;
+            }
+        }
+        if (!moved) {
+            break;
+        }
+        hashes.push_back(gameModel->computeStateHash());
+    }
+    movesPlayed = (int)hashes.size() - 1;
+    
+    bool success = true;
+    if (movesPlayed > 0 && (rng() & 1)) {
+        // 一次性撤销到初始状态
+        success = undoManager.undoTo(0) && gameModel->computeStateHash() == hashes[0];
+    } else {
+        // 逐步撤销，每一步都校验
+        for (int i = movesPlayed; i > 0 && success; --i) {
+            success = undoManager.executeUndo() && gameModel->computeStateHash() == hashes[i - 1];
+        }
+    }
+    success = success && !undoManager.hasUndoableAction();
+    
+    delete gameModel;
+    return success;
+}
+
+} // namespace
+
+int runUndoFuzzCommand(const CommandArgs& args)
+{
+    unsigned int seed = (unsigned int)args.getInt("seed", 1);
+    long long sequenceCount = args.getInt("sequences", 100000);
+    int maxMoves = (int)args.getInt("moves", 64);
+    
+    long long totalMoves = 0;
+    long long failureCount = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    
+    for (long long i = 0; i < sequenceCount; ++i) {
+        unsigned int sequenceSeed = seed + (unsigned int)i;
+        int movesPlayed = 0;
+        if (!verifySequence(sequenceSeed, maxMoves, movesPlayed)) {
+            if (failureCount < 10) {
+                std::printf("FAIL seed=%u moves=%d\n", sequenceSeed, movesPlayed);
+            }
+            ++failureCount;
+        }
+        totalMoves += movesPlayed;
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::printf("sequences=%lld moves=%lld failures=%lld time=%.3fs (%.0f sequences/s)\n",
+                sequenceCount, totalMoves, failureCount, seconds,
+                seconds > 0 ? sequenceCount / seconds : 0.0);
+    
+    return failureCount == 0 ? 0 : 1;
+}
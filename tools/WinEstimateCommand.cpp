@@ -0,0 +1,110 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "Commands.h"
+#include "services/GameModelFromLevelGenerator.h"
+#include "services/LevelGenerator.h"
+#include "services/WinProbabilityEstimator.h"
+#include <cstdio>
+
+int runWinEstimateCommand(const CommandArgs& args)
+{
+    LevelGenerateParams params;
+    std::string layoutName = args.getString("layout", LevelGenerator::getLayoutName(params.layout));
+    if (!LevelGenerator::parseLayoutName(layoutName, params.layout)) {
+        std::printf("Unknown layout: %s (expected peaks, pyramid or grid)\n", layoutName.c_str());
+        return 1;
+    }
+    params.mainCardCount = (int)args.getInt("main", params.mainCardCount);
+    params.reserveCardCount = (int)args.getInt("reserve", params.reserveCardCount);
+    params.deckCount = (int)args.getInt("decks", params.deckCount);
+    if (!LevelGenerator::isValidParams(params)) {
+        std::printf("Usage: winrate [--count N] [--seed S] [--hidden N] [--budget US] [--playouts N] [--threads T]\n"
+                    "               [--batch N] [--layout peaks|pyramid|grid] [--main N] [--reserve N] [--decks N]\n");
+        return 1;
+    }
+    int count = (int)args.getInt("count", 20);
+    uint64_t seed = (uint64_t)args.getInt("seed", 1);
+    int hiddenCount = (int)args.getInt("hidden", params.reserveCardCount);
+    
+    WinEstimateParams estimateParams;
+    estimateParams.timeBudgetMicros = (int)args.getInt("budget", estimateParams.timeBudgetMicros);
+    estimateParams.maxPlayouts = args.getInt("playouts", estimateParams.maxPlayouts);
+    estimateParams.threadCount = (int)args.getInt("threads", estimateParams.threadCount);
+    estimateParams.batchSize = (int)args.getInt("batch", estimateParams.batchSize);
+    estimateParams.deckCount = params.deckCount;
+    estimateParams.seed = seed;
+    
+    std::vector<LevelConfig*> levels;
+    LevelGenerator::generateLevels(params, seed, 0, count, estimateParams.threadCount, levels);
+    
+    // 生成的关卡在备用牌全部翻开时可解；完美玩家的胜率是任何策略的上限
+    const WinPlayoutPolicy policies[2] = { WPP_GREEDY, WPP_OPTIMAL };
+    const char* policyNames[2] = { "greedy", "optimal" };
+    double probabilitySum[2] = { 0, 0 };
+    double widthSum[2] = { 0, 0 };
+    long long playoutSum[2] = { 0, 0 };
+    double microsSum[2] = { 0, 0 };
+    int estimated = 0;
+    int failures = 0;
+    for (auto* level : levels) {
+        GameModel* gameModel = level ? GameModelFromLevelGenerator::generateGameModel(level) : nullptr;
+        delete level;
+        if (!gameModel) {
+            ++failures;
+            continue;
+        }
+        auto& reserveCards = gameModel->getReservePileCards();
+        for (int i = 0; i < hiddenCount && i < (int)reserveCards.size(); ++i) {
+            reserveCards[i]->setRevealed(false);
+        }
+        
+        bool ok = true;
+        for (int p = 0; p < 2; ++p) {
+            estimateParams.policy = policies[p];
+            WinEstimate estimate;
+            if (!WinProbabilityEstimator::estimate(gameModel, estimateParams, estimate)) {
+                ok = false;
+                break;
+            }
+            probabilitySum[p] += estimate.probability;
+            widthSum[p] += estimate.upper - estimate.lower;
+            playoutSum[p] += estimate.playouts;
+            microsSum[p] += estimate.elapsedMicros;
+        }
+        estimated += ok ? 1 : 0;
+        failures += ok ? 0 : 1;
+        delete gameModel;
+    }
+    
+    std::printf("Estimated %d/%d %s deals (main %d, reserve %d, hidden %d), %d failures\n", estimated, count,
+                layoutName.c_str(), params.mainCardCount, params.reserveCardCount, hiddenCount, failures);
+    for (int p = 0; p < 2 && estimated > 0; ++p) {
+        std::printf("  %-7s mean win %.3f, mean interval width %.3f, %.0f playouts/deal, %.0f playouts/s\n",
+                    policyNames[p], probabilitySum[p] / estimated, widthSum[p] / estimated,
+                    (double)playoutSum[p] / estimated, microsSum[p] > 0 ? playoutSum[p] * 1e6 / microsSum[p] : 0.0);
+    }
+    return failures == 0 ? 0 : 1;
+}
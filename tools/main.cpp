@@ -0,0 +1,85 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Commands.h"
+#include <cstdio>
+
+namespace {
+
+/**
+ * 子命令表
+ */
+struct CommandEntry
+{
+    const char* name;           ///< 子命令名
+    const char* description;    ///< 说明
+    CommandFunc func;           ///< 入口函数
+};
+
+const CommandEntry COMMANDS[] = {
+    { "fuzz-undo", "Play random move sequences and verify undo restores every state", runUndoFuzzCommand },
+#if !defined(POKERGAME_CORE_HEADLESS)
+    // 读写关卡文件的子命令依赖引擎中的加载器，无引擎构建不包含
+    { "fuzz-level", "Mutate level JSON and verify the loader accepts or rejects it cleanly", runLevelFuzzCommand },
+    { "pack",       "Compile levelN.json files into a binary level pack", runLevelPackCommand },
+    { "analyze",    "Validate levels and report solvability and difficulty", runLevelAnalyzeCommand },
+#endif
+    { "bench-undo", "Measure undo record and state snapshot throughput", runUndoBenchCommand },
+    { "generate",   "Generate solvable levels from seeded deals", runLevelGenerateCommand },
+    { "solve",      "Solve generated deals for the shortest winning line and time the solver", runGameSolveCommand },
+    { "winrate",    "Estimate win probability of deals with face-down reserve cards", runWinEstimateCommand },
+    { "bot",        "Play levels with bot policies and report win rate, moves and undo usage", runBotCommand },
+    { "daily",      "Generate solver-verified daily-challenge deals in a difficulty band, resumable", runDailyDealCommand },
+    { "perft",      "Count move-tree leaves to check the move generator and measure nodes/s", runPerftCommand },
+};
+
+void printUsage(const char* program)
+{
+    std::printf("Usage: %s <command> [options]\n\nCommands:\n", program);
+    for (const auto& entry : COMMANDS) {
+        std::printf("  %-14s %s\n", entry.name, entry.description);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    std::string name = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+    for (const auto& entry : COMMANDS) {
+        if (name == entry.name) {
+            return entry.func(CommandArgs(args));
+        }
+    }
+    
+    std::printf("Unknown command: %s\n\n", name.c_str());
+    printUsage(argv[0]);
+    return 1;
+}